@@ -0,0 +1,50 @@
+#include "benchmarks.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+	std::atomic<long long> allocations = 0;
+
+}
+
+/**
+ * Every allocation of the program goes through these, so that the benchmarks can report allocations per call
+ */
+void *operator new(const std::size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void *pointer = std::malloc(size == 0 ? 1 : size))
+		return pointer;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept {
+	std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+	std::free(pointer);
+}
+
+
+const std::vector<chessqdl::benchmarks::BenchmarkPosition> &chessqdl::benchmarks::benchmarkPositions() {
+	static const std::vector<BenchmarkPosition> positions = {
+			{"start",      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - - 0 1",                    nWhite},
+			{"opening",    "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w - - 4 4",         nWhite},
+			{"middlegame", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", nWhite},
+			{"tactical",   "r1b2rk1/2q1bppp/p2ppn2/1p6/3BPP2/2N2B2/PPPQ2PP/R4R1K b - - 0 15",          nBlack},
+			{"promotions", "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",                                  nBlack},
+			{"endgame",    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",                                nWhite}
+	};
+
+	return positions;
+}
+
+
+long long chessqdl::benchmarks::allocationCount() {
+	return allocations.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,39 @@
+#ifndef CHESSQDL_BENCHMARKS_HPP
+#define CHESSQDL_BENCHMARKS_HPP
+
+#include "Engine/const.hpp"
+
+#include <string>
+#include <vector>
+
+namespace chessqdl::benchmarks {
+
+	/**
+	 * @brief A position the hot paths are measured on
+	 */
+	struct BenchmarkPosition {
+		/**
+		 * @brief Label of the position in the benchmark output
+		 */
+		std::string name;
+
+		std::string fen;
+		enumColor toMove;
+	};
+
+
+	/**
+	 * @brief Fixed set of positions, from the opening to the endgame. Benchmarks take the index of the position as
+	 * their argument, so that each is timed on its own
+	 */
+	const std::vector<BenchmarkPosition> &benchmarkPositions();
+
+
+	/**
+	 * @brief Number of calls to operator new since the program started
+	 */
+	long long allocationCount();
+
+}
+
+#endif //CHESSQDL_BENCHMARKS_HPP
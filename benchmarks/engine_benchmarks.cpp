@@ -0,0 +1,59 @@
+#include "benchmark/benchmark.h"
+
+#include "benchmarks.hpp"
+
+#include "Engine/engine.hpp"
+#include "Engine/movegen.hpp"
+
+using namespace chessqdl;
+using namespace chessqdl::benchmarks;
+
+/**
+ * One iteration makes and takes back one legal move, going through all of them in turn
+ */
+void BM_MakeTakeMove(benchmark::State &state) {
+	const BenchmarkPosition &position = benchmarkPositions()[state.range(0)];
+	Engine engine(position.fen, position.toMove, 1, false, true, 0);
+	const std::vector<std::string> moves = MoveGenerator::getLegalMoves(engine.getBitboard().getBitBoards(),
+																		position.toMove);
+	size_t next = 0;
+
+	const long long allocationsBefore = allocationCount();
+
+	for (auto _: state) {
+		engine.makeMove(moves[next], false, false);
+		engine.takeMove();
+		next = next + 1 == moves.size() ? 0 : next + 1;
+	}
+
+	state.SetLabel(position.name);
+	state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocationCount() - allocationsBefore),
+												  benchmark::Counter::kAvgIterations);
+}
+
+/**
+ * Fixed depth search from empty tables, so that every iteration searches the same tree
+ */
+void BM_GetBestMove(benchmark::State &state) {
+	const BenchmarkPosition &position = benchmarkPositions()[state.range(0)];
+	Engine engine(position.fen, position.toMove, 4, false, true, 0);
+	engine.setShuffle(false);
+
+	const long long allocationsBefore = allocationCount();
+
+	for (auto _: state) {
+		state.PauseTiming();
+		engine.clearHash();
+		state.ResumeTiming();
+
+		benchmark::DoNotOptimize(engine.getBestMove(4, position.toMove));
+	}
+
+	state.SetLabel(position.name);
+	state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocationCount() - allocationsBefore),
+												  benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_MakeTakeMove)->DenseRange(0, static_cast<int>(benchmarkPositions().size()) - 1);
+BENCHMARK(BM_GetBestMove)->DenseRange(0, static_cast<int>(benchmarkPositions().size()) - 1)
+		->Unit(benchmark::kMillisecond);
@@ -0,0 +1,46 @@
+#include "benchmark/benchmark.h"
+
+#include "benchmarks.hpp"
+
+#include "Engine/bitboard.hpp"
+#include "Engine/evaluation.hpp"
+#include "Engine/pawns.hpp"
+
+using namespace chessqdl;
+using namespace chessqdl::benchmarks;
+
+void BM_EvaluateBoard(benchmark::State &state) {
+	const BenchmarkPosition &position = benchmarkPositions()[state.range(0)];
+	const BitboardArray board = Bitboard(position.fen).getBitBoards();
+
+	const long long allocationsBefore = allocationCount();
+
+	for (auto _: state)
+		benchmark::DoNotOptimize(evaluateBoard(board, position.toMove));
+
+	state.SetLabel(position.name);
+	state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocationCount() - allocationsBefore),
+												  benchmark::Counter::kAvgIterations);
+}
+
+/**
+ * As evaluated during the search: with an evaluation state kept up to date by makeMove and a warm pawn hash table
+ */
+void BM_EvaluateBoardIncremental(benchmark::State &state) {
+	const BenchmarkPosition &position = benchmarkPositions()[state.range(0)];
+	const BitboardArray board = Bitboard(position.fen).getBitBoards();
+	const EvalState evalState = computeEvalState(board);
+	PawnHashTable pawnTable;
+
+	const long long allocationsBefore = allocationCount();
+
+	for (auto _: state)
+		benchmark::DoNotOptimize(evaluateBoard(board, evalState, position.toMove, &pawnTable));
+
+	state.SetLabel(position.name);
+	state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocationCount() - allocationsBefore),
+												  benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_EvaluateBoard)->DenseRange(0, static_cast<int>(benchmarkPositions().size()) - 1);
+BENCHMARK(BM_EvaluateBoardIncremental)->DenseRange(0, static_cast<int>(benchmarkPositions().size()) - 1);
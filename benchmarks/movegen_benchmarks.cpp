@@ -0,0 +1,61 @@
+#include "benchmark/benchmark.h"
+
+#include "benchmarks.hpp"
+
+#include "Engine/bitboard.hpp"
+#include "Engine/engine.hpp"
+#include "Engine/movegen.hpp"
+
+using namespace chessqdl;
+using namespace chessqdl::benchmarks;
+
+namespace {
+
+	/**
+	 * @brief Times \p call on one position, along with the allocations it makes
+	 */
+	template<typename Call>
+	void measure(benchmark::State &state, Call call) {
+		const BenchmarkPosition &position = benchmarkPositions()[state.range(0)];
+		const BitboardArray board = Bitboard(position.fen).getBitBoards();
+
+		const long long allocationsBefore = allocationCount();
+
+		for (auto _: state)
+			benchmark::DoNotOptimize(call(board, position.toMove));
+
+		state.SetLabel(position.name);
+		state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocationCount() - allocationsBefore),
+													  benchmark::Counter::kAvgIterations);
+	}
+
+}
+
+void BM_PseudoLegalMoves(benchmark::State &state) {
+	measure(state, MoveGenerator::getPseudoLegalMoves);
+}
+
+void BM_LegalMoves(benchmark::State &state) {
+	measure(state, MoveGenerator::getLegalMoves);
+}
+
+/**
+ * Check detection as the search does it, on the board of an engine
+ */
+void BM_IsKingInCheck(benchmark::State &state) {
+	const BenchmarkPosition &position = benchmarkPositions()[state.range(0)];
+	const Engine engine(position.fen, position.toMove, 1, false, true, 0);
+
+	const long long allocationsBefore = allocationCount();
+
+	for (auto _: state)
+		benchmark::DoNotOptimize(engine.isKingInCheck(position.toMove));
+
+	state.SetLabel(position.name);
+	state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocationCount() - allocationsBefore),
+												  benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_PseudoLegalMoves)->DenseRange(0, static_cast<int>(benchmarkPositions().size()) - 1);
+BENCHMARK(BM_LegalMoves)->DenseRange(0, static_cast<int>(benchmarkPositions().size()) - 1);
+BENCHMARK(BM_IsKingInCheck)->DenseRange(0, static_cast<int>(benchmarkPositions().size()) - 1);
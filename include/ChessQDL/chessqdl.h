@@ -0,0 +1,209 @@
+#ifndef CHESSQDL_CHESSQDL_H
+#define CHESSQDL_CHESSQDL_H
+
+/**
+ * C interface of the engine, exported by the chessqdl shared library. <br>
+ *
+ * Moves are 16-bit packed moves: origin square in bits 0-5, destination square in bits 6-11 and promotion piece in bits
+ * 12-14 (0 none, 1 knight, 2 bishop, 3 rook, 4 queen). Squares are numbered rank * 8 + file, from a1 = 0 to h8 = 63.
+ * <br>
+ *
+ * A handle may be used by one thread at a time, except for cqdl_stop which may be called from any thread. Handles are
+ * independent of each other, so different threads may use different handles at the same time.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(CQDL_BUILD)
+#	define CQDL_API __declspec(dllexport)
+#elif defined(_WIN32)
+#	define CQDL_API __declspec(dllimport)
+#elif defined(__GNUC__)
+#	define CQDL_API __attribute__((visibility("default")))
+#else
+#	define CQDL_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Version of the interface, incremented whenever it changes in a way that breaks existing callers
+ */
+#define CQDL_API_VERSION 1
+
+/**
+ * @brief Outcome of a call
+ */
+typedef enum cqdl_status {
+	CQDL_OK = 0,
+	CQDL_INVALID_ARGUMENT,		// null handle or pointer, or a value out of range
+	CQDL_INVALID_POSITION,		// malformed FEN or inconsistent bitboards
+	CQDL_ILLEGAL_MOVE,			// move that is malformed or not legal in the current position
+	CQDL_BUFFER_TOO_SMALL,		// the caller's buffer cannot hold the whole result
+	CQDL_INTERNAL_ERROR			// the engine failed, e.g. it ran out of memory
+} cqdl_status;
+
+/**
+ * @brief Colors, as used by cqdl_position::side_to_move
+ */
+enum {
+	CQDL_WHITE = 0,
+	CQDL_BLACK = 1
+};
+
+/**
+ * @brief A position as bitboards, where bit n stands for square n
+ */
+typedef struct cqdl_position {
+	uint64_t colors[2];			// pieces of each color, indexed by CQDL_WHITE and CQDL_BLACK
+	uint64_t pieces[6];			// pawns, knights, bishops, rooks, queens and kings of both colors
+	int32_t side_to_move;		// CQDL_WHITE or CQDL_BLACK
+} cqdl_position;
+
+/**
+ * @brief Limits of a search. A zero means that the corresponding limit is not set, and at least one must be
+ */
+typedef struct cqdl_limits {
+	int32_t depth;				// maximum depth of the iterative deepening
+	int64_t nodes;				// maximum number of nodes
+	int64_t move_time;			// exact time to spend, in milliseconds
+	int64_t time[2];			// time left on the clock of each color, in milliseconds
+	int64_t increment[2];		// increment per move of each color, in milliseconds
+	int32_t moves_to_go;		// moves left until the next time control
+	int32_t multipv;			// number of best lines searched, 0 stands for 1
+} cqdl_limits;
+
+/**
+ * @brief Progress of a search, reported once per line after every completed iteration
+ */
+typedef struct cqdl_info {
+	int32_t depth;
+	int32_t score;				// centipawns for the side to move
+	int64_t nodes;
+	int64_t time;				// milliseconds since the search started
+	int32_t hashfull;			// permill of the transposition table in use
+	int32_t line;				// rank of the line, from 1 (best) to cqdl_limits::multipv
+	const uint16_t *pv;			// principal variation of the line, valid until the callback returns
+	size_t pv_length;
+} cqdl_info;
+
+/**
+ * @brief Called with the progress of a search, on the thread that called cqdl_search
+ */
+typedef void (*cqdl_info_callback)(const cqdl_info *info, void *user_data);
+
+/**
+ * @brief Opaque engine handle
+ */
+typedef struct cqdl_engine cqdl_engine;
+
+
+/**
+ * @brief Returns the version of the interface implemented by the library, to be compared with CQDL_API_VERSION
+ */
+CQDL_API int cqdl_api_version(void);
+
+/**
+ * @brief Creates an engine set to the initial position, with a 16 MB transposition table
+ * @return The handle, or NULL if the engine could not be created
+ */
+CQDL_API cqdl_engine *cqdl_create(void);
+
+/**
+ * @brief Destroys an engine. NULL is ignored
+ */
+CQDL_API void cqdl_destroy(cqdl_engine *engine);
+
+/**
+ * @brief Resizes the transposition table, which clears it
+ * @param megabytes  new size, at least 1
+ */
+CQDL_API cqdl_status cqdl_set_hash_size(cqdl_engine *engine, size_t megabytes);
+
+/**
+ * @brief Clears the tables filled by previous searches, e.g. before an unrelated position
+ */
+CQDL_API cqdl_status cqdl_clear_hash(cqdl_engine *engine);
+
+/**
+ * @brief Sets the position from a FEN string. The move history is cleared
+ */
+CQDL_API cqdl_status cqdl_set_fen(cqdl_engine *engine, const char *fen);
+
+/**
+ * @brief Sets the position from bitboards. The move history is cleared
+ * @return CQDL_INVALID_POSITION if the bitboards overlap, a color does not have exactly one king, a pawn is on the
+ * first or last rank, or the side that is not to move is in check
+ */
+CQDL_API cqdl_status cqdl_set_position(cqdl_engine *engine, const cqdl_position *position);
+
+/**
+ * @brief Writes the current position as bitboards
+ */
+CQDL_API cqdl_status cqdl_get_position(const cqdl_engine *engine, cqdl_position *position);
+
+/**
+ * @brief Plays a legal move
+ * @return CQDL_INVALID_ARGUMENT if the promotion bits of \p move are above 4
+ */
+CQDL_API cqdl_status cqdl_make_move(cqdl_engine *engine, uint16_t move);
+
+/**
+ * @brief Takes back the most recent move
+ * @return CQDL_ILLEGAL_MOVE if no move was played since the position was set
+ */
+CQDL_API cqdl_status cqdl_take_move(cqdl_engine *engine);
+
+/**
+ * @brief Reads a legal move of the current position written in coordinate (e2e4), long algebraic (Ng1-f3) or standard
+ * algebraic (Nf3) notation
+ */
+CQDL_API cqdl_status cqdl_parse_move(const cqdl_engine *engine, const char *text, uint16_t *move);
+
+/**
+ * @brief Writes a move in coordinate notation (e.g. e2e4, e7e8q), terminated by a null character
+ * @param buffer  buffer the move is written to
+ * @param size  size of \p buffer, at least 6 characters
+ * @return CQDL_INVALID_ARGUMENT if the promotion bits of \p move are above 4
+ */
+CQDL_API cqdl_status cqdl_move_to_string(uint16_t move, char *buffer, size_t size);
+
+/**
+ * @brief Writes the legal moves of the current position
+ * @param moves  buffer of \p capacity moves. May be NULL when \p capacity is 0, to ask for the number of moves
+ * @param count  set to the number of legal moves, even when they do not fit
+ * @return CQDL_BUFFER_TOO_SMALL if there are more than \p capacity legal moves, in which case the first ones are
+ * written
+ */
+CQDL_API cqdl_status cqdl_legal_moves(const cqdl_engine *engine, uint16_t *moves, size_t capacity, size_t *count);
+
+/**
+ * @brief Counts the leaves of the legal move tree of the current position
+ * @param depth  depth of the tree, at least 1
+ * @param threads  number of threads to use. 0 uses one thread per hardware thread
+ * @param nodes  set to the number of leaves
+ */
+CQDL_API cqdl_status cqdl_perft(const cqdl_engine *engine, int depth, unsigned threads, uint64_t *nodes);
+
+/**
+ * @brief Searches the current position, blocking until a limit is reached or cqdl_stop is called
+ * @param callback  called after every completed iteration, or NULL
+ * @param user_data  passed as it is to \p callback
+ * @param best_move  set to the best move, or to 0 if the side to move is mated or stalemated
+ */
+CQDL_API cqdl_status cqdl_search(cqdl_engine *engine, const cqdl_limits *limits, cqdl_info_callback callback,
+								 void *user_data, uint16_t *best_move);
+
+/**
+ * @brief Interrupts the search running on an engine, from any thread. cqdl_search still returns the best move found
+ */
+CQDL_API cqdl_status cqdl_stop(cqdl_engine *engine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CHESSQDL_CHESSQDL_H
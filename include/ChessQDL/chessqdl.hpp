@@ -3,6 +3,10 @@
 
 #include "argparser.hpp"
 
+#include "Engine/analysis.hpp"
+#include "Engine/bench.hpp"
+#include "Engine/bitbase.hpp"
 #include "Engine/engine.hpp"
+#include "Engine/server.hpp"
 
 #endif //CHESSQDL_CHESSQDL_HPP
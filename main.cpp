@@ -1,5 +1,7 @@
 #include "ChessQDL/chessqdl.hpp"
 
+#include <fstream>
+
 using namespace chessqdl;
 
 int main(const int argc, char **argv) {
@@ -9,19 +11,115 @@ int main(const int argc, char **argv) {
 	enumColor enginePieces;
 	bool verbose;
 	bool pvp;
+	bool ponder;
+	bool uci;
+	size_t hashSize;
+	size_t pawnHashSize;
+	size_t evalCacheSize;
 	std::string fen;
+	std::string weights;
+	std::string evalFile;
+	std::string batchFile;
+	AnalysisOptions analysis;
+	std::string serveAddress;
+	bool bench;
+	BenchOptions benchOptions;
 	std::optional<int> seed;
 
 	// Parse arguments and initialize variables
-	argumentParser(argc, argv, level, enginePieces, verbose, fen, pvp, seed);
+	argumentParser(argc, argv, level, enginePieces, verbose, fen, pvp, seed, ponder, hashSize, pawnHashSize, evalCacheSize, weights, evalFile, uci, batchFile, analysis, serveAddress, bench, benchOptions);
 
 	// Construct engine
 	Engine engine = fen.empty()
 		                ? Engine(enginePieces, level, verbose, pvp, seed)
 		                : Engine(fen, enginePieces, level, verbose, pvp, seed);
 
+	engine.setPonder(ponder);
+	engine.setHashSize(hashSize);
+	engine.setPawnHashSize(pawnHashSize);
+	engine.setEvalCacheSize(evalCacheSize);
+
+	if (!weights.empty() && !engine.loadWeights(weights)) {
+		std::cout << "ChessQDL: Could not read weights file " << weights << std::endl;
+		return 1;
+	}
+
+	if (!evalFile.empty() && !engine.loadNetwork(evalFile)) {
+		std::cout << "ChessQDL: Could not read network file " << evalFile << std::endl;
+		return 1;
+	}
+
+	// Generate the endgame bitbases before the first search
+	initBitbases();
+
+	if (bench) {
+		benchOptions.network = engine.getNetwork();
+		benchOptions.pieceSquareTables = engine.getPieceSquareTables();
+		printBench(std::cout, runBench(benchOptions));
+		return 0;
+	}
+
+	if (!batchFile.empty()) {
+		analysis.hashSize = hashSize;
+		analysis.pawnHashSize = pawnHashSize;
+		analysis.evalCacheSize = evalCacheSize;
+		analysis.network = engine.getNetwork();
+		analysis.pieceSquareTables = engine.getPieceSquareTables();
+
+		if (batchFile == "-") {
+			analyzePositions(std::cin, std::cout, analysis);
+			return 0;
+		}
+
+		std::ifstream file(batchFile);
+
+		if (!file) {
+			std::cout << "ChessQDL: Could not read " << batchFile << std::endl;
+			return 1;
+		}
+
+		analyzePositions(file, std::cout, analysis);
+		return 0;
+	}
+
+	if (!serveAddress.empty()) {
+		ServerOptions server;
+		server.engines = analysis.threads;
+		server.limits = analysis.limits;
+		server.hashSize = hashSize;
+		server.pawnHashSize = pawnHashSize;
+		server.evalCacheSize = evalCacheSize;
+		server.network = engine.getNetwork();
+		server.pieceSquareTables = engine.getPieceSquareTables();
+
+		if (serveAddress.rfind("unix:", 0) == 0)
+			server.socketPath = serveAddress.substr(5);
+		else if (serveAddress.find_first_not_of("0123456789") == std::string::npos && serveAddress.size() <= 5 &&
+		         std::stoi(serveAddress) <= 65535)
+			server.port = std::stoi(serveAddress);
+		else {
+			std::cout << "ChessQDL: Invalid address " << serveAddress << ", expected unix:PATH or a port" << std::endl;
+			return 1;
+		}
+
+		AnalysisServer analysisServer(server);
+
+		if (!analysisServer.start()) {
+			std::cout << "ChessQDL: Could not listen on " << serveAddress << std::endl;
+			return 1;
+		}
+
+		std::cout << "Listening on " << (server.socketPath.empty() ? "127.0.0.1:" + std::to_string(analysisServer.getPort())
+		                                                           : server.socketPath) << std::endl;
+		analysisServer.wait();
+		return 0;
+	}
+
 	// Call engine's parser to start interaction
-	engine.parser();
+	if (uci)
+		engine.uci();
+	else
+		engine.parser();
 
 	return 0;
 }
\ No newline at end of file
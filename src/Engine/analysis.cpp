@@ -0,0 +1,324 @@
+#include "analysis.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace chessqdl;
+
+namespace {
+
+    /**
+     * @brief Checks the piece placement field of a FEN: eight ranks of eight squares and one king of each color
+     */
+    bool isValidPlacement(const std::string &placement) {
+        int ranks = 1;
+        int files = 0;
+        int whiteKings = 0;
+        int blackKings = 0;
+
+        for (const char c: placement) {
+            if (c == '/') {
+                if (files != 8)
+                    return false;
+                ranks++;
+                files = 0;
+            } else if (c >= '1' && c <= '8')
+                files += c - '0';
+            else if (std::string("pnbrqkPNBRQK").find(c) != std::string::npos) {
+                files++;
+                whiteKings += c == 'K';
+                blackKings += c == 'k';
+            } else
+                return false;
+
+            if (files > 8)
+                return false;
+        }
+
+        return ranks == 8 && files == 8 && whiteKings == 1 && blackKings == 1;
+    }
+
+    bool isNumber(const std::string &token) {
+        return !token.empty() &&
+               std::all_of(token.begin(), token.end(), [](const unsigned char c) { return std::isdigit(c); });
+    }
+
+    std::string escapeCsv(const std::string &field) {
+        if (field.find_first_of(",\"\n") == std::string::npos)
+            return field;
+
+        std::string escaped = "\"";
+        for (const char c: field)
+            escaped += c == '"' ? "\"\"" : std::string(1, c);
+
+        return escaped + "\"";
+    }
+
+    /**
+     * @brief Analyzes the position on one line and formats the result
+     */
+    std::string analyzeLine(Engine &engine, const std::string &line, const long long number,
+                            const AnalysisOptions &options) {
+        std::string fen;
+        std::string id;
+        const bool valid = parsePosition(line, fen, id);
+
+        if (id.empty())
+            id = std::to_string(number);
+
+        std::ostringstream result;
+
+        if (!valid) {
+            if (options.format == nJsonl)
+                result << R"({"id":")" << escapeJson(id) << R"(","error":"invalid position"})";
+            else
+                result << escapeCsv(id) << ",,,,,";
+
+            return result.str();
+        }
+
+        const auto begin = std::chrono::steady_clock::now();
+        SearchInfo last{0, 0, 0, 0, 0, {}, {}};
+
+        // Results must not depend on the positions the worker searched before
+        engine.clearHash();
+        engine.setPosition(fen);
+        std::string bestMove = engine.search(options.limits, [&last](const SearchInfo &info) { last = info; });
+
+        const long long time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - begin).count();
+
+        // Checkmate or stalemate
+        if (bestMove.empty())
+            bestMove = "0000";
+
+        if (options.format == nJsonl)
+            result << R"({"id":")" << escapeJson(id) << R"(","bestmove":")" << bestMove << R"(","score":)"
+                   << last.score << R"(,"depth":)" << last.depth << R"(,"nodes":)" << last.nodes << R"(,"time":)"
+                   << time << "}";
+        else
+            result << escapeCsv(id) << "," << bestMove << "," << last.score << "," << last.depth << "," << last.nodes
+                   << "," << time;
+
+        return result.str();
+    }
+
+}
+
+
+/**
+ * @details Control characters are replaced by spaces.
+ */
+std::string chessqdl::escapeJson(const std::string &field) {
+    std::string escaped;
+
+    for (const char c: field) {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+
+        if (static_cast<unsigned char>(c) < 0x20)
+            escaped += ' ';
+        else
+            escaped += c;
+    }
+
+    return escaped;
+}
+
+
+/**
+ * @details The first four fields are common to FEN and EPD. They are followed either by the two move counters (FEN) or
+ * by operations separated by semicolons (EPD), such as: bm Nf3; id "position 1";
+ */
+bool chessqdl::parseEpd(const std::string &line, std::string &fen, std::map<std::string, std::string> &operations) {
+    std::istringstream stream(line);
+    std::string placement, side, castling, enPassant;
+
+    operations.clear();
+
+    if (!(stream >> placement >> side >> castling >> enPassant) || (side != "w" && side != "b") ||
+        !isValidPlacement(placement))
+        return false;
+
+    std::string rest;
+    std::getline(stream, rest);
+
+    std::istringstream counters(rest);
+    std::string halfMoves, fullMoves;
+    counters >> halfMoves >> fullMoves;
+
+    if (isNumber(halfMoves) && isNumber(fullMoves)) {
+        std::getline(counters, rest);
+    } else {
+        halfMoves = "0";
+        fullMoves = "1";
+    }
+
+    fen = placement + " " + side + " " + castling + " " + enPassant + " " + halfMoves + " " + fullMoves;
+
+    std::istringstream stringOperations(rest);
+    std::string operation;
+
+    while (std::getline(stringOperations, operation, ';')) {
+        std::istringstream words(operation);
+        std::string opcode;
+        std::string operand;
+
+        if (!(words >> opcode))
+            continue;
+
+        std::getline(words >> std::ws, operand);
+
+        while (!operand.empty() && std::isspace(static_cast<unsigned char>(operand.back())))
+            operand.pop_back();
+
+        if (operand.size() >= 2 && operand.front() == '"' && operand.back() == '"')
+            operand = operand.substr(1, operand.size() - 2);
+
+        operations[opcode] = operand;
+    }
+
+    return true;
+}
+
+
+bool chessqdl::parsePosition(const std::string &line, std::string &fen, std::string &id) {
+    std::map<std::string, std::string> operations;
+    const bool valid = parseEpd(line, fen, operations);
+
+    id = operations["id"];
+
+    return valid;
+}
+
+
+/**
+ * @details Lines are read by one thread into a ring of slots, analyzed by the worker threads in the order they were
+ * read, and written by the calling thread as soon as all the results before them are written. The reader never gets
+ * further than the size of the ring ahead of the writer, so memory does not depend on the size of the input, and a slow
+ * position only holds back the output, not the other workers.
+ */
+long long chessqdl::analyzePositions(std::istream &input, std::ostream &output, const AnalysisOptions &options) {
+    const unsigned threads = resolveThreads(options.threads);
+
+    struct Slot {
+        std::string line;
+        long long lineNumber = 0;
+        std::string result;
+        bool done = false;
+    };
+
+    std::vector<Slot> ring(static_cast<size_t>(threads) * 16);
+    long long read = 0;
+    long long taken = 0;
+    long long written = 0;
+    bool endOfInput = false;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+
+    if (options.format == nCsv)
+        output << "id,bestmove,score,depth,nodes,time" << std::endl;
+
+    std::thread reader([&] {
+        std::string line;
+        long long lineNumber = 0;
+
+        while (std::getline(input, line)) {
+            lineNumber++;
+
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+
+            if (const size_t first = line.find_first_not_of(" \t"); first == std::string::npos || line[first] == '#')
+                continue;
+
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&] { return read - written < static_cast<long long>(ring.size()); });
+
+            ring[read % ring.size()] = {std::move(line), lineNumber, "", false};
+            read++;
+            changed.notify_all();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        endOfInput = true;
+        changed.notify_all();
+    });
+
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&] {
+            Engine engine(nWhite, 1, false, false, 0);
+            engine.setHashSize(options.hashSize);
+            engine.setPawnHashSize(options.pawnHashSize);
+            engine.setEvalCacheSize(options.evalCacheSize);
+            engine.setNetwork(options.network);
+            engine.setPieceSquareTables(options.pieceSquareTables);
+            engine.setShuffle(false);
+
+            while (true) {
+                long long index;
+                long long lineNumber;
+                std::string line;
+
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&] { return taken < read || endOfInput; });
+
+                    if (taken == read)
+                        return;
+
+                    index = taken++;
+                    line = ring[index % ring.size()].line;
+                    lineNumber = ring[index % ring.size()].lineNumber;
+                }
+
+                std::string result = analyzeLine(engine, line, lineNumber, options);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                ring[index % ring.size()].result = std::move(result);
+                ring[index % ring.size()].done = true;
+                changed.notify_all();
+            }
+        });
+    }
+
+    while (true) {
+        std::string result;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&] {
+                return (written < read && ring[written % ring.size()].done) || (endOfInput && written == read);
+            });
+
+            if (written == read)
+                break;
+
+            Slot &slot = ring[written % ring.size()];
+            result = std::move(slot.result);
+            slot.done = false;
+            written++;
+            changed.notify_all();
+        }
+
+        output << result << '\n';
+    }
+
+    output.flush();
+    reader.join();
+
+    for (auto &worker: workers)
+        worker.join();
+
+    return read;
+}
@@ -0,0 +1,104 @@
+#ifndef CHESSQDL_ANALYSIS_HPP
+#define CHESSQDL_ANALYSIS_HPP
+
+#include "engine.hpp"
+
+#include <istream>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+
+namespace chessqdl {
+
+    enum enumOutputFormat {
+        nCsv,
+        nJsonl
+    };
+
+
+    /**
+     * @brief Settings of a batch analysis
+     */
+    struct AnalysisOptions {
+        /**
+         * @brief Limits of the search of every position
+         */
+        SearchLimits limits;
+
+        /**
+         * @brief Number of positions analyzed at the same time, each one by an engine of its own. 0 uses one per
+         * hardware thread
+         */
+        unsigned threads = 0;
+
+        enumOutputFormat format = nCsv;
+
+        /**
+         * @brief Sizes of the tables of each engine, in megabytes
+         */
+        size_t hashSize = 16;
+        size_t pawnHashSize = 2;
+        size_t evalCacheSize = 1;
+
+        /**
+         * @brief Network shared by all engines, or null for the handcrafted evaluation
+         */
+        std::shared_ptr<const NnueNetwork> network;
+
+        /**
+         * @brief Piece-square tables shared by all engines, or null for the default tables
+         */
+        std::shared_ptr<const PieceSquareTables> pieceSquareTables;
+    };
+
+
+    /**
+     * @brief Escapes a string so that it can be written between the quotes of a JSON string
+     * @param field  string of interest
+     * @return The escaped string, without the surrounding quotes
+     */
+    std::string escapeJson(const std::string &field);
+
+
+    /**
+     * @brief Reads a position written in FEN or in EPD, along with its EPD operations. The move counters of a FEN are
+     * optional
+     * @param line  line of interest
+     * @param fen  filled with the position, as a FEN accepted by Engine::setPosition
+     * @param operations  filled with the operand of each EPD operation (e.g. "bm" -> "Nf3 Ng5", "id" -> "test 1"),
+     * without the surrounding quotes of strings
+     * @return True if the line holds a valid position (piece placement with one king of each color, and side to move)
+     */
+    bool parseEpd(const std::string &line, std::string &fen, std::map<std::string, std::string> &operations);
+
+
+    /**
+     * @brief Reads a position written in FEN or in EPD. The move counters of a FEN are optional, and EPD operations
+     * other than "id" are ignored
+     * @param line  line of interest
+     * @param fen  filled with the position, as a FEN accepted by Engine::setPosition
+     * @param id  filled with the value of the "id" operation, or left empty
+     * @return True if the line holds a valid position (piece placement with one king of each color, and side to move)
+     */
+    bool parsePosition(const std::string &line, std::string &fen, std::string &id);
+
+
+    /**
+     * @brief Analyzes every position of a stream of FEN or EPD lines and writes one result per position, in input
+     * order. <br>
+     *
+     * Blank lines and lines starting with '#' are skipped. Results hold the id of the position (its "id" operation, or
+     * the number of its line in the input when there is none), the best move, the score for the side to move, the depth reached,
+     * the number of nodes and the time taken in milliseconds. Invalid positions produce a result with empty fields in
+     * CSV and an "error" field in JSONL
+     * @param input  positions to analyze, one per line
+     * @param output  stream to write the results to
+     * @param options  settings of the analysis
+     * @return Number of positions read
+     */
+    long long analyzePositions(std::istream &input, std::ostream &output, const AnalysisOptions &options);
+
+}
+
+#endif //CHESSQDL_ANALYSIS_HPP
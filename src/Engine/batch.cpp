@@ -0,0 +1,248 @@
+#include "batch.hpp"
+#include "evaluation.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+
+using namespace chessqdl;
+
+namespace {
+
+    constexpr uint64_t notA = 0xfefefefefefefefeULL;
+    constexpr uint64_t notH = 0x7f7f7f7f7f7f7f7fULL;
+    constexpr uint64_t notAB = 0xfcfcfcfcfcfcfcfcULL;
+    constexpr uint64_t notGH = 0x3f3f3f3f3f3f3f3fULL;
+
+    /**
+     * @brief Number of positions processed together by the mobility kernel
+     */
+    constexpr size_t lanes = 8;
+
+    /*
+     * The kernels below work on plain 64 bit integers rather than std::bitset, so that loops over positions can be
+     * vectorized. They compute the same attack sets as the corresponding MoveGenerator methods.
+     */
+
+    /**
+     * @brief Branchless population count
+     */
+    inline int popcount(uint64_t x) {
+        x = x - ((x >> 1) & 0x5555555555555555ULL);
+        x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+        x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+    }
+
+    template<int shift>
+    inline uint64_t shiftBy(const uint64_t b) {
+        if constexpr (shift > 0)
+            return b << shift;
+        else
+            return b >> -shift;
+    }
+
+    /**
+     * @brief Kogge-Stone occluded fill in one direction, shifted one further so that the first blocker is attacked
+     */
+    template<int shift>
+    inline uint64_t rayAttacks(uint64_t sliders, uint64_t empty, const uint64_t wrapMask) {
+        empty &= wrapMask;
+        sliders |= empty & shiftBy<shift>(sliders);
+        empty &= shiftBy<shift>(empty);
+        sliders |= empty & shiftBy<2 * shift>(sliders);
+        empty &= shiftBy<2 * shift>(empty);
+        sliders |= empty & shiftBy<4 * shift>(sliders);
+        return shiftBy<shift>(sliders) & wrapMask;
+    }
+
+    inline uint64_t bishopAttacks(const uint64_t sliders, const uint64_t empty) {
+        return rayAttacks<9>(sliders, empty, notA) | rayAttacks<-7>(sliders, empty, notA) |
+               rayAttacks<7>(sliders, empty, notH) | rayAttacks<-9>(sliders, empty, notH);
+    }
+
+    inline uint64_t rookAttacks(const uint64_t sliders, const uint64_t empty) {
+        return rayAttacks<8>(sliders, empty, ~0ULL) | rayAttacks<-8>(sliders, empty, ~0ULL) |
+               rayAttacks<1>(sliders, empty, notA) | rayAttacks<-1>(sliders, empty, notH);
+    }
+
+    inline uint64_t knightAttacks(const uint64_t knights) {
+        const uint64_t one = ((knights << 1) & notA) | ((knights >> 1) & notH);
+        const uint64_t two = ((knights << 2) & notAB) | ((knights >> 2) & notGH);
+        return (one << 16) | (one >> 16) | (two << 8) | (two >> 8);
+    }
+
+    inline uint64_t pawnAttacks(const uint64_t pawns, const enumColor color) {
+        return color == nWhite
+                   ? ((pawns << 9) & notA) | ((pawns << 7) & notH)
+                   : ((pawns >> 7) & notA) | ((pawns >> 9) & notH);
+    }
+
+    /**
+     * @brief Adds the material and piece-square terms of \p color to the accumulators of positions [begin, end)
+     */
+    void addPlacementTerms(const PositionBatch &batch, const size_t begin, const size_t end, const enumColor color,
+                           const int sign, int *material, int *mg, int *eg, int *phase) {
+        const PieceSquareTables &tables = getDefaultPieceSquareTables();
+        const std::vector<uint64_t> &colorBoards = batch.boards[color];
+        const size_t count = end - begin;
+        std::vector<uint64_t> pieces(count);
+
+        for (int piece = nPawn; piece <= nKing; piece++) {
+            const std::vector<uint64_t> &pieceBoards = batch.boards[piece];
+
+            for (size_t i = 0; i < count; i++) {
+                pieces[i] = pieceBoards[begin + i] & colorBoards[begin + i];
+                const int n = popcount(pieces[i]);
+                material[i] += sign * pieceValues[piece] * n;
+                phase[i] += phaseWeights[piece] * n;
+            }
+
+            // Table lookups as masked sums over the squares, which is branchless and vectorizes across positions
+            for (int square = 0; square < 64; square++) {
+                const int mgValue = sign * tables.mg[piece][relativeSquare(color, square)];
+                const int egValue = sign * tables.eg[piece][relativeSquare(color, square)];
+
+                if (mgValue == 0 && egValue == 0)
+                    continue;
+
+                for (size_t i = 0; i < count; i++) {
+                    const int occupied = static_cast<int>((pieces[i] >> square) & 1);
+                    mg[i] += occupied * mgValue;
+                    eg[i] += occupied * egValue;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Adds the mobility term of \p color to the accumulators of positions [begin, end). Positions are processed
+     * in groups of lanes: every iteration takes the next piece of each position, so the attack computations of a group
+     * are independent and can run side by side
+     */
+    void addMobilityTerm(const PositionBatch &batch, const size_t begin, const size_t end, const enumColor color,
+                         const int sign, int *mobility) {
+        const enumColor enemyColor = color == nWhite ? nBlack : nWhite;
+
+        for (size_t group = begin; group < end; group += lanes) {
+            const size_t width = std::min(lanes, end - group);
+            uint64_t empty[lanes] = {};
+            uint64_t safe[lanes] = {};
+
+            for (size_t l = 0; l < width; l++) {
+                const size_t i = group + l;
+                empty[l] = ~batch.boards[nColor][i];
+                safe[l] = ~batch.boards[color][i] &
+                          ~pawnAttacks(batch.boards[nPawn][i] & batch.boards[enemyColor][i], enemyColor);
+            }
+
+            for (int piece = nKnight; piece <= nQueen; piece++) {
+                uint64_t pieces[lanes] = {};
+                uint64_t remaining = 0;
+
+                for (size_t l = 0; l < width; l++) {
+                    pieces[l] = batch.boards[piece][group + l] & batch.boards[color][group + l];
+                    remaining |= pieces[l];
+                }
+
+                while (remaining) {
+                    remaining = 0;
+
+                    for (size_t l = 0; l < lanes; l++) {
+                        const uint64_t square = pieces[l] & -pieces[l];
+                        pieces[l] &= pieces[l] - 1;
+                        remaining |= pieces[l];
+
+                        uint64_t attacks = 0;
+                        if (piece == nKnight)
+                            attacks = knightAttacks(square);
+                        if (piece == nBishop || piece == nQueen)
+                            attacks |= bishopAttacks(square, empty[l]);
+                        if (piece == nRook || piece == nQueen)
+                            attacks |= rookAttacks(square, empty[l]);
+
+                        mobility[l] += sign * mobilityWeights[piece] * popcount(attacks & safe[l]);
+                    }
+                }
+            }
+
+            mobility += lanes;
+        }
+    }
+
+    /**
+     * @brief Evaluates positions [begin, end) of the batch
+     */
+    void evaluateRange(const PositionBatch &batch, const size_t begin, const size_t end, const enumColor color,
+                       int *scores) {
+        const enumColor enemyColor = color == nWhite ? nBlack : nWhite;
+        const size_t count = end - begin;
+
+        std::vector<int> material(count), mg(count), eg(count), phase(count);
+        // Padded so that the mobility kernel can always write whole groups
+        std::vector<int> mobility(count + lanes);
+
+        addPlacementTerms(batch, begin, end, color, 1, material.data(), mg.data(), eg.data(), phase.data());
+        addPlacementTerms(batch, begin, end, enemyColor, -1, material.data(), mg.data(), eg.data(), phase.data());
+        addMobilityTerm(batch, begin, end, color, 1, mobility.data());
+        addMobilityTerm(batch, begin, end, enemyColor, -1, mobility.data());
+
+        for (size_t i = 0; i < count; i++) {
+            // Same order of operations as evaluateBoard, so that the results match exactly
+            const BitboardArray board = batch.get(begin + i);
+            const uint64_t materialKey = computeMaterialKey(board);
+
+            if (evaluateEndgame(board, materialKey, color, scores[i]))
+                continue;
+
+            const PawnEntry pawns = evaluatePawns(board);
+            const int pawnScore = taper(pawns.mgScore, pawns.egScore, phase[i]);
+            const int score = material[i] + taper(mg[i], eg[i], phase[i]) + mobility[i] +
+                              (color == nWhite ? pawnScore : -pawnScore);
+
+            scores[i] = score * endgameScaleFactor(board, materialKey, score >= 0 ? color : enemyColor) /
+                        normalScaleFactor;
+        }
+    }
+
+}
+
+
+void PositionBatch::add(const BitboardArray &board) {
+    for (size_t i = 0; i < boards.size(); i++)
+        boards[i].push_back(board[i].to_ullong());
+}
+
+
+BitboardArray PositionBatch::get(const size_t index) const {
+    BitboardArray board;
+
+    for (size_t i = 0; i < boards.size(); i++)
+        board[i] = boards[i][index];
+
+    return board;
+}
+
+
+size_t PositionBatch::size() const {
+    return boards[0].size();
+}
+
+
+/**
+ * @details The batch is split into one contiguous range per thread. Each thread evaluates its range term by term, so
+ * that every kernel streams through the arrays of the batch. The pawn structure is still evaluated one position at a
+ * time.
+ */
+std::vector<int> chessqdl::evaluateBatch(const PositionBatch &batch, const enumColor color, unsigned threads) {
+    const size_t size = batch.size();
+    std::vector<int> scores(size);
+
+    // Small ranges are not worth a thread
+    threads = static_cast<unsigned>(std::min<size_t>(resolveThreads(threads), std::max<size_t>(1, size / 256)));
+
+    parallelFor(size, threads, [&](const size_t begin, const size_t end, unsigned) {
+        evaluateRange(batch, begin, end, color, scores.data() + begin);
+    });
+
+    return scores;
+}
@@ -0,0 +1,59 @@
+#ifndef CHESSQDL_BATCH_HPP
+#define CHESSQDL_BATCH_HPP
+
+#include "const.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace chessqdl {
+
+    /**
+     * @brief Set of positions stored in structure-of-arrays layout: each bitboard of BitboardArray is kept in its own
+     * array, with one element per position. Kernels that process a single term for many positions then read contiguous
+     * memory
+     */
+    struct PositionBatch {
+        /**
+         * @brief Bitboards of every position, indexed first like BitboardArray and then by position
+         */
+        std::array<std::vector<uint64_t>, 9> boards;
+
+
+        /**
+         * @brief Appends a position to the batch
+         * @param board  position to append
+         */
+        void add(const BitboardArray &board);
+
+
+        /**
+         * @brief Rebuilds a position of the batch
+         * @param index  index of the position
+         * @return Bitboards of the position
+         */
+        [[nodiscard]] BitboardArray get(size_t index) const;
+
+
+        /**
+         * @brief Get method that returns the number of positions in the batch
+         * @return number of positions
+         */
+        [[nodiscard]] size_t size() const;
+    };
+
+
+    /**
+     * @brief Evaluates every position of a batch. Material, piece-square and mobility terms are computed by kernels
+     * that work on many positions at once, and the batch is split across threads
+     * @param batch  positions to evaluate
+     * @param color  perspective of the evaluation
+     * @param threads  number of threads to use. 0 uses one thread per hardware thread
+     * @return Score of each position, identical to evaluateBoard(batch.get(i), color)
+     */
+    std::vector<int> evaluateBatch(const PositionBatch &batch, enumColor color, unsigned threads = 0);
+
+}
+
+#endif //CHESSQDL_BATCH_HPP
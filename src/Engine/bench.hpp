@@ -0,0 +1,96 @@
+#ifndef CHESSQDL_BENCH_HPP
+#define CHESSQDL_BENCH_HPP
+
+#include "engine.hpp"
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace chessqdl {
+
+    /**
+     * @brief Settings of a bench run
+     */
+    struct BenchOptions {
+        /**
+         * @brief Depth every position is searched to
+         */
+        int depth = 5;
+
+        /**
+         * @brief Size of the transposition table of each engine, in megabytes
+         */
+        size_t hashSize = 16;
+
+        /**
+         * @brief Number of positions searched at the same time. 0 uses one per hardware thread
+         */
+        unsigned threads = 1;
+
+        /**
+         * @brief Network used by the engines, or null for the handcrafted evaluation
+         */
+        std::shared_ptr<const NnueNetwork> network;
+
+        /**
+         * @brief Piece-square tables used by the engines, or null for the default tables
+         */
+        std::shared_ptr<const PieceSquareTables> pieceSquareTables;
+    };
+
+
+    /**
+     * @brief Outcome of a bench run
+     */
+    struct BenchResult {
+        /**
+         * @brief Number of nodes searched in each position, in the order of benchPositions
+         */
+        std::vector<long long> positionNodes;
+
+        /**
+         * @brief Total number of nodes. Only depends on the code of the search and the depth, so it tells whether a
+         * change altered the search
+         */
+        long long nodes = 0;
+
+        /**
+         * @brief Wall time of the run, in milliseconds
+         */
+        long long time = 0;
+
+
+        /**
+         * @brief Nodes searched per second of wall time
+         */
+        [[nodiscard]] long long nps() const;
+    };
+
+
+    /**
+     * @brief Fixed set of positions searched by a bench run, from the opening to the endgame
+     */
+    extern const std::vector<std::string> benchPositions;
+
+
+    /**
+     * @brief Searches every bench position to a fixed depth, from empty tables and without shuffling the moves, so
+     * that the number of nodes is the same from one run to the next, whatever the number of threads
+     * @param options  depth, table size, number of threads and network
+     * @return Nodes of every position, total nodes and wall time
+     */
+    BenchResult runBench(const BenchOptions &options);
+
+
+    /**
+     * @brief Prints the nodes of every position, then the total time, total nodes and nodes per second
+     * @param output  stream to print to
+     * @param result  outcome of a bench run
+     */
+    void printBench(std::ostream &output, const BenchResult &result);
+
+}
+
+#endif //CHESSQDL_BENCH_HPP
@@ -0,0 +1,244 @@
+#include "bitbase.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+using namespace chessqdl;
+
+namespace {
+
+    /**
+     * @brief Results of the retrograde analysis. They are bit flags so that the results of all moves can be combined
+     * with a bitwise or
+     */
+    enum enumResult : uint8_t {
+        nInvalid = 0,
+        nUnknown = 1,
+        nDraw = 2,
+        nWin = 4
+    };
+
+    constexpr uint64_t notA = 0xfefefefefefefefeULL;
+    constexpr uint64_t notH = 0x7f7f7f7f7f7f7f7fULL;
+
+    std::once_flag generated;
+
+    /**
+     * @brief One bit per position of the KPK bitbase, set when the strong side wins
+     */
+    std::array<uint64_t, kpkPositions / 64> kpkBits;
+
+    /**
+     * @brief One bit per position of the KPK bitbase, set when the position is invalid
+     */
+    std::array<uint64_t, kpkPositions / 64> kpkInvalidBits;
+
+    constexpr std::array<uint64_t, 64> kingAttacks = [] {
+        std::array<uint64_t, 64> attacks{};
+
+        for (int square = 0; square < 64; square++) {
+            const uint64_t king = 1ULL << square;
+            const uint64_t sides = ((king << 1) & notA) | ((king >> 1) & notH) | king;
+            attacks[square] = (sides | (sides << 8) | (sides >> 8)) & ~king;
+        }
+
+        return attacks;
+    }();
+
+    /**
+     * @brief Destination squares of a king on each square, padded with -1
+     */
+    constexpr std::array<std::array<int8_t, 8>, 64> kingMoves = [] {
+        std::array<std::array<int8_t, 8>, 64> moves{};
+
+        for (int square = 0; square < 64; square++) {
+            int n = 0;
+
+            for (int to = 0; to < 64; to++) {
+                if (kingAttacks[square] >> to & 1)
+                    moves[square][n++] = static_cast<int8_t>(to);
+            }
+
+            while (n < 8)
+                moves[square][n++] = -1;
+        }
+
+        return moves;
+    }();
+
+    uint64_t pawnAttacks(const int pawn) {
+        const uint64_t b = 1ULL << pawn;
+        return ((b << 9) & notA) | ((b << 7) & notH);
+    }
+
+    int distance(const int a, const int b) {
+        return std::max(std::abs(a % 8 - b % 8), std::abs(a / 8 - b / 8));
+    }
+
+    /**
+     * @brief Index of a position seen from the strong side, with its pawn on files a to d
+     * @param weakToMove  0 if the strong side is to move, 1 otherwise
+     */
+    int kpkIndex(const int weakToMove, const int weakKing, const int strongKing, const int pawn) {
+        return strongKing | (weakKing << 6) | (weakToMove << 12) | ((pawn % 8) << 13) | ((6 - pawn / 8) << 15);
+    }
+
+    /**
+     * @brief Classifies the positions that can be decided without looking at their successors
+     */
+    uint8_t initialResult(const int index) {
+        const int strongKing = index & 63;
+        const int weakKing = (index >> 6) & 63;
+        const int weakToMove = (index >> 12) & 1;
+        const int pawn = (6 - (index >> 15)) * 8 + ((index >> 13) & 3);
+
+        // Kings next to each other, pieces on the same square, or the weak king in check with the strong side to move
+        if (distance(strongKing, weakKing) <= 1 || strongKing == pawn || weakKing == pawn ||
+            (!weakToMove && (pawnAttacks(pawn) >> weakKing & 1)))
+            return nInvalid;
+
+        // The pawn promotes and the new queen cannot be taken
+        if (!weakToMove && pawn / 8 == 6 && strongKing != pawn + 8 &&
+            (distance(weakKing, pawn + 8) > 1 || distance(strongKing, pawn + 8) == 1))
+            return nWin;
+
+        const uint64_t guarded = kingAttacks[strongKing] | pawnAttacks(pawn);
+
+        // Stalemate, or the pawn can be taken
+        if (weakToMove && (!(kingAttacks[weakKing] & ~guarded) || (kingAttacks[weakKing] & ~guarded & (1ULL << pawn))))
+            return nDraw;
+
+        return nUnknown;
+    }
+
+    /**
+     * @brief Combines the results of the successors of a position. The strong side needs one winning move, the weak
+     * side one drawing move
+     */
+    uint8_t classify(const std::vector<uint8_t> &results, const int index) {
+        const int strongKing = index & 63;
+        const int weakKing = (index >> 6) & 63;
+        const int weakToMove = (index >> 12) & 1;
+        const int pawn = (6 - (index >> 15)) * 8 + ((index >> 13) & 3);
+
+        const enumResult good = weakToMove ? nDraw : nWin;
+        const enumResult bad = weakToMove ? nWin : nDraw;
+
+        uint8_t result = nInvalid;
+
+        for (const int8_t to: kingMoves[weakToMove ? weakKing : strongKing]) {
+            if (to < 0)
+                break;
+
+            result |= weakToMove ? results[kpkIndex(0, to, strongKing, pawn)]
+                                 : results[kpkIndex(1, weakKing, to, pawn)];
+        }
+
+        if (!weakToMove) {
+            if (pawn / 8 < 6)
+                result |= results[kpkIndex(1, weakKing, strongKing, pawn + 8)];
+
+            if (pawn / 8 == 1 && pawn + 8 != strongKing && pawn + 8 != weakKing)
+                result |= results[kpkIndex(1, weakKing, strongKing, pawn + 16)];
+        }
+
+        return result & good ? good : result & nUnknown ? nUnknown : bad;
+    }
+
+    void generateKPK(const unsigned threads) {
+        std::vector<uint8_t> results(kpkPositions);
+        std::vector<uint8_t> next(kpkPositions);
+
+        parallelFor(kpkPositions, threads, [&results](const size_t begin, const size_t end, unsigned) {
+            for (size_t i = begin; i < end; i++)
+                results[i] = initialResult(static_cast<int>(i));
+        });
+
+        // Every pass reads the results of the previous one, so threads never read what another thread writes
+        std::atomic<bool> changed = true;
+
+        while (changed) {
+            changed = false;
+
+            parallelFor(kpkPositions, threads, [&](const size_t begin, const size_t end, unsigned) {
+                bool rangeChanged = false;
+
+                for (size_t i = begin; i < end; i++) {
+                    next[i] = results[i] == nUnknown ? classify(results, static_cast<int>(i)) : results[i];
+                    rangeChanged |= next[i] != results[i];
+                }
+
+                if (rangeChanged)
+                    changed = true;
+            });
+
+            results.swap(next);
+        }
+
+        // Positions still unknown are those where neither side can force anything, hence draws
+        for (int i = 0; i < kpkPositions; i++) {
+            if (results[i] == nWin)
+                kpkBits[i / 64] |= 1ULL << (i % 64);
+            else if (results[i] == nInvalid)
+                kpkInvalidBits[i / 64] |= 1ULL << (i % 64);
+        }
+    }
+
+}
+
+
+void chessqdl::initBitbases(const unsigned threads) {
+    std::call_once(generated, generateKPK, threads);
+}
+
+
+/**
+ * @details Positions are flipped so that the strong side is white, and mirrored so that the pawn is on files a to d.
+ * A pawn on the first or last rank has no index, so it is rejected first
+ */
+enumBitbaseResult chessqdl::probeKPK(const enumColor strongColor, int strongKing, int pawn, int weakKing,
+                                     const enumColor sideToMove) {
+    if (pawn / 8 == 0 || pawn / 8 == 7)
+        return nBitbaseInvalid;
+
+    initBitbases();
+
+    if (strongColor == nBlack) {
+        strongKing ^= 56;
+        pawn ^= 56;
+        weakKing ^= 56;
+    }
+
+    if (pawn % 8 >= 4) {
+        strongKing ^= 7;
+        pawn ^= 7;
+        weakKing ^= 7;
+    }
+
+    const int index = kpkIndex(sideToMove == strongColor ? 0 : 1, weakKing, strongKing, pawn);
+
+    if (kpkInvalidBits[index / 64] >> (index % 64) & 1)
+        return nBitbaseInvalid;
+
+    return kpkBits[index / 64] >> (index % 64) & 1 ? nBitbaseWin : nBitbaseDraw;
+}
+
+
+enumBitbaseResult chessqdl::probeKPK(const BitboardArray &board, const enumColor sideToMove) {
+    const enumColor strongColor = (board[nPawn] & board[nWhite]).any() ? nWhite : nBlack;
+    const enumColor weakColor = strongColor == nWhite ? nBlack : nWhite;
+
+    // A king may have been captured by the pseudo-legal search
+    if ((board[nKing] & board[nWhite]).count() != 1 || (board[nKing] & board[nBlack]).count() != 1 ||
+        board[nPawn].count() != 1)
+        return nBitbaseInvalid;
+
+    return probeKPK(strongColor, leastSignificantSetBit((board[nKing] & board[strongColor]).to_ullong()),
+                    leastSignificantSetBit(board[nPawn].to_ullong()),
+                    leastSignificantSetBit((board[nKing] & board[weakColor]).to_ullong()), sideToMove);
+}
@@ -0,0 +1,61 @@
+#ifndef CHESSQDL_BITBASE_HPP
+#define CHESSQDL_BITBASE_HPP
+
+#include "const.hpp"
+
+#include <cstdint>
+
+namespace chessqdl {
+
+    /**
+     * @brief Number of positions in the KPK bitbase: side to move x pawn rank (2 to 7) x pawn file (a to d) x square of
+     * the weak king x square of the strong king
+     */
+    constexpr int kpkPositions = 2 * 6 * 4 * 64 * 64;
+
+
+    /**
+     * @brief Result of a bitbase probe, from the point of view of the strong side. Invalid positions cannot arise in a
+     * legal game, and must not be mistaken for draws by a pseudo-legal search that lets a king walk into check
+     */
+    enum enumBitbaseResult {
+        nBitbaseInvalid,
+        nBitbaseDraw,
+        nBitbaseWin
+    };
+
+
+    /**
+     * @brief Generates the bitbases by retrograde analysis, if they have not been generated yet. They are otherwise
+     * generated on first use, so calling this at startup only moves the cost out of the first search
+     * @param threads  number of threads to use. 0 uses one thread per hardware thread
+     */
+    void initBitbases(unsigned threads = 0);
+
+
+    /**
+     * @brief Probes the KPK bitbase. A position is won when the pawn can be promoted without being captured right away
+     * @param strongColor  color of the pawn
+     * @param strongKing  square of the king of \p strongColor
+     * @param pawn  square of the pawn
+     * @param weakKing  square of the other king
+     * @param sideToMove  color to move
+     * @return nBitbaseWin if \p strongColor wins, nBitbaseDraw if the position is a draw, and nBitbaseInvalid if the
+     * kings are next to each other, two pieces share a square, the pawn is on the first or last rank, or the weak king is
+     * in check with the strong side to move
+     */
+    enumBitbaseResult probeKPK(enumColor strongColor, int strongKing, int pawn, int weakKing, enumColor sideToMove);
+
+
+    /**
+     * @brief Probes the KPK bitbase for a board holding two kings and a single pawn
+     * @param board  board of interest
+     * @param sideToMove  color to move
+     * @return Result for the side with the pawn, nBitbaseInvalid if the board does not hold one king of each color and a
+     * single pawn
+     */
+    enumBitbaseResult probeKPK(const BitboardArray &board, enumColor sideToMove);
+
+}
+
+#endif //CHESSQDL_BITBASE_HPP
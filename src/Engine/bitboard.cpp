@@ -35,6 +35,13 @@ Bitboard::Bitboard() {
 }
 
 
+/**
+ * @details The bitboards are copied as they are, so they are expected to be consistent with each other.
+ */
+Bitboard::Bitboard(const BitboardArray &boards) : bitBoards(boards) {
+}
+
+
 /**
  * @details Constructor that uses a custom board, represented by the \p fen string.
  */
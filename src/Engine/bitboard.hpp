@@ -29,6 +29,12 @@ namespace chessqdl {
 		 */
 		explicit Bitboard(const std::string &fen);
 
+		/**
+		 * @brief Array constructor. Initializes bitBoards with a copy of the given bitboards
+		 * @param boards  bitboards of a position, indexed by enumColor and enumPiece
+		 */
+		explicit Bitboard(const BitboardArray &boards);
+
 		/**
 		 * @brief Returns a bitboard containing all pawns of a given color
 		 * @param color  the color of desired pieces (nWhite or nBlack)
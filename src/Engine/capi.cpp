@@ -0,0 +1,346 @@
+#include "ChessQDL/chessqdl.h"
+
+#include "analysis.hpp"
+#include "bitbase.hpp"
+#include "engine.hpp"
+#include "movegen.hpp"
+#include "perft.hpp"
+#include "san.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <exception>
+
+using namespace chessqdl;
+
+/**
+ * @details Only holds the engine, so that the handle stays opaque to C callers
+ */
+struct cqdl_engine {
+    Engine engine{nWhite, maxSearchDepth, false, true, 0};
+};
+
+
+namespace {
+
+    constexpr U64 backRanks = 0xff000000000000ffULL;
+
+    /**
+     * @brief Runs \p body, turning any exception into CQDL_INTERNAL_ERROR so that none crosses the C interface
+     */
+    template<typename Body>
+    cqdl_status guarded(Body body) noexcept {
+        try {
+            return body();
+        } catch (const std::exception &) {
+            return CQDL_INTERNAL_ERROR;
+        }
+    }
+
+    /**
+     * @brief Checks what Engine::setPosition expects of its bitboards: pieces that do not overlap, one king per color,
+     * no pawn on the first or last rank and no capturable king
+     */
+    bool isValidPosition(const BitboardArray &board, const enumColor toMove) {
+        if ((board[nWhite] & board[nBlack]).any() || board[nColor] != (board[nWhite] | board[nBlack]))
+            return false;
+
+        U64 pieces = 0;
+
+        for (int piece = nPawn; piece <= nKing; piece++) {
+            if ((pieces & board[piece]).any())
+                return false;
+            pieces |= board[piece];
+        }
+
+        return pieces == board[nColor] && (board[nKing] & board[nWhite]).count() == 1 &&
+               (board[nKing] & board[nBlack]).count() == 1 && (board[nPawn] & backRanks).none() &&
+               !MoveGenerator::isKingAttacked(board, toMove == nWhite ? nBlack : nWhite);
+    }
+
+    /**
+     * @brief Checks that the promotion bits of a packed move name a piece, since unpackMove looks the piece up by them
+     */
+    bool isValidPromotion(const uint16_t move) {
+        return (move >> 12) <= 4;
+    }
+
+    bool isLegal(const cqdl_engine *handle, const std::string &mv) {
+        const Engine &engine = handle->engine;
+        const auto moves = MoveGenerator::getLegalMoves(engine.getBitboard().getBitBoards(), engine.getToMove());
+
+        return std::find(moves.begin(), moves.end(), mv) != moves.end();
+    }
+
+}
+
+
+int cqdl_api_version() {
+    return CQDL_API_VERSION;
+}
+
+
+/**
+ * @details The KPK bitbase is generated by the first handle, rather than during its first search
+ */
+cqdl_engine *cqdl_create() {
+    try {
+        initBitbases();
+        return new cqdl_engine;
+    } catch (const std::exception &) {
+        return nullptr;
+    }
+}
+
+
+void cqdl_destroy(cqdl_engine *engine) {
+    delete engine;
+}
+
+
+cqdl_status cqdl_set_hash_size(cqdl_engine *engine, const size_t megabytes) {
+    if (!engine || megabytes == 0)
+        return CQDL_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        engine->engine.setHashSize(megabytes);
+        return CQDL_OK;
+    });
+}
+
+
+cqdl_status cqdl_clear_hash(cqdl_engine *engine) {
+    if (!engine)
+        return CQDL_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        engine->engine.clearHash();
+        return CQDL_OK;
+    });
+}
+
+
+/**
+ * @details The FEN is checked like an EPD line, then its board like a binary position, since Engine::setPosition
+ * trusts its input
+ */
+cqdl_status cqdl_set_fen(cqdl_engine *engine, const char *fen) {
+    if (!engine || !fen)
+        return CQDL_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        std::string position;
+        std::string id;
+
+        if (!parsePosition(fen, position, id))
+            return CQDL_INVALID_POSITION;
+
+        const BitboardArray board = Bitboard(position).getBitBoards();
+        const enumColor toMove = position[position.find(' ') + 1] == 'w' ? nWhite : nBlack;
+
+        if (!isValidPosition(board, toMove))
+            return CQDL_INVALID_POSITION;
+
+        engine->engine.setPosition(board, toMove);
+        return CQDL_OK;
+    });
+}
+
+
+cqdl_status cqdl_set_position(cqdl_engine *engine, const cqdl_position *position) {
+    if (!engine || !position || (position->side_to_move != CQDL_WHITE && position->side_to_move != CQDL_BLACK))
+        return CQDL_INVALID_ARGUMENT;
+
+    BitboardArray board;
+    board[nWhite] = position->colors[CQDL_WHITE];
+    board[nBlack] = position->colors[CQDL_BLACK];
+    board[nColor] = board[nWhite] | board[nBlack];
+
+    for (int piece = nPawn; piece <= nKing; piece++)
+        board[piece] = position->pieces[piece - nPawn];
+
+    const enumColor toMove = position->side_to_move == CQDL_WHITE ? nWhite : nBlack;
+
+    if (!isValidPosition(board, toMove))
+        return CQDL_INVALID_POSITION;
+
+    return guarded([&] {
+        engine->engine.setPosition(board, toMove);
+        return CQDL_OK;
+    });
+}
+
+
+cqdl_status cqdl_get_position(const cqdl_engine *engine, cqdl_position *position) {
+    if (!engine || !position)
+        return CQDL_INVALID_ARGUMENT;
+
+    const BitboardArray &board = engine->engine.getBitboard().getBitBoards();
+    position->colors[CQDL_WHITE] = board[nWhite].to_ullong();
+    position->colors[CQDL_BLACK] = board[nBlack].to_ullong();
+
+    for (int piece = nPawn; piece <= nKing; piece++)
+        position->pieces[piece - nPawn] = board[piece].to_ullong();
+
+    position->side_to_move = engine->engine.getToMove() == nWhite ? CQDL_WHITE : CQDL_BLACK;
+
+    return CQDL_OK;
+}
+
+
+cqdl_status cqdl_make_move(cqdl_engine *engine, const uint16_t move) {
+    if (!engine || !isValidPromotion(move))
+        return CQDL_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        const std::string mv = unpackMove(move);
+
+        if (!isLegal(engine, mv))
+            return CQDL_ILLEGAL_MOVE;
+
+        engine->engine.makeMove(mv, false, false);
+        return CQDL_OK;
+    });
+}
+
+
+cqdl_status cqdl_take_move(cqdl_engine *engine) {
+    if (!engine)
+        return CQDL_INVALID_ARGUMENT;
+
+    if (engine->engine.getMoveHistory().empty())
+        return CQDL_ILLEGAL_MOVE;
+
+    return guarded([&] {
+        engine->engine.takeMove();
+        return CQDL_OK;
+    });
+}
+
+
+cqdl_status cqdl_parse_move(const cqdl_engine *engine, const char *text, uint16_t *move) {
+    if (!engine || !text || !move)
+        return CQDL_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        const PackedMove mv = sanToPackedMove(engine->engine.getBitboard().getBitBoards(), engine->engine.getToMove(),
+                                              text);
+
+        if (mv == nullMove)
+            return CQDL_ILLEGAL_MOVE;
+
+        *move = mv;
+        return CQDL_OK;
+    });
+}
+
+
+cqdl_status cqdl_move_to_string(const uint16_t move, char *buffer, const size_t size) {
+    if (!buffer || size == 0 || !isValidPromotion(move))
+        return CQDL_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        const std::string mv = unpackMove(move);
+
+        if (mv.size() >= size) {
+            buffer[0] = '\0';
+            return CQDL_BUFFER_TOO_SMALL;
+        }
+
+        buffer[mv.copy(buffer, mv.size())] = '\0';
+        return CQDL_OK;
+    });
+}
+
+
+cqdl_status cqdl_legal_moves(const cqdl_engine *engine, uint16_t *moves, const size_t capacity, size_t *count) {
+    if (!engine || !count || (!moves && capacity > 0))
+        return CQDL_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        const auto legal = MoveGenerator::getLegalMoves(engine->engine.getBitboard().getBitBoards(),
+                                                        engine->engine.getToMove());
+        *count = legal.size();
+
+        for (size_t i = 0; i < legal.size() && i < capacity; i++)
+            moves[i] = packMove(legal[i]);
+
+        return legal.size() > capacity ? CQDL_BUFFER_TOO_SMALL : CQDL_OK;
+    });
+}
+
+
+cqdl_status cqdl_perft(const cqdl_engine *engine, const int depth, const unsigned threads, uint64_t *nodes) {
+    if (!engine || !nodes || depth < 1)
+        return CQDL_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        *nodes = perftDivide(engine->engine.getBitboard().getBitBoards(), engine->engine.getToMove(), depth, threads,
+                             16).nodes;
+        return CQDL_OK;
+    });
+}
+
+
+/**
+ * @details The principal variations are packed into a buffer owned by this call, so the callback sees plain arrays
+ */
+cqdl_status cqdl_search(cqdl_engine *engine, const cqdl_limits *limits, const cqdl_info_callback callback,
+                        void *user_data, uint16_t *best_move) {
+    if (!engine || !limits || !best_move || limits->depth < 0 || limits->nodes < 0 || limits->move_time < 0 ||
+        limits->multipv < 0)
+        return CQDL_INVALID_ARGUMENT;
+
+    SearchLimits searchLimits;
+    searchLimits.depth = limits->depth;
+    searchLimits.nodes = limits->nodes;
+    searchLimits.moveTime = limits->move_time;
+    searchLimits.time = {limits->time[CQDL_WHITE], limits->time[CQDL_BLACK]};
+    searchLimits.increment = {limits->increment[CQDL_WHITE], limits->increment[CQDL_BLACK]};
+    searchLimits.movesToGo = limits->moves_to_go;
+    searchLimits.multiPv = limits->multipv == 0 ? 1 : limits->multipv;
+
+    const enumColor toMove = engine->engine.getToMove();
+
+    if (searchLimits.depth == 0 && searchLimits.nodes == 0 && searchLimits.moveTime == 0 &&
+        searchLimits.time[toMove] <= 0)
+        return CQDL_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        std::vector<uint16_t> pv;
+
+        const auto report = [&](const SearchInfo &info, const int line, const int score,
+                                const std::vector<std::string> &moves) {
+            pv.clear();
+            for (const std::string &mv: moves)
+                pv.push_back(packMove(mv));
+
+            const cqdl_info progress{info.depth, score, info.nodes, info.time, info.hashfull, line, pv.data(),
+                                     pv.size()};
+            callback(&progress, user_data);
+        };
+
+        const std::string bestMove = engine->engine.search(searchLimits, [&](const SearchInfo &info) {
+            if (!callback)
+                return;
+
+            if (info.lines.empty())
+                report(info, 1, info.score, info.pv);
+
+            for (size_t i = 0; i < info.lines.size(); i++)
+                report(info, static_cast<int>(i) + 1, info.lines[i].score, info.lines[i].pv);
+        });
+
+        *best_move = bestMove.empty() ? 0 : packMove(bestMove);
+        return CQDL_OK;
+    });
+}
+
+
+cqdl_status cqdl_stop(cqdl_engine *engine) {
+    if (!engine)
+        return CQDL_INVALID_ARGUMENT;
+
+    engine->engine.stop();
+    return CQDL_OK;
+}
@@ -6,6 +6,7 @@
 #include <string>
 #include <bitset>
 #include <limits>
+#include <cstdint>
 
 namespace chessqdl {
 
@@ -19,6 +20,16 @@ namespace chessqdl {
 	 */
 	typedef std::array<U64, 9> BitboardArray;
 
+	/**
+	 * @brief Compact representation of a move: source square in bits 0-5, destination square in bits 6-11 and promotion piece in bits 12-14 (0 if none)
+	 */
+	typedef uint16_t PackedMove;
+
+	/**
+	 * @brief PackedMove value that does not represent any move (a1a1)
+	 */
+	constexpr PackedMove nullMove = 0;
+
 	/**
 	 * @brief Constants representing the board with all bits set except for A or H file
 	 */
@@ -95,6 +106,11 @@ namespace chessqdl {
 												   "a7", "b7", "c7", "d7", "e7", "f7", "g7", "h7",
 												   "a8", "b8", "c8", "d8", "e8", "f8", "g8", "h8"};
 
+	/**
+	 * @brief FEN of the initial position. Castling is not generated, so no castling rights are given
+	 */
+	const std::string startFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - - 0 1";
+
 	constexpr int intMin = std::numeric_limits<int>::min();
 	constexpr int intMax = std::numeric_limits<int>::max();
 
@@ -0,0 +1,297 @@
+#include "endgame.hpp"
+#include "bitbase.hpp"
+#include "evaluation.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <unordered_map>
+
+using namespace chessqdl;
+
+namespace {
+
+    /**
+     * @brief Specialized evaluator. Returns the score from the point of view of \p strongColor
+     */
+    typedef int (*EndgameEvaluator)(const BitboardArray &board, enumColor strongColor, enumColor sideToMove);
+
+    struct EndgameEntry {
+        EndgameEvaluator evaluate;
+        enumColor strongColor;
+    };
+
+    constexpr uint64_t darkSquares = 0xaa55aa55aa55aa55ULL;
+
+    int count(const uint64_t materialKey, const int color, const int piece) {
+        return static_cast<int>((materialKey >> (4 * (color * 5 + piece - nPawn))) & 0xf);
+    }
+
+    /**
+     * @brief Material of a color without its pawns and king
+     */
+    int nonPawnMaterial(const uint64_t materialKey, const int color) {
+        int material = 0;
+
+        for (int piece = nKnight; piece <= nQueen; piece++)
+            material += count(materialKey, color, piece) * pieceValues[piece];
+
+        return material;
+    }
+
+    /**
+     * @brief Material keys leave the kings out, so a board where the pseudo-legal search has captured a king shares its
+     * key with real endgames. Such boards must keep the generic evaluation of a lost king
+     */
+    bool hasBothKings(const BitboardArray &board) {
+        return (board[nKing] & board[nWhite]).count() == 1 && (board[nKing] & board[nBlack]).count() == 1;
+    }
+
+    int squareOf(const BitboardArray &board, const int color, const int piece) {
+        return leastSignificantSetBit((board[color] & board[piece]).to_ullong());
+    }
+
+    int distance(const int a, const int b) {
+        return std::max(std::abs(a % 8 - b % 8), std::abs(a / 8 - b / 8));
+    }
+
+    /**
+     * @brief Bonus for driving a king away from the center, from 0 on the central squares to 120 in the corners
+     */
+    int pushToEdge(const int square) {
+        const int file = square % 8;
+        const int rank = square / 8;
+        return 20 * ((file < 4 ? 3 - file : file - 4) + (rank < 4 ? 3 - rank : rank - 4));
+    }
+
+    /**
+     * @brief Bonus for bringing two pieces close to each other
+     */
+    int pushClose(const int a, const int b) {
+        return 140 - 20 * distance(a, b);
+    }
+
+    int evaluateDraw(const BitboardArray &, const enumColor, const enumColor) {
+        return 0;
+    }
+
+    /**
+     * @brief Lone king against mating material: the weak king is driven to the edge and the strong king brought closer
+     */
+    int evaluateKXK(const BitboardArray &board, const enumColor strongColor, const enumColor) {
+        const enumColor weakColor = strongColor == nWhite ? nBlack : nWhite;
+        const int strongKing = squareOf(board, strongColor, nKing);
+        const int weakKing = squareOf(board, weakColor, nKing);
+        const U64 pieces = board[strongColor];
+
+        int score = pushToEdge(weakKing) + pushClose(strongKing, weakKing);
+
+        for (int piece = nPawn; piece <= nQueen; piece++)
+            score += pieceValues[piece] * static_cast<int>((pieces & board[piece]).count());
+
+        const uint64_t bishops = (pieces & board[nBishop]).to_ullong();
+        const bool bishopPair = (bishops & darkSquares) && (bishops & ~darkSquares);
+
+        if ((pieces & (board[nQueen] | board[nRook])).any() || bishopPair ||
+            ((pieces & board[nBishop]).any() && (pieces & board[nKnight]).any()))
+            score += knownWinBonus;
+
+        return score;
+    }
+
+    /**
+     * @brief Bishop and knight against a lone king: the weak king is driven to a corner of the bishop's color
+     */
+    int evaluateKBNK(const BitboardArray &board, const enumColor strongColor, const enumColor) {
+        const enumColor weakColor = strongColor == nWhite ? nBlack : nWhite;
+        const int strongKing = squareOf(board, strongColor, nKing);
+        const int weakKing = squareOf(board, weakColor, nKing);
+        const bool darkBishop = (board[strongColor] & board[nBishop]).to_ullong() & darkSquares;
+
+        const int cornerDistance = darkBishop ? std::min(distance(weakKing, a1), distance(weakKing, h8))
+                                              : std::min(distance(weakKing, h1), distance(weakKing, a8));
+
+        return knownWinBonus + pieceValues[nBishop] + pieceValues[nKnight] + pushClose(strongKing, weakKing) +
+               30 * (7 - cornerDistance);
+    }
+
+    /**
+     * @brief King and pawn against king, read from the bitbase. Won positions are rewarded for advancing the pawn
+     */
+    int evaluateKPK(const BitboardArray &board, const enumColor strongColor, const enumColor sideToMove) {
+        if (probeKPK(board, sideToMove) != nBitbaseWin)
+            return 0;
+
+        const int pawn = relativeSquare(strongColor, squareOf(board, strongColor, nPawn));
+        return knownWinBonus + pieceValues[nPawn] + 20 * (pawn / 8);
+    }
+
+    /**
+     * @brief Rook against pawn. Won when the strong king stands in front of the pawn or when the weak king is too far
+     * away to support it, otherwise close to a draw
+     */
+    int evaluateKRKP(const BitboardArray &board, const enumColor strongColor, const enumColor sideToMove) {
+        const enumColor weakColor = strongColor == nWhite ? nBlack : nWhite;
+        const int weakTempo = sideToMove == weakColor ? 1 : 0;
+
+        // Squares are seen from the strong side, so that the pawn moves south
+        const int strongKing = relativeSquare(strongColor, squareOf(board, strongColor, nKing));
+        const int weakKing = relativeSquare(strongColor, squareOf(board, weakColor, nKing));
+        const int rook = relativeSquare(strongColor, squareOf(board, strongColor, nRook));
+        const int pawn = relativeSquare(strongColor, squareOf(board, weakColor, nPawn));
+        const int queeningSquare = pawn % 8;
+
+        if (strongKing % 8 == pawn % 8 && strongKing < pawn)
+            return pieceValues[nRook] - distance(strongKing, pawn);
+
+        if (distance(weakKing, pawn) >= 3 + weakTempo && distance(weakKing, rook) >= 3)
+            return pieceValues[nRook] - distance(strongKing, pawn);
+
+        if (weakKing / 8 <= 2 && distance(weakKing, pawn) == 1 && strongKing / 8 >= 3 &&
+            distance(strongKing, pawn) > 3 - weakTempo)
+            return 80 - 8 * distance(strongKing, pawn);
+
+        return 200 - 8 * (distance(strongKing, pawn - 8) - distance(weakKing, pawn - 8) -
+                          distance(pawn, queeningSquare));
+    }
+
+    /**
+     * @brief Swaps the two sides of a material signature, "KRKP" becoming "KPKR"
+     */
+    std::string mirrorCode(const std::string &code) {
+        const size_t weak = code.find('K', 1);
+        return code.substr(weak) + code.substr(0, weak);
+    }
+
+    /**
+     * @brief Specialized evaluators indexed by material key. Every signature is registered for both colors
+     */
+    const std::unordered_map<uint64_t, EndgameEntry> &getEndgameTable() {
+        static const std::unordered_map<uint64_t, EndgameEntry> table = [] {
+            std::unordered_map<uint64_t, EndgameEntry> entries;
+
+            const auto add = [&entries](const std::string &code, const EndgameEvaluator evaluate) {
+                entries[materialKeyFromCode(mirrorCode(code))] = {evaluate, nBlack};
+                entries[materialKeyFromCode(code)] = {evaluate, nWhite};
+            };
+
+            // Insufficient material
+            for (const char *code : {"KK", "KNK", "KBK", "KNNK", "KNKN", "KBKN", "KBKB"})
+                add(code, evaluateDraw);
+
+            add("KBNK", evaluateKBNK);
+            add("KPK", evaluateKPK);
+            add("KRKP", evaluateKRKP);
+
+            return entries;
+        }();
+
+        return table;
+    }
+
+}
+
+
+/**
+ * @details Adds the contribution of every piece on the board.
+ */
+uint64_t chessqdl::computeMaterialKey(const BitboardArray &board) {
+    uint64_t key = 0;
+
+    for (int color = nWhite; color <= nBlack; color++)
+        for (int piece = nPawn; piece <= nQueen; piece++)
+            key += (board[color] & board[piece]).count() * materialKeyOf(static_cast<enumColor>(color), piece);
+
+    return key;
+}
+
+
+/**
+ * @details Characters other than the piece letters are ignored.
+ */
+uint64_t chessqdl::materialKeyFromCode(const std::string &code) {
+    const std::string letters = "PNBRQ";
+    uint64_t key = 0;
+    int kings = 0;
+
+    for (const char c : code) {
+        if (c == 'K')
+            kings++;
+        else if (letters.find(c) != std::string::npos)
+            key += materialKeyOf(kings > 1 ? nBlack : nWhite, nPawn + static_cast<int>(letters.find(c)));
+    }
+
+    return key;
+}
+
+
+/**
+ * @details Every specialized evaluator involves at most three pieces besides the kings, except for KXK, which requires
+ * a lone king. Positions with more material, or without both kings, are rejected before the table is looked up.
+ */
+bool chessqdl::evaluateEndgame(const BitboardArray &board, const uint64_t materialKey, const enumColor color,
+                               int &score) {
+    const enumColor enemyColor = color == nWhite ? nBlack : nWhite;
+    const size_t pieces = board[nColor].count();
+
+    if (!hasBothKings(board))
+        return false;
+
+    if (pieces <= 5) {
+        const auto &table = getEndgameTable();
+        const auto entry = table.find(materialKey);
+
+        if (entry != table.end()) {
+            const int value = entry->second.evaluate(board, entry->second.strongColor, color);
+            score = entry->second.strongColor == color ? value : -value;
+            return true;
+        }
+    }
+
+    for (const enumColor strongColor : {color, enemyColor}) {
+        const enumColor weakColor = strongColor == nWhite ? nBlack : nWhite;
+
+        if (board[weakColor].count() == 1 && nonPawnMaterial(materialKey, strongColor) >= pieceValues[nRook]) {
+            const int value = evaluateKXK(board, strongColor, color);
+            score = strongColor == color ? value : -value;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/**
+ * @details Without pawns, the stronger side needs to be ahead by more than a minor piece to win. With one bishop each
+ * on squares of different colors, and no other pieces, even a two pawn advantage is often not enough. Boards without
+ * both kings are left unscaled.
+ */
+int chessqdl::endgameScaleFactor(const BitboardArray &board, const uint64_t materialKey, const enumColor strongColor) {
+    const enumColor weakColor = strongColor == nWhite ? nBlack : nWhite;
+    const int strongMaterial = nonPawnMaterial(materialKey, strongColor);
+    const int weakMaterial = nonPawnMaterial(materialKey, weakColor);
+
+    if (!hasBothKings(board))
+        return normalScaleFactor;
+
+    if (count(materialKey, strongColor, nPawn) == 0 && strongMaterial - weakMaterial <= pieceValues[nBishop]) {
+        if (strongMaterial < pieceValues[nRook])
+            return 0;
+        return weakMaterial <= pieceValues[nBishop] ? 4 : 14;
+    }
+
+    if (count(materialKey, nWhite, nBishop) == 1 && count(materialKey, nBlack, nBishop) == 1) {
+        const uint64_t bishops = board[nBishop].to_ullong();
+
+        if ((bishops & darkSquares) && (bishops & ~darkSquares)) {
+            if (strongMaterial != pieceValues[nBishop] || weakMaterial != pieceValues[nBishop])
+                return 46;
+
+            const int pawnAdvantage = count(materialKey, strongColor, nPawn) - count(materialKey, weakColor, nPawn);
+            return pawnAdvantage <= 1 ? 16 : 32;
+        }
+    }
+
+    return normalScaleFactor;
+}
@@ -0,0 +1,82 @@
+#ifndef CHESSQDL_ENDGAME_HPP
+#define CHESSQDL_ENDGAME_HPP
+
+#include "const.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace chessqdl {
+
+    /**
+     * @brief Scale factor that leaves the evaluation untouched. Scaled scores are multiplied by the scale factor and
+     * divided by this value
+     */
+    constexpr int normalScaleFactor = 64;
+
+
+    /**
+     * @brief Bonus added by the specialized evaluators to positions that are known to be won
+     */
+    constexpr int knownWinBonus = 1000;
+
+
+    /**
+     * @brief Contribution of one piece to a material key. The key holds the number of pieces of each color and type
+     * (kings excluded) in consecutive 4 bit fields, so it identifies the material signature exactly
+     * @param color  color of the piece
+     * @param piece  type of the piece
+     * @return Value to add to the key when the piece is placed on the board, 0 for kings
+     */
+    constexpr uint64_t materialKeyOf(const enumColor color, const int piece) {
+        return piece >= nPawn && piece <= nQueen ? 1ULL << (4 * (color * 5 + piece - nPawn)) : 0;
+    }
+
+
+    /**
+     * @brief Computes the material key of a board from scratch
+     * @param board  board of interest
+     * @return Material key of \p board
+     */
+    uint64_t computeMaterialKey(const BitboardArray &board);
+
+
+    /**
+     * @brief Computes the material key of a material signature written as in "KBNK" or "KRKP": the pieces of white
+     * start at the first king and the pieces of black at the second one
+     * @param code  material signature
+     * @return Material key of the signature
+     */
+    uint64_t materialKeyFromCode(const std::string &code);
+
+
+    /**
+     * @brief Looks for a specialized evaluator for the material on the board and runs it. <br>
+     *
+     * Evaluators are looked up by material key first (insufficient material, KBNK, KPK, KRKP), and then the lone king
+     * evaluator (KXK) is tried, which applies to many material keys at once
+     * @param board  board to evaluate
+     * @param materialKey  material key of \p board
+     * @param color  perspective of the evaluation. Evaluations are meant for the side to move, so \p color is also taken
+     * as the side to move by the evaluators that depend on it (KPK, KRKP)
+     * @param score  filled with the score for \p color when a specialized evaluator applies
+     * @return True if a specialized evaluator applies, in which case the generic evaluation must be skipped
+     */
+    bool evaluateEndgame(const BitboardArray &board, uint64_t materialKey, enumColor color, int &score);
+
+
+    /**
+     * @brief Computes how much of the generic evaluation the stronger side can expect to convert. <br>
+     *
+     * Pawnless positions where the stronger side is not ahead by more than a minor piece, and opposite-colored bishop
+     * endings, are scaled down
+     * @param board  board of interest
+     * @param materialKey  material key of \p board
+     * @param strongColor  color that the generic evaluation favours
+     * @return Scale factor between 0 and normalScaleFactor
+     */
+    int endgameScaleFactor(const BitboardArray &board, uint64_t materialKey, enumColor strongColor);
+
+}
+
+#endif //CHESSQDL_ENDGAME_HPP
@@ -1,14 +1,45 @@
 #include "engine.hpp"
 #include "utils.hpp"
 #include "movegen.hpp"
+#include "zobrist.hpp"
+#include "see.hpp"
+#include "bitbase.hpp"
+#include "perft.hpp"
+#include "san.hpp"
+#include "instrument.hpp"
 
 #include <iostream>
 #include <algorithm>
 #include <random>
 #include <chrono>
+#include <cassert>
 
 using namespace chessqdl;
 
+namespace {
+
+    /**
+     * @brief Quiet moves that lose more than this many centipawns per remaining ply are not searched near the leaves
+     */
+    constexpr int quietPruningMargin = 100;
+
+    /**
+     * @brief Maximum remaining depth at which quiet moves are pruned by their static exchange evaluation
+     */
+    constexpr int quietPruningDepth = 2;
+
+    /**
+     * @brief Ordering key offset that separates winning and losing captures from quiet moves
+     */
+    constexpr int captureOrderingOffset = 1000000;
+
+    /**
+     * @brief Piece of each promotion code of a PackedMove
+     */
+    constexpr enumPiece promotionPieces[] = {nPawn, nKnight, nBishop, nRook, nQueen};
+
+}
+
 
 /**
  * @details Starts a new standard game of chess with the engine as \p color pieces
@@ -22,6 +53,10 @@ Engine::Engine(const enumColor color, const int depth, const bool v, const bool
     generator = !seed.has_value()
                     ? std::default_random_engine(std::chrono::system_clock::now().time_since_epoch().count())
                     : std::default_random_engine(seed.value());
+    hash = Zobrist::hashBoard(bitboard.getBitBoards(), toMove);
+    evalState = computeEvalState(bitboard.getBitBoards(), *pieceSquareTables);
+    startBoard = bitboard.getBitBoards();
+    startToMove = toMove;
 }
 
 
@@ -40,6 +75,21 @@ Engine::Engine(const std::string &fen, const enumColor color, const int depth, c
     generator = !seed.has_value()
                     ? std::default_random_engine(std::chrono::system_clock::now().time_since_epoch().count())
                     : std::default_random_engine(seed.value());
+    hash = Zobrist::hashBoard(bitboard.getBitBoards(), toMove);
+    evalState = computeEvalState(bitboard.getBitBoards(), *pieceSquareTables);
+    startBoard = bitboard.getBitBoards();
+    startToMove = toMove;
+}
+
+
+/**
+ * @details A ponder search may still be running if the game ended while the engine was thinking on the opponent's time
+ */
+Engine::~Engine() {
+    if (ponderThread.joinable()) {
+        stopSearch = true;
+        ponderThread.join();
+    }
 }
 
 
@@ -70,12 +120,198 @@ void Engine::setDepth(const int n) {
 }
 
 
+/**
+ * @details Pondering only starts after the engine's next move
+ */
+void Engine::setPonder(const bool enabled) {
+    ponder = enabled;
+}
+
+
+/**
+ * @details Sets Engine::shuffleMoves
+ */
+void Engine::setShuffle(const bool enabled) {
+    shuffleMoves = enabled;
+}
+
+
+/**
+ * @details Resizes Engine::transpositionTable
+ */
+void Engine::setHashSize(const size_t megabytes) {
+    transpositionTable.resize(megabytes);
+}
+
+
+/**
+ * @details Resizes Engine::pawnTable
+ */
+void Engine::setPawnHashSize(const size_t megabytes) {
+    pawnTable.resize(megabytes);
+}
+
+
+/**
+ * @details Resizes Engine::evalCache
+ */
+void Engine::setEvalCacheSize(const size_t megabytes) {
+    evalCache.resize(megabytes);
+}
+
+
+void Engine::clearHash() {
+    transpositionTable.clear();
+    evalCache.clear();
+}
+
+
+/**
+ * @details The file is read into a copy of the current tables, which then replaces them. See
+ * Engine::setPieceSquareTables
+ */
+bool Engine::loadWeights(const std::string &path) {
+    auto tables = std::make_shared<PieceSquareTables>(*pieceSquareTables);
+
+    if (!loadPieceSquareTables(path, *tables))
+        return false;
+
+    setPieceSquareTables(tables);
+
+    return true;
+}
+
+
+/**
+ * @details The evaluation state is recomputed with the new tables. The evaluation cache and the transposition table
+ * are cleared since their scores were computed with the old ones
+ */
+void Engine::setPieceSquareTables(std::shared_ptr<const PieceSquareTables> tables) {
+    pieceSquareTables = tables ? std::move(tables) : getSharedDefaultPieceSquareTables();
+    evalState = computeEvalState(bitboard.getBitBoards(), *pieceSquareTables);
+    evalCache.clear();
+    transpositionTable.clear();
+}
+
+
+/**
+ * @details Returns Engine::pieceSquareTables
+ */
+std::shared_ptr<const PieceSquareTables> Engine::getPieceSquareTables() const {
+    return pieceSquareTables;
+}
+
+
+/**
+ * @details See Engine::setNetwork
+ */
+bool Engine::loadNetwork(const std::string &path) {
+    auto net = std::make_shared<NnueNetwork>();
+
+    if (!net->load(path))
+        return false;
+
+    setNetwork(net);
+
+    return true;
+}
+
+
+/**
+ * @details The accumulator of the current position is computed from scratch. Positions already in the move history do
+ * not need one, since they are only reached again through takeMove, which computes theirs from scratch as well. The
+ * evaluation cache and the transposition table are cleared since their scores were computed with the previous evaluation
+ */
+void Engine::setNetwork(std::shared_ptr<const NnueNetwork> net) {
+    network = std::move(net);
+    accumulators.clear();
+
+    if (network)
+        accumulators.push_back(network->refresh(bitboard.getBitBoards()));
+
+    evalCache.clear();
+    transpositionTable.clear();
+}
+
+
+/**
+ * @details Returns Engine::network
+ */
+std::shared_ptr<const NnueNetwork> Engine::getNetwork() const {
+    return network;
+}
+
+
+/**
+ * @details Returns the last element of Engine::accumulators
+ */
+const NnueAccumulator &Engine::getAccumulator() const {
+    return accumulators.back();
+}
+
+
+/**
+ * @details Returns Engine::hash
+ */
+uint64_t Engine::getHash() const {
+    return hash;
+}
+
+
+/**
+ * @details Returns Engine::bitboard
+ */
+const Bitboard &Engine::getBitboard() const {
+    return bitboard;
+}
+
+
+/**
+ * @details Returns Engine::evalState
+ */
+const EvalState &Engine::getEvalState() const {
+    return evalState;
+}
+
+
+/**
+ * @details Only the board and the side to move are read from \p fen. The transposition table is kept, since it is keyed
+ * by position
+ */
+void Engine::setPosition(const std::string &fen) {
+    setPosition(Bitboard(fen).getBitBoards(), (fen.substr(fen.find(' ') + 1, 1) == "w") ? nWhite : nBlack);
+}
+
+
+/**
+ * @details Also used by the FEN overload, so that both reset the history, hashes and evaluation state the same way
+ */
+void Engine::setPosition(const BitboardArray &board, const enumColor color) {
+    bitboard = Bitboard(board);
+    toMove = color;
+    moveHistory.clear();
+    captureHistory.clear();
+    startBoard = bitboard.getBitBoards();
+    startToMove = toMove;
+    ply = 0;
+    hash = Zobrist::hashBoard(bitboard.getBitBoards(), toMove);
+    evalState = computeEvalState(bitboard.getBitBoards(), *pieceSquareTables);
+    accumulators.clear();
+
+    if (network)
+        accumulators.push_back(network->refresh(bitboard.getBitBoards()));
+}
+
+
 /**
  * @details Main interface to the engine. Allows the player to interact with the engine with the options: <br>
  * <b> print </b> calls Engine::printBoard() and prints the current state of the board to stdout using Unicode symbols <br>
- * <b> move </b> or <b> mv </b> expects a string after the keyword with the move to be made. The move will only be made if a) it's your turn to move the desired pieces and b) the move is valid <br>
+ * <b> move </b> or <b> mv </b> expects a string after the keyword with the move to be made, in coordinate or standard algebraic notation. The move will only be made if a) it's your turn to move the desired pieces and b) the move is valid <br>
  * <b> undo </b> takes back the latest move made. Can take an argument after the keyword to specify the amount of moves to be unmade <br>
  * <b> depth </b> or <b> set_depth </b> specifies the new maximum search depth of the algorithm. The higher the maximum depth, the higher the difficulty of the engine <br>
+ * <b> history </b> prints the moves of the game in standard algebraic notation <br>
+ * <b> multipv </b> prints the given number of best lines for the side to move, with their scores and principal variations <br>
+ * <b> ponder </b> toggles pondering. While pondering, the engine searches the reply it expects from the opponent as soon as it has moved <br>
  * <b> exit </b> or <b> quit </b> exits the game without saving the progress <br>
  */
 void Engine::parser() {
@@ -83,20 +319,53 @@ void Engine::parser() {
 
     while (true) {
         if (pieceColor == toMove && !pvp) {
-            if (this->beVerbose) std::cout << std::endl << "Searching for the next move..." << std::endl;
-            makeMove(getBestMove(depthLevel, pieceColor));
+            std::string bestMove;
+
+            // A ponder hit already searched this very position
+            if (!ponderResult.empty() && hash == ponderHash)
+                bestMove = ponderResult;
+            else {
+                if (this->beVerbose) std::cout << std::endl << "Searching for the next move..." << std::endl;
+                bestMove = getBestMove(depthLevel, pieceColor);
+            }
+
+            ponderResult.clear();
+            makeMove(bestMove);
             printBoard();
+
+            if (ponder && bitboard.getKing(nWhite) != 0 && bitboard.getKing(nBlack) != 0)
+                startPondering();
         }
 
         std::cout << "> ";
         std::cin >> input;
 
+        // The opponent's reply. Only differs from `input` when the move is given after the move keyword
+        std::string reply = input;
+
+        if (input == "move" || input == "mv")
+            std::cin >> reply;
+
+        // The board can only be used by this thread once the ponder search is over. A played move ends it, as a hit or
+        // a miss, while other commands only interrupt it if they need the board, and it is resumed after them
+        bool resumePondering = false;
+
+        if (pondering) {
+            const std::string played = sanToMove(ponderBoard, pieceColor == nWhite ? nBlack : nWhite, reply);
+
+            if (!played.empty() || reply != input)
+                stopPondering(played);
+            else if (input != "help" && input != "exit" && input != "quit") {
+                stopPondering("");
+                resumePondering = true;
+            }
+        }
+
         if (input == "print" || input == "print_board")
             printBoard();
         else if (input == "move" || input == "mv") {
-            // Reads the movement to be made
-            std::cin >> input;
-            makeMove(input);
+            const std::string mv = sanToMove(bitboard.getBitBoards(), toMove, reply);
+            makeMove(mv.empty() ? reply : mv);
             printBoard();
         } else if (input == "undo") {
             int num = 1;
@@ -122,8 +391,30 @@ void Engine::parser() {
             const auto moves = getLegalMoves();
             for (auto &mv: moves)
                 std::cout << mv << std::endl;
+        } else if (input == "history") {
+            const auto moves = getSanHistory();
+            for (size_t i = 0; i < moves.size(); i++)
+                std::cout << (i % 2 == 0 ? (i > 0 ? " " : "") + std::to_string(i / 2 + 1) + ". " : " ") << moves[i];
+            std::cout << std::endl;
         } else if (input == "hint") {
             std::cout << getBestMove(depthLevel, toMove) << std::endl;
+        } else if (input == "multipv") {
+            int count = 1;
+            readInteger(count);
+            const auto lines = getBestMoves(depthLevel, toMove, count);
+            for (size_t i = 0; i < lines.size(); i++) {
+                std::cout << i + 1 << ". " << lines[i].move << " (score " << lines[i].score << "):";
+                for (const auto &mv: lines[i].pv)
+                    std::cout << " " << mv;
+                std::cout << std::endl;
+            }
+        } else if (input == "perft") {
+            int d = 4;
+            readInteger(d);
+            printPerft(std::cout, perftDivide(bitboard.getBitBoards(), toMove, std::max(d, 1), 0, 64));
+        } else if (input == "ponder") {
+            setPonder(!ponder);
+            std::cout << "Pondering " << (ponder ? "enabled" : "disabled") << std::endl;
         } else if (input == "help") {
             std::cout << "print_board (print for short) - prints out the current state of the board" << std::endl;
             std::cout << "move (mv for short)           - makes a movement if valid. 'move' and 'mv' can be omitted" <<
@@ -133,7 +424,12 @@ void Engine::parser() {
                     << std::endl;
             std::cout << "list                          - prints out a list of valid moves in the expected format" <<
                     std::endl;
+            std::cout << "history                       - prints the moves of the game in standard algebraic notation" <<
+                    std::endl;
             std::cout << "hint                          - prints the move that the engine would make" << std::endl;
+            std::cout << "multipv                       - prints the best lines for the side to move. Expects the number of lines as argument" << std::endl;
+            std::cout << "ponder                        - toggles thinking on the opponent's time" << std::endl;
+            std::cout << "perft                         - counts the leaves of the move tree, move by move. Expects the depth as argument" << std::endl;
             std::cout <<
                     "undo                          - takes a movement from the stack. Accepts an integer as argument to specify the amount of moves to be taken"
                     << std::endl;
@@ -143,9 +439,9 @@ void Engine::parser() {
                     << std::endl;
             std::cout << "exit (or quit)                - exits the game" << std::endl;
         } else {
-            const auto moves = getLegalMoves();
-            if (std::find(moves.begin(), moves.end(), input) != moves.end()) {
-                makeMove(input, false);
+            // Moves may be given in coordinate or in standard algebraic notation
+            if (const std::string mv = sanToMove(bitboard.getBitBoards(), toMove, input); !mv.empty()) {
+                makeMove(mv, false);
                 printBoard();
             } else {
                 std::cout << "'" << input << "' is not a valid command." << std::endl;
@@ -162,6 +458,9 @@ void Engine::parser() {
             std::cout << std::endl << "Game over! White wins" << std::endl;
             break;
         }
+
+        if (resumePondering && ponder && toMove != pieceColor)
+            startPondering();
     }
 }
 
@@ -174,7 +473,8 @@ bool Engine::isKingInCheck(const enumColor color) const {
                             MoveGenerator::getRookMoves(bitboard.getBitBoards(), opponentColor) |
                             MoveGenerator::getKnightMoves(bitboard.getBitBoards(), opponentColor) |
                             MoveGenerator::getPawnMoves(bitboard.getBitBoards(), opponentColor) |
-                            MoveGenerator::getQueenMoves(bitboard.getBitBoards(), opponentColor);
+                            MoveGenerator::getQueenMoves(bitboard.getBitBoards(), opponentColor) |
+                            MoveGenerator::getKingAttacks(bitboard.getKing(opponentColor));
 
     return (king & underAttack) != 0;
 }
@@ -208,13 +508,14 @@ std::vector<std::string> Engine::getLegalMoves() {
 
 
 /**
- * @brief Moves a piece from a square to another and updates the bitboards, the move history and the capture history when necessary
+ * @brief Moves a piece from a square to another and updates the bitboards, the move history and the capture history
  * @param mv  the move to be made
     * @param verify  whether to verify if the move is legal or not. If set to false, the move will be made regardless of its legality
  * @param verbose  whether to print the move made (in algebraic notation) to stdout. This flag is used so that the engine won't flood stdout with all the moves it has made while searching for
  * the optimal one
  */
-void Engine::makeMove(std::string mv, const bool verify, const bool verbose) {
+void Engine::makeMove(const std::string &mv, const bool verify, const bool verbose) {
+    CHESSQDL_TIME(nMakeMoveTimer);
     bool isLegal = true;
 
     if (verify) {
@@ -227,18 +528,17 @@ void Engine::makeMove(std::string mv, const bool verify, const bool verbose) {
     if (verify & !isLegal)
         std::cout << "Invalid move!" << std::endl;
     else {
-        // Source square
-        const std::string from = mv.substr(0, 2);
-        // Destination square
-        const std::string to = mv.substr(2, 2);
+        const PackedMove packed = packMove(mv);
 
-        // Iterators to the respective square name
-        const auto fromIt = std::find(mapPositions.begin(), mapPositions.end(), from);
-        const auto toIt = std::find(mapPositions.begin(), mapPositions.end(), to);
+        // Index of the source and destination squares
+        const int fromIdx = packed & 0x3f;
+        const int toIdx = (packed >> 6) & 0x3f;
 
-        // Index of the respective square
-        const int fromIdx = static_cast<int>(std::distance(mapPositions.begin(), fromIt));
-        const int toIdx = static_cast<int>(std::distance(mapPositions.begin(), toIt));
+        // The notation depends on the position before the move
+        std::string san;
+
+        if (verbose)
+            san = moveToSan(bitboard.getBitBoards(), toMove, mv);
 
         // Type of the piece that is being moved
         enumPiece pieceType = nPawn;
@@ -251,34 +551,17 @@ void Engine::makeMove(std::string mv, const bool verify, const bool verbose) {
             }
         }
 
-        // Inserts the appropriate character into the algebraic notation string
-        switch (pieceType) {
-            case nKnight:
-                mv.insert(0, "N");
-                break;
-            case nBishop:
-                mv.insert(0, "B");
-                break;
-            case nRook:
-                mv.insert(0, "R");
-                break;
-            case nQueen:
-                mv.insert(0, "Q");
-                break;
-            case nKing:
-                mv.insert(0, "K");
-                break;
-            default:
-                break;
-        }
+        // Type of the captured piece, if any
+        int capturedType = -1;
 
         // If a piece is being captured
         if (bitboard.testBit(otherPlayer, toIdx)) {
             for (int i = nPawn; i <= nKing; i++) {
                 if (U64 aux = bitboard.getPiecesAt(i) & bitboard.getPieces(otherPlayer); aux.test(toIdx)) {
                     bitboard.resetBit(i, toIdx);
-                    captureHistory.push(static_cast<enumColor>(i));
-                    mv.insert(mv.find_first_of("12345678") + 1, "x");
+                    hash ^= Zobrist::getPieceKey(otherPlayer, i, toIdx);
+                    evalState.removePiece(otherPlayer, i, toIdx);
+                    capturedType = i;
                     break;
                 }
             }
@@ -292,123 +575,106 @@ void Engine::makeMove(std::string mv, const bool verify, const bool verbose) {
         bitboard.setBit(pieceType, toIdx);
         bitboard.setBit(toMove, toIdx);
 
-        // If is promotion
-        if (isalpha(mv.back()) && pieceType == nPawn) {
-            // Promote to queen by default
-            enumPiece promoteTo = nQueen;
-
-            if (mv.back() == 'n') promoteTo = nKnight;
-            else if (mv.back() == 'b') promoteTo = nBishop;
-            else if (mv.back() == 'r') promoteTo = nRook;
+        // Piece standing on the destination square after the move
+        enumPiece landingType = pieceType;
 
-            bitboard.setBit(promoteTo, toIdx);
+        // If is promotion
+        if (const int promotion = packed >> 12; promotion != 0 && pieceType == nPawn) {
+            landingType = promotionPieces[promotion];
+            bitboard.setBit(landingType, toIdx);
             bitboard.resetBit(pieceType, toIdx);
         }
 
+        hash ^= Zobrist::getPieceKey(toMove, pieceType, fromIdx) ^ Zobrist::getPieceKey(toMove, landingType, toIdx) ^
+                Zobrist::getSideKey();
+        evalState.removePiece(toMove, pieceType, fromIdx);
+        evalState.addPiece(toMove, landingType, toIdx);
+
 
         // Updates the bitboard that contains info about both players
         bitboard.updateBitboard();
 
-        // Move number after the string when appropriate (if ply is even)
-        if (ply % 2 == 0)
-            mv = std::to_string(ply / 2 + 1) + ". " + mv;
-
-        ++ply;
+        if (network) {
+            accumulators.push_back(accumulators.back());
+            network->update(accumulators.back(), bitboard.getBitBoards(), toMove, pieceType, landingType, fromIdx, toIdx,
+                            capturedType);
+        }
 
         // Updates move history
-        moveHistory.push(mv);
+        moveHistory.push_back(packed);
+        captureHistory.push_back(capturedType);
 
-        toMove = otherPlayer;
+        // Move number before the move when appropriate (if ply is even)
+        if (verbose)
+            std::cout << (ply % 2 == 0 ? std::to_string(ply / 2 + 1) + ". " : "") << san << std::endl;
 
-        if (isKingInCheck(otherPlayer)) mv.append("+");
+        ++ply;
 
-        if (verbose)
-            std::cout << mv << std::endl;
+        toMove = otherPlayer;
     }
 }
 
 // NOLINTEND(misc-no-recursion)
 
 /**
- * @details Removes the latest entry to the move history and updates the bitboards accordingly.
+ * @details Removes the latest entry to the move history and updates the bitboards accordingly. The moving piece is the
+ * one standing on the destination square, or a pawn if the move is a promotion.
  */
 void Engine::takeMove() {
+    CHESSQDL_TIME(nTakeMoveTimer);
     if (!moveHistory.empty()) {
-        std::string lastMove = moveHistory.top();
-        moveHistory.pop();
-
-        if (lastMove.find(' ') != std::string::npos) {
-            lastMove = lastMove.substr(lastMove.find(' ') + 1);
-        }
-
-        enumPiece pieceType = nPawn;
-        bool captured = false;
-
-        // Figures out the piece that was moved
-        if (lastMove.find_first_of("NBRQK") != std::string::npos) {
-            if (lastMove.at(0) == 'N')
-                pieceType = nKnight;
-            else if (lastMove.at(0) == 'B')
-                pieceType = nBishop;
-            else if (lastMove.at(0) == 'R')
-                pieceType = nRook;
-            else if (lastMove.at(0) == 'Q')
-                pieceType = nQueen;
-            else if (lastMove.at(0) == 'K')
-                pieceType = nKing;
-
-            lastMove.erase(0, 1);
-        }
+        const PackedMove lastMove = moveHistory.back();
+        const int capturedType = captureHistory.back();
+        moveHistory.pop_back();
+        captureHistory.pop_back();
 
-        // If a piece was captured, it has to be placed back in the board
-        if (lastMove.find('x') != std::string::npos) {
-            captured = true;
-            lastMove.erase(lastMove.find('x'), 1);
-        }
+        // Indexes of the source and destination squares
+        const int fromIdx = lastMove & 0x3f;
+        const int toIdx = (lastMove >> 6) & 0x3f;
 
-        // Strings with the name of the squares used (source and destination)
-        const std::string from = lastMove.substr(0, 2);
-        const std::string to = lastMove.substr(2, 2);
+        const enumColor hasMoved = toMove == nWhite ? nBlack : nWhite;
 
-        // Iterators of the respective square name
-        const auto fromIt = std::find(mapPositions.begin(), mapPositions.end(), from);
-        const auto toIt = std::find(mapPositions.begin(), mapPositions.end(), to);
+        // Piece standing on the destination square
+        enumPiece landingType = nPawn;
 
-        // Indexes of the respective square name
-        const int fromIdx = static_cast<int>(std::distance(mapPositions.begin(), fromIt));
-        const int toIdx = static_cast<int>(std::distance(mapPositions.begin(), toIt));
+        for (int i = nPawn; i <= nKing; i++) {
+            if (bitboard.testBit(i, toIdx)) {
+                landingType = static_cast<enumPiece>(i);
+                break;
+            }
+        }
 
-        const enumColor hasMoved = toMove == nWhite ? nBlack : nWhite;
+        const enumPiece pieceType = (lastMove >> 12) != 0 ? nPawn : landingType;
 
         // Updates bitboards
-        bitboard.resetBit(pieceType, toIdx);
+        bitboard.resetBit(landingType, toIdx);
         bitboard.resetBit(hasMoved, toIdx);
         bitboard.setBit(pieceType, fromIdx);
         bitboard.setBit(hasMoved, fromIdx);
 
-        // If is promotion
-        if (isalpha(lastMove.back()) && pieceType == nPawn) {
-            // Promote to queen by default
-            enumPiece promoteTo = nQueen;
-
-            if (lastMove.back() == 'n') promoteTo = nKnight;
-            else if (lastMove.back() == 'b') promoteTo = nBishop;
-            else if (lastMove.back() == 'r') promoteTo = nRook;
-
-            bitboard.resetBit(promoteTo, toIdx);
-        }
+        hash ^= Zobrist::getPieceKey(hasMoved, pieceType, fromIdx) ^ Zobrist::getPieceKey(hasMoved, landingType, toIdx) ^
+                Zobrist::getSideKey();
+        evalState.removePiece(hasMoved, landingType, toIdx);
+        evalState.addPiece(hasMoved, pieceType, fromIdx);
 
         // "De-captures" a piece
-        if (captured) {
-            const enumColor capturedPiece = captureHistory.top();
-            captureHistory.pop();
-
+        if (capturedType >= 0) {
             bitboard.setBit(toMove, toIdx);
-            bitboard.setBit(capturedPiece, toIdx);
+            bitboard.setBit(capturedType, toIdx);
+            hash ^= Zobrist::getPieceKey(toMove, capturedType, toIdx);
+            evalState.addPiece(toMove, capturedType, toIdx);
         }
 
         bitboard.updateBitboard();
 
+        if (network) {
+            accumulators.pop_back();
+
+            // Positions played before the network was set have no accumulator until they are reached again
+            if (accumulators.empty())
+                accumulators.push_back(network->refresh(bitboard.getBitBoards()));
+        }
+
         toMove = hasMoved;
 
         --ply;
@@ -417,21 +683,72 @@ void Engine::takeMove() {
 
 
 /**
- * @details Performs a recursive search on the moves tree using the minimax algorithm with alpha-beta pruning and returns the best move it has found
+ * @details Returns Engine::moveHistory
+ */
+const std::vector<PackedMove> &Engine::getMoveHistory() const {
+    return moveHistory;
+}
+
+
+/**
+ * @details The moves are replayed from the starting position, since each one is written from the position before it.
+ */
+std::vector<std::string> Engine::getSanHistory() const {
+    std::vector<std::string> moves;
+    moves.reserve(moveHistory.size());
+
+    BitboardArray board = startBoard;
+    enumColor color = startToMove;
+
+    for (const PackedMove packed: moveHistory) {
+        const std::string mv = unpackMove(packed);
+
+        moves.push_back(moveToSan(board, color, mv));
+        board = MoveGenerator::playMove(board, color, mv);
+        color = color == nWhite ? nBlack : nWhite;
+    }
+
+    return moves;
+}
+
+
+/**
+ * @details Performs an iterative deepening search on the moves tree using the minimax algorithm with alpha-beta pruning
+ * and returns the best move it has found. Each iteration reuses the transposition table entries of the previous ones to
+ * search the most promising moves first. If the search is stopped, the result of the last complete iteration is returned
  */
 std::string Engine::getBestMove(const int depth, const enumColor color) {
+    CHESSQDL_SEARCH_REPORT();
     std::string bestMove;
-    int nodesVisited = 0;
+    long long nodesVisited = 0;
+
+    transpositionTable.newSearch();
+    pawnTable.resetStats();
+    evalCache.resetStats();
 
     auto begin = std::chrono::steady_clock::now();
 
-    alphaBetaMax(intMin, intMax, depth, depth, color, nodesVisited, bestMove);
+    for (int currentDepth = 1; currentDepth <= depth; currentDepth++) {
+        int score;
+        std::string iterationBestMove = searchRoot(currentDepth, color, nodesVisited, score);
+
+        if (stopSearch)
+            break;
+
+        bestMove = iterationBestMove;
+    }
 
     auto end = std::chrono::steady_clock::now();
 
-    if (this->beVerbose) {
+    if (this->beVerbose && !pondering) {
         std::cout << "Best move found: " << bestMove << std::endl;
+        std::cout << "Principal variation:";
+        for (const auto &mv: getPrincipalVariation(depth))
+            std::cout << " " << mv;
+        std::cout << std::endl;
         std::cout << "Nodes visited: " << nodesVisited << std::endl;
+        std::cout << "Pawn hash hit rate: " << static_cast<int>(pawnTable.getHitRate() * 100) << "%" << std::endl;
+        std::cout << "Eval cache hits: " << evalCache.getHits() << " / " << evalCache.getProbes() << std::endl;
         std::cout << "Time taken: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() <<
                 " ms" << std::endl;
     }
@@ -441,6 +758,490 @@ std::string Engine::getBestMove(const int depth, const enumColor color) {
 }
 
 
+/**
+ * @details Same iterative deepening as Engine::getBestMove, bounded by the limits instead of a fixed depth. With a
+ * clock, an iteration is only started while less than the soft limit has been used, and the search is stopped when the
+ * hard limit is reached. The best move of an interrupted iteration is only kept when no iteration was completed. A stop
+ * request is cleared once the search is over
+ */
+std::string Engine::search(const SearchLimits &limits, const std::function<void(const SearchInfo &)> &onIteration) {
+    CHESSQDL_SEARCH_REPORT();
+    const enumColor color = toMove;
+    const auto begin = std::chrono::steady_clock::now();
+
+    std::string bestMove;
+    long long nodesVisited = 0;
+
+    nodeLimit = limits.nodes;
+    softTimeLimit = 0;
+    hardTimeLimit = 0;
+
+    if (limits.moveTime > 0) {
+        softTimeLimit = limits.moveTime;
+        hardTimeLimit = limits.moveTime;
+    } else if (limits.time[color] > 0) {
+        // Spread the remaining time over the moves left, keeping a margin for the communication overhead
+        const long long remaining = limits.time[color];
+        const long long share = remaining / (limits.movesToGo > 0 ? limits.movesToGo : 30) +
+                                limits.increment[color] * 3 / 4;
+
+        hardTimeLimit = std::max(1LL, std::min(share * 3, remaining - 50));
+        softTimeLimit = std::min(share, hardTimeLimit);
+    }
+
+    transpositionTable.newSearch();
+    pawnTable.resetStats();
+    evalCache.resetStats();
+
+    if (!limits.ponder)
+        startClock();
+
+    const int depth = limits.depth > 0 ? limits.depth : maxSearchDepth;
+
+    for (int currentDepth = 1; currentDepth <= depth; currentDepth++) {
+        int score;
+        std::string iterationBestMove = searchRoot(currentDepth, color, nodesVisited, score);
+
+        if (stopSearch) {
+            if (bestMove.empty())
+                bestMove = iterationBestMove;
+            break;
+        }
+
+        bestMove = iterationBestMove;
+
+        if (bestMove.empty())
+            break;
+
+        // The other lines are searched as in Engine::getBestMoves. A line cut short by the limits is left out
+        std::vector<scoreStruct> lines;
+
+        if (limits.multiPv > 1) {
+            lines.push_back({score, bestMove, {}});
+            excludedRootMoves.push_back(bestMove);
+
+            while (static_cast<int>(lines.size()) < limits.multiPv) {
+                int lineScore;
+                const std::string mv = searchRoot(currentDepth, color, nodesVisited, lineScore);
+
+                if (mv.empty() || stopSearch)
+                    break;
+
+                lines.push_back({lineScore, mv, {}});
+                excludedRootMoves.push_back(mv);
+            }
+
+            excludedRootMoves.clear();
+
+            for (auto &line: lines) {
+                makeMove(line.move, false, false);
+                line.pv = getPrincipalVariation(currentDepth - 1);
+                takeMove();
+                line.pv.insert(line.pv.begin(), line.move);
+            }
+        }
+
+        if (onIteration) {
+            const long long time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - begin).count();
+            onIteration({currentDepth, score, nodesVisited, time, transpositionTable.hashfull(),
+                         getPrincipalVariation(currentDepth), lines});
+        }
+
+        if (stopSearch)
+            break;
+
+        if (clockRunning && softTimeLimit > 0 && getClockTime() >= softTimeLimit)
+            break;
+    }
+
+    clockRunning = false;
+    nodeLimit = 0;
+    stopSearch = false;
+
+    return bestMove;
+}
+
+
+/**
+ * @details The start time is stored as a tick count so that it can be read by the search while another thread sets it
+ */
+void Engine::startClock() {
+    clockStart = std::chrono::steady_clock::now().time_since_epoch().count();
+    clockRunning = true;
+}
+
+
+/**
+ * @details Sets Engine::stopSearch
+ */
+void Engine::stop() {
+    stopSearch = true;
+}
+
+
+long long Engine::getClockTime() const {
+    const std::chrono::steady_clock::duration elapsed =
+            std::chrono::steady_clock::now().time_since_epoch() - std::chrono::steady_clock::duration(clockStart);
+    return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+}
+
+
+/**
+ * @details The node budget is checked at every node, the clock only every 1024 nodes
+ */
+void Engine::checkLimits(const long long nodesVisited) {
+    if (nodeLimit > 0 && nodesVisited >= nodeLimit)
+        stopSearch = true;
+    else if (clockRunning && hardTimeLimit > 0 && (nodesVisited & 1023) == 0 && getClockTime() >= hardTimeLimit)
+        stopSearch = true;
+}
+
+
+/**
+ * @details Each depth is searched once per line, skipping the root moves of the lines already found at that depth. All
+ * passes share the transposition table, so every pass after the first mostly walks subtrees that are already stored,
+ * which makes the whole search much cheaper than \p count independent searches
+ */
+std::vector<scoreStruct> Engine::getBestMoves(const int depth, const enumColor color, const int count) {
+    CHESSQDL_SEARCH_REPORT();
+    std::vector<scoreStruct> lines;
+    long long nodesVisited = 0;
+
+    transpositionTable.newSearch();
+    evalCache.resetStats();
+
+    auto begin = std::chrono::steady_clock::now();
+
+    for (int currentDepth = 1; currentDepth <= depth; currentDepth++) {
+        std::vector<scoreStruct> iterationLines;
+
+        for (int i = 0; i < count; i++) {
+            int score;
+            const std::string mv = searchRoot(currentDepth, color, nodesVisited, score);
+
+            if (mv.empty() || stopSearch)
+                break;
+
+            iterationLines.push_back({score, mv, {}});
+            excludedRootMoves.push_back(mv);
+        }
+
+        excludedRootMoves.clear();
+
+        if (stopSearch)
+            break;
+
+        lines = iterationLines;
+    }
+
+    for (auto &line: lines) {
+        makeMove(line.move, false, false);
+        line.pv = getPrincipalVariation(depth - 1);
+        takeMove();
+        line.pv.insert(line.pv.begin(), line.move);
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    if (this->beVerbose && !pondering) {
+        std::cout << "Nodes visited: " << nodesVisited << std::endl;
+        std::cout << "Eval cache hits: " << evalCache.getHits() << " / " << evalCache.getProbes() << std::endl;
+        std::cout << "Time taken: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() <<
+                " ms" << std::endl;
+    }
+
+    return lines;
+}
+
+
+/**
+ * @details The root node is searched with an infinite window. Only its legal moves are searched, since the pseudo-legal
+ * search would otherwise pick a move that leaves the king in check when every move loses it
+ */
+std::string Engine::searchRoot(const int depth, const enumColor color, long long &nodesVisited, int &score) {
+    std::string bestMove;
+
+    rootMoves = MoveGenerator::getLegalMoves(bitboard.getBitBoards(), color);
+
+    // Lines already found by a multi-PV search are not searched again
+    rootMoves.erase(std::remove_if(rootMoves.begin(), rootMoves.end(), [this](const std::string &mv) {
+        return std::find(excludedRootMoves.begin(), excludedRootMoves.end(), mv) != excludedRootMoves.end();
+    }), rootMoves.end());
+
+    score = alphaBetaMax(intMin, intMax, depth, depth, color, nodesVisited, bestMove);
+
+    return bestMove;
+}
+
+
+/**
+ * @details Moves are validated against the pseudo-legal moves of each position, so a corrupted or colliding entry ends
+ * the variation instead of producing an impossible move
+ */
+std::vector<std::string> Engine::getPrincipalVariation(const int length) {
+    std::vector<std::string> pv;
+    TTEntry entry{};
+
+    while (static_cast<int>(pv.size()) < length && transpositionTable.probe(hash, entry) && entry.move != nullMove) {
+        const std::string mv = unpackMove(entry.move);
+        const auto moves = MoveGenerator::getPseudoLegalMoves(bitboard.getBitBoards(), toMove);
+
+        if (std::find(moves.begin(), moves.end(), mv) == moves.end())
+            break;
+
+        makeMove(mv, false, false);
+        pv.push_back(mv);
+    }
+
+    for (size_t i = 0; i < pv.size(); i++)
+        takeMove();
+
+    return pv;
+}
+
+
+/**
+ * @details Builds with CHESSQDL_CHECK_EVAL defined (Debug builds) verify the incremental state against a full recompute.
+ * Evaluations from the perspective of the side to move are cached, since the hash only tells positions apart by the
+ * side to move. Endgames with a specialized evaluator bypass the network
+ */
+int Engine::evaluate(const enumColor color) const {
+    CHESSQDL_TIME(nEvalTimer);
+    CHESSQDL_COUNT(nEvalCounter);
+#ifdef CHESSQDL_CHECK_EVAL
+    assert(evalState == computeEvalState(bitboard.getBitBoards(), *pieceSquareTables));
+    assert(!network || accumulators.back() == network->refresh(bitboard.getBitBoards()));
+#endif
+
+    const bool cacheable = color == toMove;
+    int score;
+
+    if (cacheable && evalCache.probe(hash, score))
+        return score;
+
+    if (network) {
+        if (!evaluateEndgame(bitboard.getBitBoards(), evalState.materialKey, color, score))
+            score = network->evaluate(accumulators.back(), color);
+    } else
+        score = evaluateBoard(bitboard.getBitBoards(), evalState, color, &pawnTable);
+
+    if (cacheable)
+        evalCache.store(hash, score);
+
+    return score;
+}
+
+
+/**
+ * @details Only king and pawn against king is covered for now. Positions the pseudo-legal search reaches by leaving a
+ * king in check are invalid in the bitbase, so they are searched on until the king is taken instead of scored as draws
+ */
+bool Engine::isBitbaseDraw() const {
+    static const uint64_t whitePawn = materialKeyFromCode("KPK");
+    static const uint64_t blackPawn = materialKeyFromCode("KKP");
+
+    return (evalState.materialKey == whitePawn || evalState.materialKey == blackPawn) &&
+           probeKPK(bitboard.getBitBoards(), toMove) == nBitbaseDraw;
+}
+
+
+/**
+ * @details Entries are stored from the perspective of the side to move, while both alphaBetaMax and alphaBetaMin work
+ * with scores from the perspective of the maximizing side. In alphaBetaMin the score is negated and the bound flipped.
+ * Scores are clamped to [alpha, beta] to keep the fail-hard behaviour of the search
+ */
+bool Engine::probeTable(const int alpha, const int beta, const int depthLeft, const bool maximizing, int &score,
+                        PackedMove &move) const {
+    TTEntry entry{};
+
+    CHESSQDL_COUNT(nTTProbeCounter);
+
+    if (!transpositionTable.probe(hash, entry))
+        return false;
+
+    CHESSQDL_COUNT(nTTHitCounter);
+    move = entry.move;
+
+    if (entry.depth < depthLeft)
+        return false;
+
+    const int value = maximizing ? entry.score : -entry.score;
+    auto bound = static_cast<enumBound>(entry.bound);
+
+    if (!maximizing && bound != nExact)
+        bound = bound == nLowerBound ? nUpperBound : nLowerBound;
+
+    if (bound == nExact) {
+        score = std::clamp(value, alpha, beta);
+        return true;
+    }
+    if (bound == nLowerBound && value >= beta) {
+        score = beta;
+        return true;
+    }
+    if (bound == nUpperBound && value <= alpha) {
+        score = alpha;
+        return true;
+    }
+
+    return false;
+}
+
+
+/**
+ * @details Results of aborted searches are not stored. Neither are infinite scores, which only carry the initial bounds
+ * of the search
+ */
+void Engine::storeTable(const int alpha, const int beta, int score, const int depthLeft, const bool maximizing,
+                        const PackedMove move) {
+    if (stopSearch || score == intMin || score == intMax)
+        return;
+
+    enumBound bound = nExact;
+
+    if (score <= alpha)
+        bound = nUpperBound;
+    else if (score >= beta)
+        bound = nLowerBound;
+
+    if (!maximizing) {
+        score = -score;
+        if (bound != nExact)
+            bound = bound == nLowerBound ? nUpperBound : nLowerBound;
+    }
+
+    transpositionTable.store(hash, depthLeft, score, bound, move);
+}
+
+
+/**
+ * @details Captures are ranked by their static exchange evaluation. The sort is stable, so quiet moves keep their
+ * (shuffled) order
+ */
+void Engine::orderMoves(std::vector<std::string> &moves, const PackedMove ttMove) const {
+    const BitboardArray board = bitboard.getBitBoards();
+    const std::string ttMoveName = ttMove == nullMove ? "" : unpackMove(ttMove);
+
+    std::vector<std::pair<int, std::string>> keyed;
+    keyed.reserve(moves.size());
+
+    for (auto &mv: moves) {
+        int key = 0;
+
+        if (mv == ttMoveName)
+            key = intMax;
+        else if (isTactical(mv)) {
+            const int exchange = see(board, mv);
+            key = exchange >= 0 ? captureOrderingOffset + exchange : exchange - captureOrderingOffset;
+        }
+
+        keyed.emplace_back(key, std::move(mv));
+    }
+
+    std::stable_sort(keyed.begin(), keyed.end(), [](const auto &a, const auto &b) {
+        return a.first > b.first;
+    });
+
+    for (size_t i = 0; i < moves.size(); i++)
+        moves[i] = std::move(keyed[i].second);
+}
+
+
+/**
+ * @details The destination square is decoded from the packed representation of the move
+ */
+bool Engine::isTactical(const std::string &mv) const {
+    const enumColor otherPlayer = toMove == nWhite ? nBlack : nWhite;
+
+    return bitboard.testBit(otherPlayer, (packMove(mv) >> 6) & 0x3f) || (mv.size() > 4 && mv.back() == 'q');
+}
+
+
+/**
+ * @details Captures that lose material according to the static exchange evaluation are left out, since they are very
+ * unlikely to raise the score above the static evaluation
+ */
+std::vector<std::string> Engine::getQuiescenceMoves(const enumColor color) const {
+    const BitboardArray board = bitboard.getBitBoards();
+    std::vector<std::pair<int, std::string>> keyed;
+
+    for (auto &mv: MoveGenerator::getPseudoLegalMoves(board, color)) {
+        if (!isTactical(mv) || !seeGe(board, mv, 0))
+            continue;
+
+        keyed.emplace_back(see(board, mv), std::move(mv));
+    }
+
+    std::stable_sort(keyed.begin(), keyed.end(), [](const auto &a, const auto &b) {
+        return a.first > b.first;
+    });
+
+    std::vector<std::string> moves;
+    moves.reserve(keyed.size());
+
+    for (auto &[score, mv]: keyed)
+        moves.push_back(std::move(mv));
+
+    return moves;
+}
+
+
+/**
+ * @details The expected reply is the first move of the principal variation from the current position. The search runs
+ * on this very engine, so the board must not be touched by any other thread until stopPondering is called
+ */
+void Engine::startPondering() {
+    const auto pv = getPrincipalVariation(1);
+
+    if (pv.empty())
+        return;
+
+    if (const auto legalMoves = getLegalMoves();
+        std::find(legalMoves.begin(), legalMoves.end(), pv.front()) == legalMoves.end())
+        return;
+
+    ponderMove = pv.front();
+    ponderResult.clear();
+    ponderBoard = bitboard.getBitBoards();
+    pondering = true;
+
+    ponderThread = std::thread([this] {
+        makeMove(ponderMove, false, false);
+        ponderHash = hash;
+        ponderResult = getBestMove(depthLevel, pieceColor);
+    });
+}
+
+
+/**
+ * @details On a ponder hit the search is left running until it completes, so its result can be played right away. On a
+ * miss, or when the search is only interrupted, it is aborted. Either way the speculative move is taken back, while the
+ * transposition table keeps everything that was learned
+ */
+void Engine::stopPondering(const std::string &reply) {
+    if (!ponderThread.joinable())
+        return;
+
+    const bool ponderHit = reply == ponderMove;
+
+    if (!ponderHit)
+        stopSearch = true;
+
+    ponderThread.join();
+
+    stopSearch = false;
+    pondering = false;
+
+    takeMove();
+
+    if (!ponderHit)
+        ponderResult.clear();
+    else if (this->beVerbose)
+        std::cout << "Ponder hit" << std::endl;
+}
+
+
 /**
  * @details Minimax implementation
  * @ref https://en.wikipedia.org/wiki/Minimax <br>
@@ -448,32 +1249,76 @@ std::string Engine::getBestMove(const int depth, const enumColor color) {
  */
 // NOLINTBEGIN(misc-no-recursion)
 int Engine::alphaBetaMax(int alpha, const int beta, const int depth, const int depthLeft, const enumColor color,
-                         int &nodesVisited, std::string &bestMove) {
+                         long long &nodesVisited, std::string &bestMove) {
     if (depthLeft == 0)
-        return evaluateBoard(bitboard.getBitBoards(), color);
+        return quiescenceMax(alpha, beta, color, nodesVisited);
 
-    auto allMoves = MoveGenerator::getPseudoLegalMoves(bitboard.getBitBoards(), color);
+    checkLimits(nodesVisited);
+    CHESSQDL_COUNT(nNodeCounter);
+
+    if (stopSearch)
+        return alpha;
+
+    const int alphaOrig = alpha;
+    PackedMove ttMove = nullMove;
+
+    // The root is always searched so that a best move is found
+    if (int ttScore; probeTable(alpha, beta, depthLeft, true, ttScore, ttMove) && depth != depthLeft)
+        return ttScore;
+
+    // Bitbase draws are exact, there is nothing left to search
+    if (depth != depthLeft && isBitbaseDraw())
+        return std::clamp(0, alpha, beta);
+
+    auto allMoves = depth == depthLeft ? rootMoves : MoveGenerator::getPseudoLegalMoves(bitboard.getBitBoards(), color);
 
-    std::shuffle(std::begin(allMoves), std::end(allMoves), generator);
+    if (shuffleMoves)
+        std::shuffle(std::begin(allMoves), std::end(allMoves), generator);
+
+    orderMoves(allMoves, ttMove);
 
     const enumColor enemyColor = (color == nWhite) ? nBlack : nWhite;
+    PackedMove nodeBestMove = nullMove;
+
+    // Close to the leaves, quiet moves that hang material are not worth searching
+    const bool pruneQuietMoves = depth != depthLeft && depthLeft <= quietPruningDepth && !isKingInCheck(color);
+    const BitboardArray board = bitboard.getBitBoards();
 
     for (const auto &currentMove: allMoves) {
+        if (pruneQuietMoves && !isTactical(currentMove) &&
+            !seeGe(board, currentMove, -quietPruningMargin * depthLeft))
+            continue;
+
         nodesVisited++;
 
         makeMove(currentMove, false, false);
         const int score = alphaBetaMin(alpha, beta, depth, depthLeft - 1, enemyColor, nodesVisited, bestMove);
         takeMove();
 
-        if (score >= beta)
+        if (stopSearch)
+            return alpha;
+
+        if (score >= beta) {
+            CHESSQDL_COUNT(nCutoffCounter);
+            CHESSQDL_COUNT_IF(nFirstMoveCutoffCounter, &currentMove == &allMoves.front());
+
+            if (depth != depthLeft || excludedRootMoves.empty())
+                storeTable(alphaOrig, beta, beta, depthLeft, true, packMove(currentMove));
             return beta;
+        }
         if (score > alpha) {
             alpha = score;
+            nodeBestMove = packMove(currentMove);
             if (depth == depthLeft)
                 bestMove = currentMove;
             //std::cout << "New move found for depth " << depth << " " << currentMove << " score: " << score << std::endl;
         }
     }
+
+    // A root searched without some of its moves does not have its real score
+    if (depth != depthLeft || excludedRootMoves.empty())
+        storeTable(alphaOrig, beta, alpha, depthLeft, true, nodeBestMove);
+
     return alpha;
 }
 
@@ -487,30 +1332,158 @@ int Engine::alphaBetaMax(int alpha, const int beta, const int depth, const int d
  */
 // NOLINTBEGIN(misc-no-recursion)
 int Engine::alphaBetaMin(const int alpha, int beta, const int depth, const int depthLeft, enumColor color,
-                         int &nodesVisited, std::string &bestMove) {
+                         long long &nodesVisited, std::string &bestMove) {
     if (depthLeft == 0)
-        return -evaluateBoard(bitboard.getBitBoards(), color);
+        return quiescenceMin(alpha, beta, color, nodesVisited);
+
+    checkLimits(nodesVisited);
+    CHESSQDL_COUNT(nNodeCounter);
+
+    if (stopSearch)
+        return beta;
+
+    const int betaOrig = beta;
+    PackedMove ttMove = nullMove;
+
+    if (int ttScore; probeTable(alpha, beta, depthLeft, false, ttScore, ttMove))
+        return ttScore;
+
+    // Bitbase draws are exact, there is nothing left to search
+    if (depth != depthLeft && isBitbaseDraw())
+        return std::clamp(0, alpha, beta);
 
     auto allMoves = MoveGenerator::getPseudoLegalMoves(bitboard.getBitBoards(), color);
 
-    std::shuffle(std::begin(allMoves), std::end(allMoves), generator);
+    if (shuffleMoves)
+        std::shuffle(std::begin(allMoves), std::end(allMoves), generator);
+
+    orderMoves(allMoves, ttMove);
 
     const enumColor enemyColor = (color == nWhite) ? nBlack : nWhite;
+    PackedMove nodeBestMove = nullMove;
+
+    // Close to the leaves, quiet moves that hang material are not worth searching
+    const bool pruneQuietMoves = depthLeft <= quietPruningDepth && !isKingInCheck(color);
+    const BitboardArray board = bitboard.getBitBoards();
 
     for (auto &currentMove: allMoves) {
+        if (pruneQuietMoves && !isTactical(currentMove) &&
+            !seeGe(board, currentMove, -quietPruningMargin * depthLeft))
+            continue;
+
         nodesVisited++;
 
         makeMove(currentMove, false, false);
         const int score = alphaBetaMax(alpha, beta, depth, depthLeft - 1, enemyColor, nodesVisited, bestMove);
         takeMove();
 
-        if (score <= alpha)
+        if (stopSearch)
+            return beta;
+
+        if (score <= alpha) {
+            CHESSQDL_COUNT(nCutoffCounter);
+            CHESSQDL_COUNT_IF(nFirstMoveCutoffCounter, &currentMove == &allMoves.front());
+
+            storeTable(alpha, betaOrig, alpha, depthLeft, false, packMove(currentMove));
             return alpha;
+        }
         if (score < beta) {
             beta = score;
+            nodeBestMove = packMove(currentMove);
             //std::cout << "New move found for depth " << depth << " " << currentMove << " score: " << score << std::endl;
         }
     }
+
+    storeTable(alpha, betaOrig, beta, depthLeft, false, nodeBestMove);
+
+    return beta;
+}
+
+// NOLINTEND(misc-no-recursion)
+
+
+/**
+ * @details Quiescence search. The side to move may either accept the static evaluation (stand pat) or try to improve it
+ * with a capture
+ * @ref https://www.chessprogramming.org/Quiescence_Search
+ */
+// NOLINTBEGIN(misc-no-recursion)
+int Engine::quiescenceMax(int alpha, const int beta, const enumColor color, long long &nodesVisited) {
+    checkLimits(nodesVisited);
+    CHESSQDL_COUNT(nQNodeCounter);
+
+    const int standPat = evaluate(color);
+
+    if (standPat >= beta)
+        return beta;
+    if (standPat > alpha)
+        alpha = standPat;
+
+    if (stopSearch)
+        return alpha;
+
+    const enumColor enemyColor = (color == nWhite) ? nBlack : nWhite;
+
+    for (const auto &currentMove: getQuiescenceMoves(color)) {
+        nodesVisited++;
+
+        makeMove(currentMove, false, false);
+        const int score = quiescenceMin(alpha, beta, enemyColor, nodesVisited);
+        takeMove();
+
+        if (stopSearch)
+            return alpha;
+
+        if (score >= beta)
+            return beta;
+        if (score > alpha)
+            alpha = score;
+    }
+
+    return alpha;
+}
+
+// NOLINTEND(misc-no-recursion)
+
+
+/**
+ * @details Quiescence search. The side to move may either accept the static evaluation (stand pat) or try to improve it
+ * with a capture
+ * @ref https://www.chessprogramming.org/Quiescence_Search
+ */
+// NOLINTBEGIN(misc-no-recursion)
+int Engine::quiescenceMin(const int alpha, int beta, const enumColor color, long long &nodesVisited) {
+    checkLimits(nodesVisited);
+    CHESSQDL_COUNT(nQNodeCounter);
+
+    const int standPat = -evaluate(color);
+
+    if (standPat <= alpha)
+        return alpha;
+    if (standPat < beta)
+        beta = standPat;
+
+    if (stopSearch)
+        return beta;
+
+    const enumColor enemyColor = (color == nWhite) ? nBlack : nWhite;
+
+    for (const auto &currentMove: getQuiescenceMoves(color)) {
+        nodesVisited++;
+
+        makeMove(currentMove, false, false);
+        const int score = quiescenceMax(alpha, beta, enemyColor, nodesVisited);
+        takeMove();
+
+        if (stopSearch)
+            return beta;
+
+        if (score <= alpha)
+            return alpha;
+        if (score < beta)
+            beta = score;
+    }
+
     return beta;
 }
 
@@ -2,12 +2,94 @@
 #define CHESSQDL_ENGINE_HPP
 
 #include "bitboard.hpp"
+#include "evalcache.hpp"
+#include "transposition.hpp"
+#include "evaluation.hpp"
+#include "nnue.hpp"
+#include "utils.hpp"
 
-#include <stack>
 #include <random>
 #include <optional>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <array>
+#include <functional>
+#include <iostream>
 
 namespace chessqdl {
+
+    /**
+     * @brief Depth searched when a search is only bounded by time, nodes or a stop request
+     */
+    constexpr int maxSearchDepth = 64;
+
+
+    /**
+     * @brief Limits of a search started with Engine::search. A zero means that the corresponding limit is not set
+     */
+    struct SearchLimits {
+        /**
+         * @brief Maximum depth of the iterative deepening
+         */
+        int depth = 0;
+
+        /**
+         * @brief Maximum number of nodes
+         */
+        long long nodes = 0;
+
+        /**
+         * @brief Exact time to spend on the search, in milliseconds
+         */
+        long long moveTime = 0;
+
+        /**
+         * @brief Time left on the clock of each color (indexed by nWhite and nBlack), in milliseconds
+         */
+        std::array<long long, 2> time = {0, 0};
+
+        /**
+         * @brief Increment per move of each color (indexed by nWhite and nBlack), in milliseconds
+         */
+        std::array<long long, 2> increment = {0, 0};
+
+        /**
+         * @brief Moves left until the next time control
+         */
+        int movesToGo = 0;
+
+        /**
+         * @brief When set, the clock only starts once Engine::startClock is called
+         */
+        bool ponder = false;
+
+        /**
+         * @brief Number of best lines searched at every depth. The lines are reported in SearchInfo::lines when more
+         * than one is asked
+         */
+        int multiPv = 1;
+    };
+
+
+    /**
+     * @brief Progress of a search, reported after every completed iteration
+     */
+    struct SearchInfo {
+        int depth;
+        int score;
+        long long nodes;
+        long long time;
+        int hashfull;
+        std::vector<std::string> pv;
+
+        /**
+         * @brief Best lines of the iteration, from best to worst, when SearchLimits::multiPv is greater than 1
+         */
+        std::vector<scoreStruct> lines;
+    };
+
+
     class Engine {
     private:
         /**
@@ -26,14 +108,20 @@ namespace chessqdl {
         enumColor pieceColor;
 
         /**
-         * @brief Stack with moves history. Used to undo moves
+         * @brief Moves played since the starting position, oldest first. Used to undo moves and to write the game
+         */
+        std::vector<PackedMove> moveHistory;
+
+        /**
+         * @brief Type of the piece captured by each move of Engine::moveHistory, or -1 if the move is not a capture
          */
-        std::stack<std::string> moveHistory;
+        std::vector<int> captureHistory;
 
         /**
-         * @brief Stack with capture history. Used to undo captures
+         * @brief Position the move history starts from, and its side to move
          */
-        std::stack<enumColor> captureHistory;
+        BitboardArray startBoard;
+        enumColor startToMove = nWhite;
 
         /**
          * @brief Ply counter. The counter is incremented after every valid move made and decremented after each undo
@@ -61,17 +149,134 @@ namespace chessqdl {
         std::default_random_engine generator;
 
         /**
-         * @brief Prints the current state of the board to stdout. A terminal with Unicode support is recommended since the pieces are represented by Unicode symbols
+         * @brief When set to false, moves are searched in generation order before being sorted, instead of being shuffled
+         * with Engine::generator
          */
-        void printBoard() const;
+        bool shuffleMoves = true;
 
+        /**
+         * @brief Zobrist hash of the current position. Updated incrementally by makeMove and takeMove
+         */
+        uint64_t hash = 0;
 
         /**
-         * @brief Checks if the king of the given color is in check
-         * @param color  color of the king to be checked
-         * @return  true if the king is in check, false otherwise
+         * @brief Piece-square tables of the handcrafted evaluation. Never modified once set, so that engines on other
+         * threads can share them
          */
-        [[nodiscard]] bool isKingInCheck(enumColor color) const;
+        std::shared_ptr<const PieceSquareTables> pieceSquareTables = getSharedDefaultPieceSquareTables();
+
+        /**
+         * @brief Evaluation terms of the current position. Updated incrementally by makeMove and takeMove
+         */
+        EvalState evalState;
+
+        /**
+         * @brief Static evaluations of previously visited positions. Mutable because it is only a cache
+         */
+        mutable EvalCache evalCache;
+
+        /**
+         * @brief Neural network used by the evaluation instead of evaluateBoard. Null while no network is loaded
+         */
+        std::shared_ptr<const NnueNetwork> network;
+
+        /**
+         * @brief Accumulators of every position of the move history, the current position last. Only kept while a
+         * network is loaded
+         */
+        std::vector<NnueAccumulator> accumulators;
+
+        /**
+         * @brief Results of previous searches. Kept between searches so that later searches can reuse them
+         */
+        TranspositionTable transpositionTable;
+
+        /**
+         * @brief Pawn structure evaluations. Mutable because it is only a cache used by the evaluation
+         */
+        mutable PawnHashTable pawnTable;
+
+        /**
+         * @brief When set, the search unwinds as soon as possible and the result of the unfinished iteration is discarded
+         */
+        std::atomic<bool> stopSearch = false;
+
+        /**
+         * @brief When set to true the engine searches the expected reply while waiting for the opponent's move
+         */
+        bool ponder = false;
+
+        /**
+         * @brief True while a ponder search is running on ponderThread
+         */
+        bool pondering = false;
+
+        /**
+         * @brief Thread running the ponder search
+         */
+        std::thread ponderThread;
+
+        /**
+         * @brief Move the engine expects the opponent to play. Taken from the principal variation of the last search
+         */
+        std::string ponderMove;
+
+        /**
+         * @brief Best move found by the ponder search, reused when the opponent plays Engine::ponderMove
+         */
+        std::string ponderResult;
+
+        /**
+         * @brief Hash of the position the ponder search was run on
+         */
+        uint64_t ponderHash = 0;
+
+        /**
+         * @brief Position the ponder search was started from, with the opponent to move. The board itself belongs to
+         * the ponder thread until the search is stopped, so the opponent's input is read on this copy
+         */
+        BitboardArray ponderBoard;
+
+        /**
+         * @brief Node budget of the running search. Zero if unlimited
+         */
+        long long nodeLimit = 0;
+
+        /**
+         * @brief Time after which no new iteration is started, in milliseconds. Zero if unlimited
+         */
+        long long softTimeLimit = 0;
+
+        /**
+         * @brief Time after which the running search is stopped, in milliseconds. Zero if unlimited
+         */
+        long long hardTimeLimit = 0;
+
+        /**
+         * @brief True while the time limits of the running search apply. Ponder searches only start their clock on a
+         * ponder hit
+         */
+        std::atomic<bool> clockRunning = false;
+
+        /**
+         * @brief Time at which the clock of the running search was started, in steady clock ticks
+         */
+        std::atomic<long long> clockStart = 0;
+
+        /**
+         * @brief Root moves that are skipped by the search. Used by multi-PV searches to find the next best line
+         */
+        std::vector<std::string> excludedRootMoves;
+
+        /**
+         * @brief Legal root moves of the current iteration, minus the excluded ones. Filled by Engine::searchRoot
+         */
+        std::vector<std::string> rootMoves;
+
+        /**
+         * @brief Prints the current state of the board to stdout. A terminal with Unicode support is recommended since the pieces are represented by Unicode symbols
+         */
+        void printBoard() const;
 
 
         /**
@@ -80,6 +285,110 @@ namespace chessqdl {
          */
         std::vector<std::string> getLegalMoves();
 
+
+        /**
+         * @brief Evaluates the current position using the incrementally updated evaluation state
+         * @param color  perspective of the evaluation
+         * @return Score of the board from the perspective of \p color
+         */
+        [[nodiscard]] int evaluate(enumColor color) const;
+
+
+        /**
+         * @brief Looks up the current position in the transposition table
+         * @param alpha  current alpha bound
+         * @param beta  current beta bound
+         * @param depthLeft  remaining depth of the search
+         * @param maximizing  true if called from alphaBetaMax, false if called from alphaBetaMin
+         * @param score  filled with the score to return if the stored entry is enough to cut the search
+         * @param move  filled with the stored best move, if any
+         * @return true if the node can be cut off with \p score, false otherwise
+         */
+        bool probeTable(int alpha, int beta, int depthLeft, bool maximizing, int &score, PackedMove &move) const;
+
+
+        /**
+         * @brief Checks whether the current position is a draw according to the bitbases
+         * @return True if the position is a legal king and pawn against king ending that cannot be won
+         */
+        [[nodiscard]] bool isBitbaseDraw() const;
+
+
+        /**
+         * @brief Stores the result of a node in the transposition table
+         * @param alpha  alpha bound the node was searched with
+         * @param beta  beta bound the node was searched with
+         * @param score  score returned by the node
+         * @param depthLeft  remaining depth of the search
+         * @param maximizing  true if called from alphaBetaMax, false if called from alphaBetaMin
+         * @param move  best move of the node (nullMove if none)
+         */
+        void storeTable(int alpha, int beta, int score, int depthLeft, bool maximizing, PackedMove move);
+
+
+        /**
+         * @brief Orders moves so that the most promising ones are searched first: the transposition table move, then
+         * captures that do not lose material (best exchange first), then quiet moves and finally losing captures
+         * @param moves  list of moves to be ordered
+         * @param ttMove  move stored in the transposition table for the current position
+         */
+        void orderMoves(std::vector<std::string> &moves, PackedMove ttMove) const;
+
+
+        /**
+         * @brief Checks whether a move captures a piece or promotes a pawn to a queen
+         * @param mv  move to be checked
+         * @return true if \p mv is a capture or a queen promotion, false otherwise
+         */
+        [[nodiscard]] bool isTactical(const std::string &mv) const;
+
+
+        /**
+         * @brief Get the moves searched by the quiescence search: captures and queen promotions that do not lose material
+         * @param color  color of the moving pieces
+         * @return a list of moves, ordered from the best to the worst exchange
+         */
+        std::vector<std::string> getQuiescenceMoves(enumColor color) const;
+
+
+        /**
+         * @brief Runs a single iteration of the search from the root
+         * @param depth  depth of the iteration
+         * @param color  color of the pieces for which to find the best move
+         * @param nodesVisited  quantity of nodes visited, accumulated over iterations
+         * @param score  filled with the score of the best move
+         * @return the best legal move of the iteration, or an empty string if there are no legal moves or the search was
+         * stopped
+         */
+        std::string searchRoot(int depth, enumColor color, long long &nodesVisited, int &score);
+
+
+        /**
+         * @brief Stops the search once its node or time budget is spent. Called on entry to every node
+         * @param nodesVisited  quantity of nodes visited so far
+         */
+        void checkLimits(long long nodesVisited);
+
+
+        /**
+         * @brief Get method that returns the time elapsed since Engine::startClock was called
+         * @return elapsed time in milliseconds
+         */
+        [[nodiscard]] long long getClockTime() const;
+
+
+        /**
+         * @brief Starts searching, in the background, the position after the opponent's expected reply
+         */
+        void startPondering();
+
+
+        /**
+         * @brief Ends the ponder search. On a ponder hit the search is allowed to finish and its result is kept, otherwise it is aborted
+         * @param reply  move played by the opponent, in coordinate notation. Empty when the search is only interrupted
+         */
+        void stopPondering(const std::string &reply);
+
     public:
         /**
          * @brief Overloaded constructor. Allows the selection of the engine's pieces.
@@ -104,19 +413,50 @@ namespace chessqdl {
         Engine(const std::string &fen, enumColor color, int depth, bool v, bool p, std::optional<int> seed);
 
 
+        /**
+         * @brief Destructor. Stops any search still running in the background
+         */
+        ~Engine();
+
+
         /**
          * @brief Player input parser. Acts as an interface to the engine
          */
         void parser();
 
 
+        /**
+         * @brief Speaks the Universal Chess Interface protocol until "quit" is received or the input ends. Searches
+         * run on a thread of their own, so commands such as "stop" are handled while searching
+         * @param input  stream the GUI commands are read from
+         * @param output  stream the engine's replies are written to
+         */
+        void uci(std::istream &input = std::cin, std::ostream &output = std::cout);
+
+
+        /**
+         * @brief Replaces the current game with the position described by a FEN string. The move history is cleared
+         * @param fen  valid fen string that represents a chess game
+         */
+        void setPosition(const std::string &fen);
+
+
+        /**
+         * @brief Replaces the current game with the position described by a set of bitboards. The move history is
+         * cleared
+         * @param board  bitboards of the position, consistent with each other
+         * @param color  side to move
+         */
+        void setPosition(const BitboardArray &board, enumColor color);
+
+
         /**
          * @brief Effectively makes a move (only if \p mv represents a valid move), updates the bitboards and prints to stdout the move made (if \p verbose)
          * @param mv  string with move to be made
          * @param verify  if set to true, the move will only be made if it is a valid move. Defaults to true
          * @param verbose  sets whether the movement made should be printed to stdout. Defaults to true
          */
-        void makeMove(std::string mv, bool verify = true, bool verbose = true);
+        void makeMove(const std::string &mv, bool verify = true, bool verbose = true);
 
 
         /**
@@ -125,6 +465,20 @@ namespace chessqdl {
         void takeMove();
 
 
+        /**
+         * @brief Get method that returns the moves played since the starting position
+         * @return the value of Engine::moveHistory
+         */
+        [[nodiscard]] const std::vector<PackedMove> &getMoveHistory() const;
+
+
+        /**
+         * @brief Writes the moves played since the starting position in standard algebraic notation
+         * @return The moves, oldest first (e.g. {"e4", "e5", "Nf3"})
+         */
+        [[nodiscard]] std::vector<std::string> getSanHistory() const;
+
+
         /**
          * @brief Get method that returns the color of the player to make a move
          * @return the value of Engine::toMove
@@ -132,6 +486,14 @@ namespace chessqdl {
         [[nodiscard]] enumColor getToMove() const;
 
 
+        /**
+         * @brief Checks if the king of the given color is in check
+         * @param color  color of the king to be checked
+         * @return  true if the king is in check, false otherwise
+         */
+        [[nodiscard]] bool isKingInCheck(enumColor color) const;
+
+
         /**
          * @brief Maximum depth allowed for tree traversal when searching for moves
          * @param n  maximum depth
@@ -139,6 +501,130 @@ namespace chessqdl {
         void setDepth(int n);
 
 
+        /**
+         * @brief Enables or disables pondering
+         * @param enabled  whether the engine should think on the opponent's time
+         */
+        void setPonder(bool enabled);
+
+
+        /**
+         * @brief Enables or disables the shuffling of moves before they are ordered. Without it, the same search of the
+         * same position always visits the same nodes, whatever the seed
+         * @param enabled  whether moves are shuffled
+         */
+        void setShuffle(bool enabled);
+
+
+        /**
+         * @brief Resizes the transposition table. Its contents are lost
+         * @param megabytes  new size of the table in megabytes
+         */
+        void setHashSize(size_t megabytes);
+
+
+        /**
+         * @brief Resizes the pawn hash table. Its contents are lost
+         * @param megabytes  new size of the table in megabytes
+         */
+        void setPawnHashSize(size_t megabytes);
+
+
+        /**
+         * @brief Resizes the evaluation cache. Its contents are lost
+         * @param megabytes  new size of the cache in megabytes
+         */
+        void setEvalCacheSize(size_t megabytes);
+
+
+        /**
+         * @brief Empties the transposition table and the evaluation cache, so that a new game does not depend on the
+         * previous ones
+         */
+        void clearHash();
+
+
+        /**
+         * @brief Replaces the piece-square tables of the evaluation with the ones in a weights file
+         * @param path  path of the weights file
+         * @return True if the file was read successfully. If it was not, the evaluation is left untouched
+         */
+        bool loadWeights(const std::string &path);
+
+
+        /**
+         * @brief Replaces the piece-square tables of the evaluation. A null pointer switches back to the default tables
+         * @param tables  tables to be used
+         */
+        void setPieceSquareTables(std::shared_ptr<const PieceSquareTables> tables);
+
+
+        /**
+         * @brief Get method that returns the piece-square tables used by the evaluation, so that other engines can share
+         * them
+         * @return the value of Engine::pieceSquareTables
+         */
+        [[nodiscard]] std::shared_ptr<const PieceSquareTables> getPieceSquareTables() const;
+
+
+        /**
+         * @brief Switches the evaluation to a neural network read from a weights file
+         * @param path  path of the weights file, in the format read by NnueNetwork::load
+         * @return True if the file was read successfully. If it was not, the evaluation is left untouched
+         */
+        bool loadNetwork(const std::string &path);
+
+
+        /**
+         * @brief Switches the evaluation to a neural network. A null network switches back to evaluateBoard
+         * @param net  network to be used
+         */
+        void setNetwork(std::shared_ptr<const NnueNetwork> net);
+
+
+        /**
+         * @brief Get method that returns the network used by the evaluation, so that other engines can share it
+         * @return the value of Engine::network, null when the handcrafted evaluation is used
+         */
+        [[nodiscard]] std::shared_ptr<const NnueNetwork> getNetwork() const;
+
+
+        /**
+         * @brief Get method that returns the accumulator of the current position. Only meaningful while a network is set
+         * @return a reference to the last element of Engine::accumulators
+         */
+        [[nodiscard]] const NnueAccumulator &getAccumulator() const;
+
+
+        /**
+         * @brief Get method that returns the Zobrist hash of the current position
+         * @return the value of Engine::hash
+         */
+        [[nodiscard]] uint64_t getHash() const;
+
+
+        /**
+         * @brief Get method that returns the current board
+         * @return a reference to Engine::bitboard
+         */
+        [[nodiscard]] const Bitboard &getBitboard() const;
+
+
+        /**
+         * @brief Get method that returns the evaluation state of the current position
+         * @return a reference to Engine::evalState
+         */
+        [[nodiscard]] const EvalState &getEvalState() const;
+
+
+        /**
+         * @brief Follows the best moves stored in the transposition table from the current position
+         * @param length  maximum number of moves
+         * @return the principal variation, starting with the move for the side to move
+         */
+        std::vector<std::string> getPrincipalVariation(int length);
+
+
         /**
          * @brief Traverses the tree of movements up to \p depth and returns the best move the algorithm has found
          * @param depth  maximum traversal depth
@@ -148,6 +634,37 @@ namespace chessqdl {
         std::string getBestMove(int depth, enumColor color);
 
 
+        /**
+         * @brief Iterative deepening search of the current position for the side to move, bounded by \p limits
+         * @param limits  depth, node and time limits of the search
+         * @param onIteration  called after every completed iteration. May be empty
+         * @return the best move found, or an empty string if the side to move has no moves
+         */
+        std::string search(const SearchLimits &limits, const std::function<void(const SearchInfo &)> &onIteration = {});
+
+
+        /**
+         * @brief Starts the clock of the running search, so that its time limits apply from now on
+         */
+        void startClock();
+
+
+        /**
+         * @brief Asks the running search to stop as soon as possible. Safe to call from any thread
+         */
+        void stop();
+
+
+        /**
+         * @brief Finds the \p count best moves, each with its score and principal variation
+         * @param depth  maximum traversal depth
+         * @param color  color of the pieces for which to find the best moves
+         * @param count  number of lines to find
+         * @return the best lines found, from best to worst. May hold fewer than \p count lines if there are not enough moves
+         */
+        std::vector<scoreStruct> getBestMoves(int depth, enumColor color, int count);
+
+
         /**
          * @brief Max implementation of the Minimax algorithm with alpha-beta pruning
          * @param alpha  score to be maximized
@@ -159,7 +676,7 @@ namespace chessqdl {
          * @param bestMove  best move the algorithm has found
          * @return returns the value of \p alpha
          */
-        int alphaBetaMax(int alpha, int beta, int depth, int depthLeft, enumColor color, int &nodesVisited,
+        int alphaBetaMax(int alpha, int beta, int depth, int depthLeft, enumColor color, long long &nodesVisited,
                          std::string &bestMove);
 
 
@@ -174,8 +691,32 @@ namespace chessqdl {
          * @param bestMove  best move the algorithm has found
          * @return returns the value of \p beta
          */
-        int alphaBetaMin(int alpha, int beta, int depth, int depthLeft, enumColor color, int &nodesVisited,
+        int alphaBetaMin(int alpha, int beta, int depth, int depthLeft, enumColor color, long long &nodesVisited,
                          std::string &bestMove);
+
+
+        /**
+         * @brief Max implementation of the quiescence search, which only searches captures so that leaves are not
+         * evaluated in the middle of an exchange
+         * @param alpha  score to be maximized
+         * @param beta  score to be minimized
+         * @param color  color of the moving pieces
+         * @param nodesVisited  quantity of nodes visited
+         * @return returns the value of \p alpha
+         */
+        int quiescenceMax(int alpha, int beta, enumColor color, long long &nodesVisited);
+
+
+        /**
+         * @brief Min implementation of the quiescence search, which only searches captures so that leaves are not
+         * evaluated in the middle of an exchange
+         * @param alpha  score to be maximized
+         * @param beta  score to be minimized
+         * @param color  color of the moving pieces
+         * @param nodesVisited  quantity of nodes visited
+         * @return returns the value of \p beta
+         */
+        int quiescenceMin(int alpha, int beta, enumColor color, long long &nodesVisited);
     };
 }
 
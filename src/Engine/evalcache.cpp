@@ -0,0 +1,87 @@
+#include "evalcache.hpp"
+#include "utils.hpp"
+
+using namespace chessqdl;
+
+namespace {
+
+    constexpr uint64_t keyMask = 0xFFFFFFFF00000000ULL;
+
+}
+
+
+/**
+ * @details See EvalCache::resize
+ */
+EvalCache::EvalCache(const size_t megabytes) {
+    resize(megabytes);
+}
+
+
+/**
+ * @details See tableEntries.
+ */
+void EvalCache::resize(const size_t megabytes) {
+    const size_t entries = tableEntries(megabytes, sizeof(uint64_t));
+
+    table = std::make_unique<std::atomic<uint64_t>[]>(entries);
+    mask = entries - 1;
+    clear();
+    resetStats();
+}
+
+
+void EvalCache::clear() {
+    for (uint64_t i = 0; i <= mask; i++)
+        table[i].store(0, std::memory_order_relaxed);
+}
+
+
+/**
+ * @details The lower bits of the key select the entry and the upper half is compared with the stored one. An empty
+ * entry is all zeros, so a position whose upper key half and score are both zero is never reported as a hit, which
+ * only costs a recomputation.
+ */
+bool EvalCache::probe(const uint64_t key, int &score) {
+    const uint64_t data = table[key & mask].load(std::memory_order_relaxed);
+
+    probes++;
+
+    if (data == 0 || ((data ^ key) & keyMask) != 0)
+        return false;
+
+    hits++;
+    score = static_cast<int32_t>(static_cast<uint32_t>(data));
+
+    return true;
+}
+
+
+void EvalCache::store(const uint64_t key, const int score) {
+    table[key & mask].store((key & keyMask) | static_cast<uint32_t>(score), std::memory_order_relaxed);
+}
+
+
+/**
+ * @details Returns EvalCache::probes
+ */
+uint64_t EvalCache::getProbes() const {
+    return probes;
+}
+
+
+/**
+ * @details Returns EvalCache::hits
+ */
+uint64_t EvalCache::getHits() const {
+    return hits;
+}
+
+
+/**
+ * @details Resets EvalCache::probes and EvalCache::hits
+ */
+void EvalCache::resetStats() {
+    probes = 0;
+    hits = 0;
+}
@@ -0,0 +1,102 @@
+#ifndef CHESSQDL_EVALCACHE_HPP
+#define CHESSQDL_EVALCACHE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace chessqdl {
+
+    /**
+     * @brief Direct-mapped cache of static evaluations, keyed by Zobrist hash. <br>
+     *
+     * Each entry is a single 64 bit word holding the upper half of the key and the score, so it is always read and
+     * written as a whole. Every Engine owns its cache and uses it from its search thread only, so the lookup counters
+     * are plain integers; sharing a cache between threads would need per-thread counters
+     */
+    class EvalCache {
+
+    private:
+
+        /**
+         * @brief Table entries. The number of entries is always a power of two
+         */
+        std::unique_ptr<std::atomic<uint64_t>[]> table;
+
+        /**
+         * @brief Mask applied to a key to obtain its index in the table
+         */
+        uint64_t mask = 0;
+
+        /**
+         * @brief Number of lookups since the last call to resetStats
+         */
+        uint64_t probes = 0;
+
+        /**
+         * @brief Number of successful lookups since the last call to resetStats
+         */
+        uint64_t hits = 0;
+
+    public:
+
+        /**
+         * @brief Allocates a cache of (at most) \p megabytes megabytes
+         * @param megabytes  size of the cache in megabytes
+         */
+        explicit EvalCache(size_t megabytes = 1);
+
+
+        /**
+         * @brief Reallocates the cache with (at most) \p megabytes megabytes. All entries are lost
+         * @param megabytes  new size of the cache in megabytes
+         */
+        void resize(size_t megabytes);
+
+
+        /**
+         * @brief Empties the cache. Needed whenever the evaluation function changes
+         */
+        void clear();
+
+
+        /**
+         * @brief Looks up the evaluation of a position
+         * @param key  Zobrist hash of the position
+         * @param score  filled with the stored score if the position is found
+         * @return true if the position was found, false otherwise
+         */
+        bool probe(uint64_t key, int &score);
+
+
+        /**
+         * @brief Stores the evaluation of a position, replacing whatever was stored at its index
+         * @param key  Zobrist hash of the position
+         * @param score  evaluation of the position
+         */
+        void store(uint64_t key, int score);
+
+
+        /**
+         * @brief Get method that returns the number of lookups since the last call to resetStats
+         * @return the value of EvalCache::probes
+         */
+        [[nodiscard]] uint64_t getProbes() const;
+
+
+        /**
+         * @brief Get method that returns the number of successful lookups since the last call to resetStats
+         * @return the value of EvalCache::hits
+         */
+        [[nodiscard]] uint64_t getHits() const;
+
+
+        /**
+         * @brief Resets the lookup counters
+         */
+        void resetStats();
+    };
+
+}
+
+#endif //CHESSQDL_EVALCACHE_HPP
@@ -0,0 +1,154 @@
+#include "evaluation.hpp"
+#include "movegen.hpp"
+#include "utils.hpp"
+#include "zobrist.hpp"
+
+using namespace chessqdl;
+
+
+/**
+ * @details Material and phase only depend on the piece type. Piece-square bonuses are read from EvalState::tables.
+ */
+void EvalState::addPiece(const enumColor color, const int piece, const int square) {
+    material[color] += pieceValues[piece];
+    mgPsqt[color] += tables->mg[piece][relativeSquare(color, square)];
+    egPsqt[color] += tables->eg[piece][relativeSquare(color, square)];
+    phase += phaseWeights[piece];
+    materialKey += materialKeyOf(color, piece);
+
+    if (piece == nPawn)
+        pawnKey ^= Zobrist::getPieceKey(color, nPawn, square);
+}
+
+
+/**
+ * @details Inverse of EvalState::addPiece.
+ */
+void EvalState::removePiece(const enumColor color, const int piece, const int square) {
+    material[color] -= pieceValues[piece];
+    mgPsqt[color] -= tables->mg[piece][relativeSquare(color, square)];
+    egPsqt[color] -= tables->eg[piece][relativeSquare(color, square)];
+    phase -= phaseWeights[piece];
+    materialKey -= materialKeyOf(color, piece);
+
+    if (piece == nPawn)
+        pawnKey ^= Zobrist::getPieceKey(color, nPawn, square);
+}
+
+
+bool EvalState::operator==(const EvalState &other) const {
+    return material == other.material && mgPsqt == other.mgPsqt && egPsqt == other.egPsqt && phase == other.phase &&
+           pawnKey == other.pawnKey && materialKey == other.materialKey;
+}
+
+
+/**
+ * @details Adds every piece of the board, one at a time.
+ */
+EvalState chessqdl::computeEvalState(const BitboardArray &board, const PieceSquareTables &tables) {
+    EvalState state;
+    state.tables = &tables;
+
+    for (int color = nWhite; color <= nBlack; color++) {
+        for (int piece = nPawn; piece <= nKing; piece++) {
+            uint64_t pieces = (board[piece] & board[color]).to_ullong();
+
+            while (pieces) {
+                state.addPiece(static_cast<enumColor>(color), piece, leastSignificantSetBit(pieces));
+                pieces &= pieces - 1;
+            }
+        }
+    }
+
+    return state;
+}
+
+
+/**
+ * @details Works on attack sets only: no move lists are generated. Sliders are blocked by pieces of both colors, but
+ * the blocking square itself is counted if it holds an enemy piece.
+ */
+int chessqdl::evaluateMobility(const BitboardArray &board, const enumColor color) {
+    const enumColor enemyColor = color == nWhite ? nBlack : nWhite;
+    const U64 occupied = board[nColor];
+    const U64 safe = ~board[color] & ~MoveGenerator::getPawnAttacks(board[nPawn] & board[enemyColor], enemyColor);
+
+    int score = 0;
+
+    for (int piece = nKnight; piece <= nQueen; piece++) {
+        uint64_t pieces = (board[piece] & board[color]).to_ullong();
+
+        while (pieces) {
+            // Isolates the least significant piece
+            const U64 square = pieces & -pieces;
+            pieces &= pieces - 1;
+
+            U64 attacks;
+
+            switch (piece) {
+                case nKnight:
+                    attacks = MoveGenerator::getKnightAttacks(square);
+                    break;
+                case nBishop:
+                    attacks = MoveGenerator::getBishopAttacks(square, occupied);
+                    break;
+                case nRook:
+                    attacks = MoveGenerator::getRookAttacks(square, occupied);
+                    break;
+                default:
+                    attacks = MoveGenerator::getBishopAttacks(square, occupied) |
+                              MoveGenerator::getRookAttacks(square, occupied);
+                    break;
+            }
+
+            score += mobilityWeights[piece] * static_cast<int>((attacks & safe).count());
+        }
+    }
+
+    return score;
+}
+
+
+/**
+ * @details Performs an evaluation that takes into account the material balance, the placement of the pieces, their
+ * mobility and the pawn structure. <br>
+ *
+ * Piece value is as follows (in centipawns): <br>
+ * King   - 20000 <br>
+ * Queen  - 900 <br>
+ * Rook   - 500 <br>
+ * Bishop - 300 <br>
+ * Knight - 300 <br>
+ * Pawn   - 100 <br>
+ */
+int chessqdl::evaluateBoard(const BitboardArray &board, const enumColor color) {
+    return evaluateBoard(board, computeEvalState(board), color);
+}
+
+
+/**
+ * @details Endgames with a specialized evaluator are scored by it alone. Otherwise, the material balance and the
+ * piece-square bonuses are read from \p state. Mobility is computed from attack sets. The pawn structure is read from
+ * \p pawnTable when available. Middlegame and endgame scores are blended according to the phase, and the result is
+ * scaled down in endgames that are hard to win.
+ */
+int chessqdl::evaluateBoard(const BitboardArray &board, const EvalState &state, const enumColor color,
+                            PawnHashTable *pawnTable) {
+    const enumColor enemyColor = color == nWhite ? nBlack : nWhite;
+
+    int score;
+
+    if (evaluateEndgame(board, state.materialKey, color, score))
+        return score;
+
+    score = state.material[color] - state.material[enemyColor];
+    score += taper(state.mgPsqt[color] - state.mgPsqt[enemyColor], state.egPsqt[color] - state.egPsqt[enemyColor],
+                   state.phase);
+    score += evaluateMobility(board, color) - evaluateMobility(board, enemyColor);
+
+    const PawnEntry pawns = pawnTable ? pawnTable->probe(state.pawnKey, board) : evaluatePawns(board);
+    const int pawnScore = taper(pawns.mgScore, pawns.egScore, state.phase);
+    score += color == nWhite ? pawnScore : -pawnScore;
+
+    return score * endgameScaleFactor(board, state.materialKey, score >= 0 ? color : enemyColor) / normalScaleFactor;
+}
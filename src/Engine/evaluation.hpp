@@ -0,0 +1,155 @@
+#ifndef CHESSQDL_EVALUATION_HPP
+#define CHESSQDL_EVALUATION_HPP
+
+#include "const.hpp"
+#include "endgame.hpp"
+#include "pawns.hpp"
+#include "psqt.hpp"
+
+namespace chessqdl {
+
+    /**
+     * @brief Material value of each piece type, in centipawns. Indexing follows enumPiece
+     */
+    constexpr std::array<int, 9> pieceValues = {0, 0, 0, 100, 300, 300, 500, 900, 20000};
+
+
+    /**
+     * @brief Bonus for each safe square attacked by a piece, in centipawns. Indexing follows enumPiece
+     */
+    constexpr std::array<int, 9> mobilityWeights = {0, 0, 0, 0, 8, 7, 4, 2, 0};
+
+
+    /**
+     * @brief Contribution of each piece type to the game phase. Indexing follows enumPiece
+     */
+    constexpr std::array<int, 9> phaseWeights = {0, 0, 0, 0, 1, 1, 2, 4, 0};
+
+
+    /**
+     * @brief Game phase of the initial position. Lower phases are closer to the endgame
+     */
+    constexpr int maxPhase = 24;
+
+
+    /**
+     * @brief Interpolates between a middlegame and an endgame score according to the game phase
+     * @param mg  middlegame score
+     * @param eg  endgame score
+     * @param phase  game phase, from 0 (endgame) to maxPhase (middlegame). Larger values are clamped
+     * @return Tapered score
+     */
+    constexpr int taper(const int mg, const int eg, int phase) {
+        phase = phase > maxPhase ? maxPhase : phase;
+        return (mg * phase + eg * (maxPhase - phase)) / maxPhase;
+    }
+
+
+    /**
+     * @brief Evaluation terms that only depend on which pieces stand on which squares. These terms are kept up to date
+     * move by move, so they do not need to be recomputed at every leaf
+     */
+    struct EvalState {
+        /**
+         * @brief Material of each color (indexed by nWhite and nBlack)
+         */
+        std::array<int, 2> material = {0, 0};
+
+        /**
+         * @brief Middlegame piece-square bonuses of each color (indexed by nWhite and nBlack)
+         */
+        std::array<int, 2> mgPsqt = {0, 0};
+
+        /**
+         * @brief Endgame piece-square bonuses of each color (indexed by nWhite and nBlack)
+         */
+        std::array<int, 2> egPsqt = {0, 0};
+
+        /**
+         * @brief Game phase, the sum of phaseWeights over all pieces on the board
+         */
+        int phase = 0;
+
+        /**
+         * @brief Zobrist key of the pawns alone. Used to look up the pawn structure in a PawnHashTable
+         */
+        uint64_t pawnKey = 0;
+
+        /**
+         * @brief Number of pieces of each color and type, packed as described in materialKeyOf. Used to look up the
+         * specialized endgame evaluators
+         */
+        uint64_t materialKey = 0;
+
+        /**
+         * @brief Tables the piece-square bonuses are read from. Not owned, the engine using the state keeps them alive
+         */
+        const PieceSquareTables *tables = &getDefaultPieceSquareTables();
+
+
+        /**
+         * @brief Accounts for a piece that was placed on the board
+         * @param color  color of the piece
+         * @param piece  type of the piece
+         * @param square  square the piece was placed on
+         */
+        void addPiece(enumColor color, int piece, int square);
+
+
+        /**
+         * @brief Accounts for a piece that was removed from the board
+         * @param color  color of the piece
+         * @param piece  type of the piece
+         * @param square  square the piece was removed from
+         */
+        void removePiece(enumColor color, int piece, int square);
+
+
+        bool operator==(const EvalState &other) const;
+    };
+
+
+    /**
+     * @brief Computes the evaluation state of a board from scratch
+     * @param board  board of interest
+     * @param tables  piece-square tables of the state. They must outlive it
+     * @return Evaluation state equivalent to placing every piece of \p board on an empty board
+     */
+    EvalState computeEvalState(const BitboardArray &board,
+                               const PieceSquareTables &tables = getDefaultPieceSquareTables());
+
+
+    /**
+     * @brief Computes the mobility of the pieces of a color. Each knight, bishop, rook and queen is rewarded for every
+     * square it attacks that is neither occupied by an allied piece nor attacked by an enemy pawn
+     * @param board  board of interest
+     * @param color  color of the pieces
+     * @return Weighted sum of safe squares attacked, in centipawns
+     */
+    int evaluateMobility(const BitboardArray &board, enumColor color);
+
+
+    /**
+     * @brief Heuristic function to evaluate the color with the default piece-square tables. Every term is computed from
+     * scratch
+     * @param board  board to evaluate
+     * @param color  here colors defines the perspective of the evaluation. If the board is better for the \p color pieces, result will be positive. Otherwise, it will be negative
+     * @return Score of the board indicating who has the advantage
+     */
+    int evaluateBoard(const BitboardArray &board, enumColor color);
+
+
+    /**
+     * @brief Heuristic function to evaluate the color, using an evaluation state kept up to date by the caller
+     * @param board  board to evaluate
+     * @param state  evaluation state of \p board
+     * @param color  perspective of the evaluation, also taken as the side to move by the specialized endgame evaluators
+     * @param pawnTable  table used to cache pawn structure evaluations. If null, the pawn structure is evaluated from scratch
+     * @return Same score as evaluateBoard(board, color) when \p state uses the default tables
+     */
+    int evaluateBoard(const BitboardArray &board, const EvalState &state, enumColor color,
+                      PawnHashTable *pawnTable = nullptr);
+
+}
+
+#endif //CHESSQDL_EVALUATION_HPP
@@ -0,0 +1,90 @@
+#include "instrument.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace chessqdl;
+
+namespace {
+
+    const char *counterNames[nCounters] = {"nodes", "qnodes", "tt probes", "tt hits", "cutoffs", "first-move cutoffs",
+                                           "eval calls"};
+
+    const char *timerNames[nTimers] = {"movegen", "make move", "take move", "eval"};
+
+}
+
+
+/**
+ * @details Every thread has its own data, so the hot paths update it without synchronization
+ */
+Instrumentation &chessqdl::threadInstrumentation() {
+    thread_local Instrumentation data;
+    return data;
+}
+
+
+/**
+ * @details The tt hits are also given as a share of the probes, and the first-move cutoffs as a share of the cutoffs,
+ * which tells how good the move ordering is
+ */
+void chessqdl::printInstrumentation(std::ostream &output, const Instrumentation &data, const uint64_t time) {
+    const auto share = [](const uint64_t part, const uint64_t whole) {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(1) << (whole > 0 ? 100.0 * part / whole : 0.0) << "%";
+        return text.str();
+    };
+
+    const uint64_t nodes = data.counts[nNodeCounter] + data.counts[nQNodeCounter];
+
+    output << std::left << std::setw(20) << "counter" << std::right << std::setw(14) << "count" << std::setw(12)
+           << "per node" << std::setw(10) << "rate" << std::endl;
+
+    for (int counter = 0; counter < nCounters; counter++) {
+        const uint64_t count = data.counts[counter];
+
+        output << std::left << std::setw(20) << counterNames[counter] << std::right << std::setw(14) << count
+               << std::setw(12) << std::fixed << std::setprecision(3)
+               << (nodes > 0 ? static_cast<double>(count) / nodes : 0.0);
+
+        if (counter == nTTHitCounter)
+            output << std::setw(10) << share(count, data.counts[nTTProbeCounter]);
+        else if (counter == nFirstMoveCutoffCounter)
+            output << std::setw(10) << share(count, data.counts[nCutoffCounter]);
+
+        output << std::endl;
+    }
+
+    output << std::left << std::setw(20) << "timer" << std::right << std::setw(14) << "calls" << std::setw(12)
+           << "ms" << std::setw(10) << "ns/call" << std::setw(10) << "share" << std::endl;
+
+    for (int timer = 0; timer < nTimers; timer++) {
+        const uint64_t calls = data.calls[timer];
+        const uint64_t nanoseconds = data.nanoseconds[timer];
+
+        output << std::left << std::setw(20) << timerNames[timer] << std::right << std::setw(14) << calls
+               << std::setw(12) << std::fixed << std::setprecision(1) << nanoseconds / 1e6 << std::setw(10)
+               << (calls > 0 ? nanoseconds / calls : 0) << std::setw(10) << share(nanoseconds, time) << std::endl;
+    }
+
+    output << std::left << std::setw(20) << "search" << std::right << std::setw(26) << std::fixed
+           << std::setprecision(1) << time / 1e6 << std::endl;
+}
+
+
+SearchReport::SearchReport() : start(std::chrono::steady_clock::now()) {
+    threadInstrumentation() = Instrumentation();
+}
+
+
+/**
+ * @details The table is written at once, so that the reports of searches running on different threads do not mix
+ */
+SearchReport::~SearchReport() {
+    const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    std::ostringstream table;
+    printInstrumentation(table, threadInstrumentation(), time.count());
+    std::cerr << table.str() << std::flush;
+}
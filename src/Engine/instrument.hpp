@@ -0,0 +1,127 @@
+#ifndef CHESSQDL_INSTRUMENT_HPP
+#define CHESSQDL_INSTRUMENT_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace chessqdl {
+
+    /**
+     * @brief Events counted by the instrumentation
+     */
+    enum enumCounter {
+        nNodeCounter,               // nodes of the main search
+        nQNodeCounter,              // nodes of the quiescence search
+        nTTProbeCounter,            // transposition table probes
+        nTTHitCounter,              // probes that found the position
+        nCutoffCounter,             // beta cutoffs of the main search
+        nFirstMoveCutoffCounter,    // cutoffs caused by the first move searched
+        nEvalCounter,               // calls to Engine::evaluate
+        nCounters
+    };
+
+    /**
+     * @brief Hot paths timed by the instrumentation
+     */
+    enum enumTimer {
+        nMoveGenTimer,              // MoveGenerator::getPseudoLegalMoves
+        nMakeMoveTimer,             // Engine::makeMove
+        nTakeMoveTimer,             // Engine::takeMove
+        nEvalTimer,                 // Engine::evaluate
+        nTimers
+    };
+
+
+    /**
+     * @brief Counters and timers of one thread
+     */
+    struct Instrumentation {
+        std::array<uint64_t, nCounters> counts{};
+        std::array<uint64_t, nTimers> calls{};
+
+        /**
+         * @brief Time spent in each timer, in nanoseconds
+         */
+        std::array<uint64_t, nTimers> nanoseconds{};
+    };
+
+
+    /**
+     * @brief Get method that returns the counters and timers of the calling thread. They are only updated in builds
+     * with CHESSQDL_INSTRUMENT defined
+     */
+    Instrumentation &threadInstrumentation();
+
+
+    /**
+     * @brief Prints a table of the counters, with their rate per node, and of the timers, with their share of the time
+     * @param output  stream to print to
+     * @param data  counters and timers of interest
+     * @param time  duration of the instrumented search, in nanoseconds
+     */
+    void printInstrumentation(std::ostream &output, const Instrumentation &data, uint64_t time);
+
+
+    /**
+     * @brief Adds the time spent in a scope to a timer of the calling thread
+     */
+    class ScopedTimer {
+    private:
+        enumTimer timer;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit ScopedTimer(const enumTimer timer) : timer(timer), start(std::chrono::steady_clock::now()) {
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+        ~ScopedTimer() {
+            Instrumentation &data = threadInstrumentation();
+            data.calls[timer]++;
+            data.nanoseconds[timer] += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+        }
+    };
+
+
+    /**
+     * @brief Resets the counters and timers of the calling thread, then prints them to stderr once the scope is left
+     */
+    class SearchReport {
+    private:
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        SearchReport();
+
+        SearchReport(const SearchReport &) = delete;
+        SearchReport &operator=(const SearchReport &) = delete;
+
+        ~SearchReport();
+    };
+
+}
+
+/*
+ * Instrumentation points. They expand to nothing unless CHESSQDL_INSTRUMENT is defined (CMake option of the same
+ * name), so the hot paths are not slowed down by default
+ */
+#ifdef CHESSQDL_INSTRUMENT
+#define CHESSQDL_COUNT(counter) ((void) chessqdl::threadInstrumentation().counts[counter]++)
+#define CHESSQDL_COUNT_IF(counter, condition) do { if (condition) CHESSQDL_COUNT(counter); } while (false)
+#define CHESSQDL_CONCAT_(a, b) a##b
+#define CHESSQDL_CONCAT(a, b) CHESSQDL_CONCAT_(a, b)
+#define CHESSQDL_TIME(timer) const chessqdl::ScopedTimer CHESSQDL_CONCAT(scopedTimer, __LINE__)(timer)
+#define CHESSQDL_SEARCH_REPORT() const chessqdl::SearchReport CHESSQDL_CONCAT(searchReport, __LINE__)
+#else
+#define CHESSQDL_COUNT(counter) ((void) 0)
+#define CHESSQDL_COUNT_IF(counter, condition) ((void) 0)
+#define CHESSQDL_TIME(timer) ((void) 0)
+#define CHESSQDL_SEARCH_REPORT() ((void) 0)
+#endif
+
+#endif //CHESSQDL_INSTRUMENT_HPP
@@ -0,0 +1,381 @@
+#include "match.hpp"
+#include "endgame.hpp"
+#include "movegen.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+using namespace chessqdl;
+
+namespace {
+
+    /**
+     * @brief Neither side can ever mate
+     */
+    bool isInsufficientMaterial(const BitboardArray &board) {
+        static const std::array<uint64_t, 5> keys = {materialKeyFromCode("KK"), materialKeyFromCode("KNK"),
+                                                     materialKeyFromCode("KKN"), materialKeyFromCode("KBK"),
+                                                     materialKeyFromCode("KKB")};
+
+        return std::find(keys.begin(), keys.end(), computeMaterialKey(board)) != keys.end();
+    }
+
+    /**
+     * @brief Expected score of a player that is \p elo points stronger
+     */
+    double expectedScore(const double elo) {
+        return 1 / (1 + std::pow(10, -elo / 400));
+    }
+
+    double eloFromScore(const double score) {
+        if (score <= 0)
+            return -std::numeric_limits<double>::infinity();
+        if (score >= 1)
+            return std::numeric_limits<double>::infinity();
+
+        return -400 * std::log10(1 / score - 1);
+    }
+
+    /**
+     * @brief Variance of the points scored in a single game
+     */
+    double gameVariance(const MatchStats &stats) {
+        const double s = stats.score();
+        const double n = stats.games();
+
+        return (stats.wins * (1 - s) * (1 - s) + stats.draws * (0.5 - s) * (0.5 - s) + stats.losses * s * s) / n;
+    }
+
+    void appendResult(std::ostream &output, const enumGameResult result) {
+        output << (result == nWhiteWins ? "1-0" : result == nBlackWins ? "0-1" : "1/2-1/2");
+    }
+
+}
+
+
+/**
+ * @details Both engines follow every move, so each one searches from its own copy of the game. Before each move the
+ * game is checked for mate, stalemate, insufficient material, the fifty-move rule, threefold repetition (by Zobrist
+ * hash) and its maximum length, and after it for a time forfeit and the adjudication rules. <br>
+ *
+ * Castling and en passant are not generated, so games never contain them.
+ */
+GameRecord chessqdl::playGame(Engine &white, const PlayerConfig &whiteConfig, Engine &black,
+                              const PlayerConfig &blackConfig, const std::string &fen,
+                              const Adjudication &adjudication) {
+    std::array<Engine *, 2> engines = {&white, &black};
+    std::array<const PlayerConfig *, 2> players = {&whiteConfig, &blackConfig};
+    std::array<long long, 2> clocks = {whiteConfig.time, blackConfig.time};
+
+    GameRecord game;
+    game.fen = fen;
+
+    for (Engine *engine: engines) {
+        engine->setPosition(fen);
+        engine->clearHash();
+    }
+
+    std::istringstream fields(fen);
+    std::string placement, side, castling, enPassant;
+    int halfMoves = 0;
+    int fullMoves = 1;
+    fields >> placement >> side >> castling >> enPassant >> halfMoves >> fullMoves;
+
+    enumColor toMove = side == "b" ? nBlack : nWhite;
+    std::vector<uint64_t> hashes = {white.getHash()};
+    int drawPlies = 0;
+    int resignPlies = 0;
+    int lastWhiteScore = 0;
+
+    const auto finish = [&game, &white](const enumGameResult result, const std::string &termination) {
+        game.moves = white.getSanHistory();
+        game.result = result;
+        game.termination = termination;
+        return game;
+    };
+
+    for (int ply = 0;; ply++) {
+        const BitboardArray &board = white.getBitboard().getBitBoards();
+        const std::vector<std::string> legalMoves = MoveGenerator::getLegalMoves(board, toMove);
+        const enumColor enemy = toMove == nWhite ? nBlack : nWhite;
+        const enumGameResult loss = toMove == nWhite ? nBlackWins : nWhiteWins;
+
+        if (legalMoves.empty())
+            return MoveGenerator::isKingAttacked(board, toMove) ? finish(loss, "checkmate") : finish(nDrawn, "stalemate");
+        if (isInsufficientMaterial(board))
+            return finish(nDrawn, "insufficient material");
+        if (halfMoves >= 100)
+            return finish(nDrawn, "fifty-move rule");
+        if (std::count(hashes.begin(), hashes.end(), hashes.back()) >= 3)
+            return finish(nDrawn, "threefold repetition");
+        if (ply >= adjudication.maxPlies)
+            return finish(nDrawn, "maximum length");
+
+        const PlayerConfig &player = *players[toMove];
+        SearchLimits limits;
+
+        if (player.time > 0) {
+            limits.time = clocks;
+            limits.increment = {whiteConfig.increment, blackConfig.increment};
+        } else {
+            limits.depth = player.depth;
+            limits.nodes = player.nodes;
+            limits.moveTime = player.moveTime;
+        }
+
+        int score = 0;
+        const auto begin = std::chrono::steady_clock::now();
+        const std::string mv = engines[toMove]->search(limits, [&score](const SearchInfo &info) {
+            score = info.score;
+        });
+
+        if (player.time > 0) {
+            clocks[toMove] -= std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - begin).count();
+
+            if (clocks[toMove] < 0)
+                return finish(loss, "time forfeit");
+
+            clocks[toMove] += player.increment;
+        }
+
+        if (std::find(legalMoves.begin(), legalMoves.end(), mv) == legalMoves.end())
+            return finish(loss, "illegal move " + mv);
+
+        const int from = packMove(mv) & 0x3f;
+        const int to = (packMove(mv) >> 6) & 0x3f;
+        halfMoves = board[nPawn].test(from) || board[enemy].test(to) ? 0 : halfMoves + 1;
+
+        for (Engine *engine: engines)
+            engine->makeMove(mv, false, false);
+
+        hashes.push_back(white.getHash());
+
+        if (toMove == nBlack)
+            fullMoves++;
+
+        // Scores are from the point of view of the side that moved
+        const int whiteScore = toMove == nWhite ? score : -score;
+
+        if (std::abs(whiteScore) >= adjudication.resignScore && (whiteScore > 0) == (lastWhiteScore > 0))
+            resignPlies++;
+        else
+            resignPlies = std::abs(whiteScore) >= adjudication.resignScore ? 1 : 0;
+
+        lastWhiteScore = whiteScore;
+
+        if (resignPlies >= adjudication.resignPlies)
+            return finish(whiteScore > 0 ? nWhiteWins : nBlackWins, "adjudication");
+
+        drawPlies = fullMoves >= adjudication.drawMoveNumber && std::abs(score) <= adjudication.drawScore
+                        ? drawPlies + 1
+                        : 0;
+
+        if (drawPlies >= adjudication.drawPlies)
+            return finish(nDrawn, "adjudication");
+
+        toMove = enemy;
+    }
+}
+
+
+/**
+ * @details The FEN and SetUp tags are only written for games that do not start from the initial position. Lines of
+ * movetext are kept under 80 characters, as PGN recommends.
+ */
+void chessqdl::writePgn(std::ostream &output, const GameRecord &game, const std::string &white,
+                        const std::string &black, const int round) {
+    output << "[Event \"ChessQDL self-play\"]\n";
+    output << "[Site \"?\"]\n";
+    output << "[Round \"" << round << "\"]\n";
+    output << "[White \"" << white << "\"]\n";
+    output << "[Black \"" << black << "\"]\n";
+    output << "[Result \"";
+    appendResult(output, game.result);
+    output << "\"]\n";
+
+    if (game.fen != startFen) {
+        output << "[FEN \"" << game.fen << "\"]\n";
+        output << "[SetUp \"1\"]\n";
+    }
+
+    output << "[Termination \"" << game.termination << "\"]\n\n";
+
+    std::istringstream fields(game.fen);
+    std::string placement, side, castling, enPassant;
+    int halfMoves = 0;
+    int fullMoves = 1;
+    fields >> placement >> side >> castling >> enPassant >> halfMoves >> fullMoves;
+
+    std::ostringstream result;
+    appendResult(result, game.result);
+
+    std::vector<std::string> tokens;
+    bool whiteToMove = side != "b";
+
+    if (!whiteToMove && !game.moves.empty())
+        tokens.push_back(std::to_string(fullMoves) + "...");
+
+    for (const auto &mv: game.moves) {
+        if (whiteToMove)
+            tokens.push_back(std::to_string(fullMoves) + ".");
+        else
+            fullMoves++;
+
+        tokens.push_back(mv);
+        whiteToMove = !whiteToMove;
+    }
+
+    tokens.push_back(result.str());
+
+    size_t lineLength = 0;
+
+    for (const auto &token: tokens) {
+        if (lineLength > 0 && lineLength + 1 + token.size() >= 80) {
+            output << "\n";
+            lineLength = 0;
+        } else if (lineLength > 0) {
+            output << " ";
+            lineLength++;
+        }
+
+        output << token;
+        lineLength += token.size();
+    }
+
+    output << "\n\n";
+}
+
+
+int MatchStats::games() const {
+    return wins + losses + draws;
+}
+
+
+double MatchStats::score() const {
+    return games() == 0 ? 0.5 : (wins + 0.5 * draws) / games();
+}
+
+
+double MatchStats::elo() const {
+    return eloFromScore(score());
+}
+
+
+/**
+ * @details The interval of the score is the normal approximation over the games played, and is converted to Elo at
+ * both ends.
+ */
+double MatchStats::eloMargin() const {
+    if (games() == 0)
+        return std::numeric_limits<double>::infinity();
+
+    const double deviation = 1.96 * std::sqrt(gameVariance(*this) / games());
+
+    return (eloFromScore(score() + deviation) - eloFromScore(score() - deviation)) / 2;
+}
+
+
+/**
+ * @details Uses the normal approximation of the generalized SPRT: with s the score, σ² the variance of a game and s0,
+ * s1 the expected scores under both hypotheses, LLR = N (s1 - s0) (2s - s0 - s1) / 2σ².
+ */
+double MatchStats::llr(const double elo0, const double elo1) const {
+    const double variance = games() == 0 ? 0 : gameVariance(*this);
+
+    if (variance <= 0)
+        return 0;
+
+    const double s0 = expectedScore(elo0);
+    const double s1 = expectedScore(elo1);
+
+    return games() * (s1 - s0) * (2 * score() - s0 - s1) / (2 * variance);
+}
+
+
+enumSprtVerdict chessqdl::sprtVerdict(const double llr, const double alpha, const double beta) {
+    if (llr >= std::log((1 - beta) / alpha))
+        return nAcceptH1;
+    if (llr <= std::log(beta / (1 - alpha)))
+        return nAcceptH0;
+
+    return nContinue;
+}
+
+
+/**
+ * @details Games are handed out in order by an atomic counter. Game i plays opening i / 2, with the first player as
+ * white when i is even, so both colors are played from every opening.
+ */
+MatchStats chessqdl::playMatch(const PlayerConfig &first, const PlayerConfig &second, const MatchOptions &options,
+                               std::ostream *pgn, const std::function<void(const MatchStats &)> &onGame) {
+    const std::vector<std::string> openings = options.openings.empty() ? std::vector<std::string>{startFen}
+                                                                       : options.openings;
+    const unsigned threads = resolveThreads(options.threads);
+
+    MatchStats stats;
+    std::mutex mutex;
+    std::atomic<int> next = 0;
+    std::atomic<bool> decided = false;
+
+    const auto createEngine = [](const PlayerConfig &config) {
+        auto engine = std::make_unique<Engine>(nWhite, 1, false, false, 0);
+        engine->setHashSize(config.hashSize);
+        engine->setNetwork(config.network);
+        engine->setPieceSquareTables(config.pieceSquareTables);
+        return engine;
+    };
+
+    const auto work = [&] {
+        const auto firstEngine = createEngine(first);
+        const auto secondEngine = createEngine(second);
+
+        for (int i = next++; i < options.games && !decided; i = next++) {
+            const std::string &fen = openings[(i / 2) % openings.size()];
+            const bool firstIsWhite = i % 2 == 0;
+
+            const GameRecord game = firstIsWhite
+                                        ? playGame(*firstEngine, first, *secondEngine, second, fen, options.adjudication)
+                                        : playGame(*secondEngine, second, *firstEngine, first, fen, options.adjudication);
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (game.result == nDrawn)
+                stats.draws++;
+            else if ((game.result == nWhiteWins) == firstIsWhite)
+                stats.wins++;
+            else
+                stats.losses++;
+
+            if (pgn)
+                writePgn(*pgn, game, firstIsWhite ? first.name : second.name, firstIsWhite ? second.name : first.name,
+                         i + 1);
+
+            if (onGame)
+                onGame(stats);
+
+            if (options.sprt && sprtVerdict(stats.llr(options.elo0, options.elo1), options.alpha, options.beta) !=
+                                nContinue)
+                decided = true;
+        }
+    };
+
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 1; t < threads; t++)
+        workers.emplace_back(work);
+
+    work();
+
+    for (auto &worker: workers)
+        worker.join();
+
+    return stats;
+}
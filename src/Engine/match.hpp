@@ -0,0 +1,233 @@
+#ifndef CHESSQDL_MATCH_HPP
+#define CHESSQDL_MATCH_HPP
+
+#include "engine.hpp"
+
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace chessqdl {
+
+    /**
+     * @brief Settings of one side of a match. Searches are bounded by the clock when a time is given, and by the
+     * depth, node and move time limits otherwise
+     */
+    struct PlayerConfig {
+        std::string name = "ChessQDL";
+
+        int depth = 0;
+        long long nodes = 0;
+        long long moveTime = 0;
+
+        /**
+         * @brief Time on the clock at the start of the game and increment per move, in milliseconds
+         */
+        long long time = 0;
+        long long increment = 0;
+
+        size_t hashSize = 16;
+
+        /**
+         * @brief Network used by the evaluation, or null for the handcrafted evaluation
+         */
+        std::shared_ptr<const NnueNetwork> network;
+
+        /**
+         * @brief Piece-square tables of the handcrafted evaluation, or null for the default tables
+         */
+        std::shared_ptr<const PieceSquareTables> pieceSquareTables;
+    };
+
+
+    /**
+     * @brief Rules that end a game before it is over on the board. Scores are in centipawns and plies are counted for
+     * both sides
+     */
+    struct Adjudication {
+        /**
+         * @brief A game is drawn once both sides score it within drawScore for drawPlies plies in a row, from move
+         * drawMoveNumber on
+         */
+        int drawMoveNumber = 40;
+        int drawScore = 10;
+        int drawPlies = 8;
+
+        /**
+         * @brief A game is won once both sides agree for resignPlies plies in a row that one of them is ahead by at least
+         * resignScore
+         */
+        int resignScore = 600;
+        int resignPlies = 4;
+
+        /**
+         * @brief A game that lasts longer than this is drawn
+         */
+        int maxPlies = 400;
+    };
+
+
+    enum enumGameResult {
+        nWhiteWins,
+        nBlackWins,
+        nDrawn
+    };
+
+
+    /**
+     * @brief A finished game
+     */
+    struct GameRecord {
+        /**
+         * @brief Position the game started from
+         */
+        std::string fen;
+
+        /**
+         * @brief Moves of the game in standard algebraic notation
+         */
+        std::vector<std::string> moves;
+
+        enumGameResult result = nDrawn;
+
+        /**
+         * @brief Why the game ended (e.g. "checkmate", "threefold repetition", "adjudication")
+         */
+        std::string termination;
+    };
+
+
+    /**
+     * @brief Plays a game between two engines
+     * @param white  engine playing white
+     * @param whiteConfig  settings of \p white
+     * @param black  engine playing black
+     * @param blackConfig  settings of \p black
+     * @param fen  position the game starts from
+     * @param adjudication  rules that end the game early
+     * @return The finished game
+     */
+    GameRecord playGame(Engine &white, const PlayerConfig &whiteConfig, Engine &black, const PlayerConfig &blackConfig,
+                        const std::string &fen, const Adjudication &adjudication);
+
+
+    /**
+     * @brief Writes a game in PGN
+     * @param output  stream to write to
+     * @param game  game of interest
+     * @param white  name of the white player
+     * @param black  name of the black player
+     * @param round  number of the game in the match
+     */
+    void writePgn(std::ostream &output, const GameRecord &game, const std::string &white, const std::string &black,
+                  int round);
+
+
+    enum enumSprtVerdict {
+        nContinue,
+        nAcceptH0,
+        nAcceptH1
+    };
+
+
+    /**
+     * @brief Results of a match from the point of view of the first player
+     */
+    struct MatchStats {
+        int wins = 0;
+        int losses = 0;
+        int draws = 0;
+
+
+        [[nodiscard]] int games() const;
+
+
+        /**
+         * @brief Average points per game, between 0 and 1
+         */
+        [[nodiscard]] double score() const;
+
+
+        /**
+         * @brief Elo difference matching the score. Infinite when all games were won or lost
+         */
+        [[nodiscard]] double elo() const;
+
+
+        /**
+         * @brief Half width of the 95% confidence interval of the Elo difference
+         */
+        [[nodiscard]] double eloMargin() const;
+
+
+        /**
+         * @brief Log-likelihood ratio of the hypothesis that the Elo difference is elo1 against the hypothesis that it
+         * is elo0
+         * @param elo0  Elo difference under the null hypothesis
+         * @param elo1  Elo difference under the alternative hypothesis
+         * @return The log-likelihood ratio, 0 while the games do not tell the hypotheses apart
+         */
+        [[nodiscard]] double llr(double elo0, double elo1) const;
+    };
+
+
+    /**
+     * @brief Settings of a match
+     */
+    struct MatchOptions {
+        /**
+         * @brief Maximum number of games. Each opening is played twice, once with each color
+         */
+        int games = 100;
+
+        /**
+         * @brief Number of games played at the same time. 0 uses one per hardware thread
+         */
+        unsigned threads = 0;
+
+        /**
+         * @brief Starting positions. The initial position is used when empty
+         */
+        std::vector<std::string> openings;
+
+        Adjudication adjudication;
+
+        /**
+         * @brief Sequential probability ratio test. The match stops as soon as one of the hypotheses is accepted
+         */
+        bool sprt = false;
+        double elo0 = 0;
+        double elo1 = 5;
+        double alpha = 0.05;
+        double beta = 0.05;
+    };
+
+
+    /**
+     * @brief Decides a sequential probability ratio test
+     * @param llr  log-likelihood ratio of the games played so far
+     * @param alpha  probability of accepting H1 when H0 holds
+     * @param beta  probability of accepting H0 when H1 holds
+     * @return Which hypothesis is accepted, if any
+     */
+    enumSprtVerdict sprtVerdict(double llr, double alpha, double beta);
+
+
+    /**
+     * @brief Plays a match between two engine configurations, several games at a time. Every thread owns one engine
+     * of each configuration
+     * @param first  first player, whose results are reported
+     * @param second  second player
+     * @param options  settings of the match
+     * @param pgn  stream the games are written to, in the order they end, or nullptr
+     * @param onGame  called with the results so far after every game, one call at a time
+     * @return Results of the match
+     */
+    MatchStats playMatch(const PlayerConfig &first, const PlayerConfig &second, const MatchOptions &options,
+                         std::ostream *pgn = nullptr, const std::function<void(const MatchStats &)> &onGame = {});
+
+}
+
+#endif //CHESSQDL_MATCH_HPP
@@ -1,5 +1,8 @@
 #include "movegen.hpp"
 #include "utils.hpp"
+#include "instrument.hpp"
+
+#include <algorithm>
 
 
 using namespace chessqdl;
@@ -221,9 +224,10 @@ U64 MoveGenerator::getPawnMoves(const BitboardArray &bitboard, const enumColor c
     const enumColor opponentColor = color == nWhite ? nBlack : nWhite;
     const U64 pawn = bitboard[nPawn] & bitboard[color];
     const U64 initialPawns = pawn & U64(0xffL << (color == nWhite ? 8 : 48));
+    // A pawn cannot jump over the piece standing right in front of it
     const U64 doubleMoves = color == nWhite
-                                ? shiftNorth(shiftNorth(initialPawns))
-                                : shiftSouth(shiftSouth(initialPawns));
+                                ? shiftNorth(shiftNorth(initialPawns) & ~bitboard[nColor])
+                                : shiftSouth(shiftSouth(initialPawns) & ~bitboard[nColor]);
     const U64 attacks = bitboard[opponentColor] & (color == nWhite
                                                        ? shiftNorthEast(pawn) | shiftNorthWest(pawn)
                                                        : shiftSouthEast(pawn) | shiftSouthWest(pawn));
@@ -359,6 +363,79 @@ U64 MoveGenerator::getQueenMoves(const BitboardArray &bitboard, const enumColor
 
 // NOLINTEND(misc-no-recursion)
 
+/**
+ * @details White pawns attack north-east and north-west, black pawns south-east and south-west.
+ */
+U64 MoveGenerator::getPawnAttacks(const U64 pawns, const enumColor color) {
+    return color == nWhite
+               ? shiftNorthEast(pawns) | shiftNorthWest(pawns)
+               : shiftSouthEast(pawns) | shiftSouthWest(pawns);
+}
+
+
+/**
+ * @details Same jumps as getKnightMoves, without excluding squares occupied by allied pieces.
+ */
+U64 MoveGenerator::getKnightAttacks(const U64 knights) {
+    return shiftNorthWest(shiftWest(knights)) | shiftNorthWest(shiftNorth(knights)) |
+           shiftNorthEast(shiftNorth(knights)) | shiftNorthEast(shiftEast(knights)) |
+           shiftSouthEast(shiftEast(knights)) | shiftSouthEast(shiftSouth(knights)) |
+           shiftSouthWest(shiftSouth(knights)) | shiftSouthWest(shiftWest(knights));
+}
+
+
+/**
+ * @details Same steps as getKingMoves, without excluding squares occupied by allied pieces.
+ */
+U64 MoveGenerator::getKingAttacks(const U64 kings) {
+    return shiftNorth(kings) | shiftNorthEast(kings) | shiftEast(kings) | shiftSouthEast(kings) |
+           shiftSouth(kings) | shiftSouthWest(kings) | shiftWest(kings) | shiftNorthWest(kings);
+}
+
+
+/**
+ * @details Occluded fills over the empty squares, shifted one further so that the first blocker of each ray is attacked.
+ */
+U64 MoveGenerator::getBishopAttacks(const U64 sliders, const U64 occupied) {
+    const U64 empty = ~occupied;
+
+    return shiftNorthEast(noEaOccl(sliders, empty)) | shiftSouthEast(soEaOccl(sliders, empty)) |
+           shiftNorthWest(noWeOccl(sliders, empty)) | shiftSouthWest(soWeOccl(sliders, empty));
+}
+
+
+/**
+ * @details Occluded fills over the empty squares, shifted one further so that the first blocker of each ray is attacked.
+ */
+U64 MoveGenerator::getRookAttacks(const U64 sliders, const U64 occupied) {
+    const U64 empty = ~occupied;
+
+    return shiftNorth(nortOccl(sliders, empty)) | shiftSouth(soutOccl(sliders, empty)) |
+           shiftEast(eastOccl(sliders, empty)) | shiftWest(westOccl(sliders, empty));
+}
+
+
+/**
+ * @details Attacks are symmetric, so the attackers of a square are found by generating attacks from the square itself
+ * for each piece type and intersecting them with the pieces of that type. Pawns are the exception: a white pawn attacks
+ * the square if a black pawn standing on the square would attack the white pawn, and vice versa.
+ */
+U64 MoveGenerator::getAttackersTo(const BitboardArray &bitboard, const int square, const U64 occupied) {
+    U64 target;
+    target.set(square);
+
+    const U64 diagonalSliders = bitboard[nBishop] | bitboard[nQueen];
+    const U64 orthogonalSliders = bitboard[nRook] | bitboard[nQueen];
+
+    return (getPawnAttacks(target, nBlack) & bitboard[nPawn] & bitboard[nWhite]) |
+           (getPawnAttacks(target, nWhite) & bitboard[nPawn] & bitboard[nBlack]) |
+           (getKnightAttacks(target) & bitboard[nKnight]) |
+           (getKingAttacks(target) & bitboard[nKing]) |
+           (getBishopAttacks(target, occupied) & diagonalSliders) |
+           (getRookAttacks(target, occupied) & orthogonalSliders);
+}
+
+
 /**
  * @details Identifies all pawns that can promote on next move and generates a list with all possible promotions. Also removes the option to just move without promoting
  */
@@ -421,6 +498,9 @@ std::vector<std::string> MoveGenerator::getPseudoLegalMoves(const BitboardArray
         return white;
     }
 
+    // Timed past the recursion above, so that each move is only counted once
+    CHESSQDL_TIME(nMoveGenTimer);
+
     std::vector<std::string> moves;
     std::vector<std::string> promotions;
 
@@ -494,3 +574,61 @@ std::vector<std::string> MoveGenerator::getPseudoLegalMoves(const BitboardArray
 }
 
 // NOLINTEND(misc-no-recursion)
+
+
+/**
+ * @details The captured piece, if any, is removed from every bitboard that has it before the moving piece is placed.
+ */
+BitboardArray MoveGenerator::playMove(const BitboardArray &bitboard, const enumColor color, const std::string &mv) {
+    return playMove(bitboard, color, packMove(mv));
+}
+
+
+BitboardArray MoveGenerator::playMove(const BitboardArray &bitboard, const enumColor color, const PackedMove packed) {
+    const enumColor enemy = color == nWhite ? nBlack : nWhite;
+    const int from = packed & 0x3f;
+    const int to = (packed >> 6) & 0x3f;
+
+    BitboardArray next = bitboard;
+
+    for (int k = nPawn; k <= nKing; k++)
+        next[k].reset(to);
+    next[enemy].reset(to);
+
+    int piece = nPawn;
+    while (piece < nKing && !next[piece].test(from))
+        piece++;
+
+    const int promotion = (packed >> 12) & 0x7;
+
+    next[piece].reset(from);
+    next[color].reset(from);
+    next[promotion != 0 ? nPawn + promotion : piece].set(to);
+    next[color].set(to);
+    next[nColor] = next[nWhite] | next[nBlack];
+
+    return next;
+}
+
+
+/**
+ * @details See MoveGenerator::getAttackersTo
+ */
+bool MoveGenerator::isKingAttacked(const BitboardArray &bitboard, const enumColor color) {
+    const U64 king = bitboard[nKing] & bitboard[color];
+    const enumColor enemy = color == nWhite ? nBlack : nWhite;
+
+    return king.any() && (getAttackersTo(bitboard, leastSignificantSetBit(king.to_ullong()), bitboard[nColor]) &
+                          bitboard[enemy]).any();
+}
+
+
+std::vector<std::string> MoveGenerator::getLegalMoves(const BitboardArray &bitboard, const enumColor color) {
+    std::vector<std::string> moves = getPseudoLegalMoves(bitboard, color);
+
+    moves.erase(std::remove_if(moves.begin(), moves.end(), [&bitboard, color](const std::string &mv) {
+        return isKingAttacked(playMove(bitboard, color, mv), color);
+    }), moves.end());
+
+    return moves;
+}
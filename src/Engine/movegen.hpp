@@ -208,6 +208,59 @@ namespace chessqdl {
 		static U64 getQueenMoves(const BitboardArray &bitboard, enumColor color);
 
 
+		/**
+		 * @brief Get the squares attacked by a set of pawns
+		 * @param pawns  pawns of interest
+		 * @param color  color of the pawns, which defines the direction of the attacks
+		 * @return Bitboard with all squares attacked by \p pawns, regardless of what stands on them
+		 */
+		static U64 getPawnAttacks(U64 pawns, enumColor color);
+
+
+		/**
+		 * @brief Get the squares attacked by a set of knights
+		 * @param knights  knights of interest
+		 * @return Bitboard with all squares attacked by \p knights, regardless of what stands on them
+		 */
+		static U64 getKnightAttacks(U64 knights);
+
+
+		/**
+		 * @brief Get the squares attacked by a set of kings
+		 * @param kings  kings of interest
+		 * @return Bitboard with all squares attacked by \p kings, regardless of what stands on them
+		 */
+		static U64 getKingAttacks(U64 kings);
+
+
+		/**
+		 * @brief Get the squares attacked diagonally by a set of sliders
+		 * @param sliders  bishops and/or queens of interest
+		 * @param occupied  squares that block the sliders
+		 * @return Bitboard with all squares attacked by \p sliders, including the blockers
+		 */
+		static U64 getBishopAttacks(U64 sliders, U64 occupied);
+
+
+		/**
+		 * @brief Get the squares attacked orthogonally by a set of sliders
+		 * @param sliders  rooks and/or queens of interest
+		 * @param occupied  squares that block the sliders
+		 * @return Bitboard with all squares attacked by \p sliders, including the blockers
+		 */
+		static U64 getRookAttacks(U64 sliders, U64 occupied);
+
+
+		/**
+		 * @brief Get all pieces, of both colors, that attack a square
+		 * @param bitboard  reference to bitboards representing the current board status
+		 * @param square  index of the attacked square
+		 * @param occupied  squares considered occupied. Removing pieces from it reveals the sliders behind them (x-rays)
+		 * @return Bitboard with all attackers of \p square. Pieces that are not in \p occupied may be included
+		 */
+		static U64 getAttackersTo(const BitboardArray &bitboard, int square, U64 occupied);
+
+
 		/**
 		 * @brief Checks for pawns that are about to promote and generates moves for all possible promotions
 		 * @param pawnMoves  all possible pawn moves
@@ -224,6 +277,45 @@ namespace chessqdl {
 		 * @return  a list of all possible moves (e.g "e2e4", "b1c3", etc)
 		 */
 		static std::vector<std::string> getPseudoLegalMoves(const BitboardArray &bitboard, enumColor color);
+
+
+		/**
+		 * @brief Plays a move on a copy of the board. The move is not checked
+		 * @param bitboard  reference to bitboards representing the current board status
+		 * @param color  color of the moving piece
+		 * @param mv  move in algebraic notation (e.g "e2e4", "e7e8q")
+		 * @return Bitboards after the move
+		 */
+		static BitboardArray playMove(const BitboardArray &bitboard, enumColor color, const std::string &mv);
+
+
+		/**
+		 * @brief Plays a packed move on a copy of the board. The move is not checked
+		 * @param bitboard  reference to bitboards representing the current board status
+		 * @param color  color of the moving piece
+		 * @param mv  packed move (see packMove)
+		 * @return Bitboards after the move
+		 */
+		static BitboardArray playMove(const BitboardArray &bitboard, enumColor color, PackedMove mv);
+
+
+		/**
+		 * @brief Checks if the king of a given color is attacked
+		 * @param bitboard  reference to bitboards representing the current board status
+		 * @param color  color of the king
+		 * @return True if the king of \p color is attacked, false if it is not or if there is no such king
+		 */
+		static bool isKingAttacked(const BitboardArray &bitboard, enumColor color);
+
+
+		/**
+		 * @brief Get all legal moves for a given bitboard, that is the pseudo-legal moves that do not leave the king in
+		 * check
+		 * @param bitboard  reference to bitboards representing the current board status
+		 * @param color  current player color
+		 * @return  a list of all legal moves (e.g "e2e4", "b1c3", etc), in the order of getPseudoLegalMoves
+		 */
+		static std::vector<std::string> getLegalMoves(const BitboardArray &bitboard, enumColor color);
 	};
 
 }
@@ -0,0 +1,455 @@
+#include "nnue.hpp"
+#include "psqt.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CHESSQDL_NNUE_AVX2
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#define CHESSQDL_NNUE_SSSE3
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CHESSQDL_NNUE_SSE2
+#endif
+
+using namespace chessqdl;
+
+namespace {
+
+    constexpr char magic[4] = {'C', 'Q', 'N', 'N'};
+    constexpr uint32_t version = 1;
+
+    static_assert(nnueHidden % 32 == 0 && nnueLayer2 % 32 == 0 && nnueLayer3 % 32 == 0,
+                  "layer widths must be multiples of the widest SIMD register");
+
+    /*
+     * Portable kernels. They define the results every SIMD kernel must reproduce.
+     */
+
+    [[maybe_unused]] void addRowScalar(int16_t *accumulator, const int16_t *row) {
+        for (int i = 0; i < nnueHidden; i++)
+            accumulator[i] = static_cast<int16_t>(accumulator[i] + row[i]);
+    }
+
+    [[maybe_unused]] void subRowScalar(int16_t *accumulator, const int16_t *row) {
+        for (int i = 0; i < nnueHidden; i++)
+            accumulator[i] = static_cast<int16_t>(accumulator[i] - row[i]);
+    }
+
+    [[maybe_unused]] void clippedReluScalar(const int16_t *input, uint8_t *output) {
+        for (int i = 0; i < nnueHidden; i++)
+            output[i] = static_cast<uint8_t>(std::clamp<int>(input[i], 0, 127));
+    }
+
+    [[maybe_unused]] int32_t dotScalar(const uint8_t *input, const int8_t *weights, const int size) {
+        int32_t sum = 0;
+
+        for (int i = 0; i < size; i++)
+            sum += input[i] * weights[i];
+
+        return sum;
+    }
+
+#if defined(CHESSQDL_NNUE_AVX2)
+
+    void addRow(int16_t *accumulator, const int16_t *row) {
+        for (int i = 0; i < nnueHidden; i += 16) {
+            const auto acc = reinterpret_cast<__m256i *>(accumulator + i);
+            const __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i));
+            _mm256_storeu_si256(acc, _mm256_add_epi16(_mm256_loadu_si256(acc), r));
+        }
+    }
+
+    void subRow(int16_t *accumulator, const int16_t *row) {
+        for (int i = 0; i < nnueHidden; i += 16) {
+            const auto acc = reinterpret_cast<__m256i *>(accumulator + i);
+            const __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i));
+            _mm256_storeu_si256(acc, _mm256_sub_epi16(_mm256_loadu_si256(acc), r));
+        }
+    }
+
+    void clippedRelu(const int16_t *input, uint8_t *output) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i max = _mm256_set1_epi16(127);
+
+        for (int i = 0; i < nnueHidden; i += 32) {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i + 16));
+            const __m256i packed = _mm256_packus_epi16(_mm256_min_epi16(_mm256_max_epi16(a, zero), max),
+                                                       _mm256_min_epi16(_mm256_max_epi16(b, zero), max));
+            // packus interleaves the 128 bit lanes of its operands
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + i), _mm256_permute4x64_epi64(packed, 0xD8));
+        }
+    }
+
+    int32_t dot(const uint8_t *input, const int8_t *weights, const int size) {
+        const __m256i ones = _mm256_set1_epi16(1);
+        __m256i sum = _mm256_setzero_si256();
+
+        for (int i = 0; i < size; i += 32) {
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i));
+            const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(weights + i));
+            // Pairs of products fit in 16 bits since inputs are at most 127
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(x, w), ones));
+        }
+
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+
+        return _mm_cvtsi128_si32(s);
+    }
+
+#elif defined(CHESSQDL_NNUE_SSSE3) || defined(CHESSQDL_NNUE_SSE2)
+
+    void addRow(int16_t *accumulator, const int16_t *row) {
+        for (int i = 0; i < nnueHidden; i += 8) {
+            const auto acc = reinterpret_cast<__m128i *>(accumulator + i);
+            const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+            _mm_storeu_si128(acc, _mm_add_epi16(_mm_loadu_si128(acc), r));
+        }
+    }
+
+    void subRow(int16_t *accumulator, const int16_t *row) {
+        for (int i = 0; i < nnueHidden; i += 8) {
+            const auto acc = reinterpret_cast<__m128i *>(accumulator + i);
+            const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+            _mm_storeu_si128(acc, _mm_sub_epi16(_mm_loadu_si128(acc), r));
+        }
+    }
+
+    void clippedRelu(const int16_t *input, uint8_t *output) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i max = _mm_set1_epi16(127);
+
+        for (int i = 0; i < nnueHidden; i += 16) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i + 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i),
+                             _mm_packus_epi16(_mm_min_epi16(_mm_max_epi16(a, zero), max),
+                                              _mm_min_epi16(_mm_max_epi16(b, zero), max)));
+        }
+    }
+
+#if defined(CHESSQDL_NNUE_SSSE3)
+
+    int32_t dot(const uint8_t *input, const int8_t *weights, const int size) {
+        const __m128i ones = _mm_set1_epi16(1);
+        __m128i sum = _mm_setzero_si128();
+
+        for (int i = 0; i < size; i += 16) {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+            const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i *>(weights + i));
+            // Pairs of products fit in 16 bits since inputs are at most 127
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_maddubs_epi16(x, w), ones));
+        }
+
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+
+        return _mm_cvtsi128_si32(sum);
+    }
+
+#else
+
+    // SSE2 has no unsigned by signed byte multiplication
+    int32_t dot(const uint8_t *input, const int8_t *weights, const int size) {
+        return dotScalar(input, weights, size);
+    }
+
+#endif
+
+#else
+
+    void addRow(int16_t *accumulator, const int16_t *row) {
+        addRowScalar(accumulator, row);
+    }
+
+    void subRow(int16_t *accumulator, const int16_t *row) {
+        subRowScalar(accumulator, row);
+    }
+
+    void clippedRelu(const int16_t *input, uint8_t *output) {
+        clippedReluScalar(input, output);
+    }
+
+    int32_t dot(const uint8_t *input, const int8_t *weights, const int size) {
+        return dotScalar(input, weights, size);
+    }
+
+#endif
+
+    /**
+     * @brief Applies a hidden layer followed by a clipped ReLU
+     */
+    template<int inputs, int outputs, typename Dot>
+    void hiddenLayer(const uint8_t *input, const std::vector<int8_t> &weights, const std::vector<int32_t> &biases,
+                     uint8_t *output, Dot dotProduct) {
+        for (int i = 0; i < outputs; i++) {
+            const int32_t sum = biases[i] + dotProduct(input, weights.data() + i * inputs, inputs);
+            output[i] = static_cast<uint8_t>(std::clamp(sum >> nnueWeightScaleBits, 0, 127));
+        }
+    }
+
+    /**
+     * @brief Square of the king of a color, or a1 if it has been captured
+     */
+    int kingSquare(const BitboardArray &board, const enumColor color) {
+        const uint64_t king = (board[nKing] & board[color]).to_ullong();
+        return king ? leastSignificantSetBit(king) : 0;
+    }
+
+    template<typename T>
+    void writeValues(std::ofstream &file, const std::vector<T> &values) {
+        file.write(reinterpret_cast<const char *>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    }
+
+    template<typename T>
+    bool readValues(std::ifstream &file, std::vector<T> &values) {
+        return static_cast<bool>(file.read(reinterpret_cast<char *>(values.data()),
+                                           static_cast<std::streamsize>(values.size() * sizeof(T))));
+    }
+
+}
+
+
+bool NnueAccumulator::operator==(const NnueAccumulator &other) const {
+    return values == other.values;
+}
+
+
+/**
+ * @details Own pieces come before enemy pieces, and both the king square and the piece square are mirrored vertically
+ * for black, so that both perspectives share the same weights.
+ */
+int chessqdl::nnueFeatureIndex(const enumColor perspective, const int kingSquare, const enumColor color, const int piece,
+                               const int square) {
+    const int pieceIndex = (piece - nPawn) * 2 + (color == perspective ? 0 : 1);
+
+    return (relativeSquare(perspective, kingSquare) * 10 + pieceIndex) * 64 + relativeSquare(perspective, square);
+}
+
+
+/**
+ * @details The kernels are chosen at compile time from the instruction sets enabled for the target.
+ */
+const char *chessqdl::nnueSimdName() {
+#if defined(CHESSQDL_NNUE_AVX2)
+    return "avx2";
+#elif defined(CHESSQDL_NNUE_SSSE3)
+    return "ssse3";
+#elif defined(CHESSQDL_NNUE_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+
+NnueNetwork::NnueNetwork() : featureBiases(nnueHidden), featureWeights(static_cast<size_t>(nnueInputs) * nnueHidden),
+                             layer2Biases(nnueLayer2), layer2Weights(nnueLayer2 * 2 * nnueHidden),
+                             layer3Biases(nnueLayer3), layer3Weights(nnueLayer3 * nnueLayer2),
+                             outputWeights(nnueLayer3) {
+}
+
+
+/**
+ * @details Parameters are drawn uniformly from ranges small enough to keep the accumulators far from overflowing.
+ */
+void NnueNetwork::randomize(const uint64_t seed) {
+    std::mt19937_64 rng(seed);
+
+    auto fill = [&rng](auto &values, const int low, const int high) {
+        std::uniform_int_distribution<int> distribution(low, high);
+        for (auto &value: values)
+            value = static_cast<std::remove_reference_t<decltype(value)>>(distribution(rng));
+    };
+
+    fill(featureBiases, 0, 64);
+    fill(featureWeights, -8, 8);
+    fill(layer2Biases, -512, 512);
+    fill(layer2Weights, -16, 16);
+    fill(layer3Biases, -512, 512);
+    fill(layer3Weights, -32, 32);
+    outputBias = 0;
+    fill(outputWeights, -64, 64);
+}
+
+
+/**
+ * @details The whole file is read into a temporary network, which only replaces this one if nothing went wrong.
+ */
+bool NnueNetwork::load(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file)
+        return false;
+
+    char fileMagic[4];
+    uint32_t header[5];
+
+    if (!file.read(fileMagic, sizeof(fileMagic)) || std::memcmp(fileMagic, magic, sizeof(magic)) != 0)
+        return false;
+
+    if (!file.read(reinterpret_cast<char *>(header), sizeof(header)))
+        return false;
+
+    if (header[0] != version || header[1] != nnueInputs || header[2] != nnueHidden || header[3] != nnueLayer2 ||
+        header[4] != nnueLayer3)
+        return false;
+
+    NnueNetwork network;
+    std::vector<int32_t> bias(1);
+
+    if (!readValues(file, network.featureBiases) || !readValues(file, network.featureWeights) ||
+        !readValues(file, network.layer2Biases) || !readValues(file, network.layer2Weights) ||
+        !readValues(file, network.layer3Biases) || !readValues(file, network.layer3Weights) ||
+        !readValues(file, bias) || !readValues(file, network.outputWeights))
+        return false;
+
+    // Trailing bytes mean the file was written for a different architecture
+    if (file.peek() != std::ifstream::traits_type::eof())
+        return false;
+
+    network.outputBias = bias[0];
+    *this = std::move(network);
+
+    return true;
+}
+
+
+bool NnueNetwork::save(const std::string &path) const {
+    std::ofstream file(path, std::ios::binary);
+
+    if (!file)
+        return false;
+
+    const uint32_t header[5] = {version, nnueInputs, nnueHidden, nnueLayer2, nnueLayer3};
+
+    file.write(magic, sizeof(magic));
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    writeValues(file, featureBiases);
+    writeValues(file, featureWeights);
+    writeValues(file, layer2Biases);
+    writeValues(file, layer2Weights);
+    writeValues(file, layer3Biases);
+    writeValues(file, layer3Weights);
+    writeValues(file, std::vector<int32_t>{outputBias});
+    writeValues(file, outputWeights);
+
+    return static_cast<bool>(file);
+}
+
+
+/**
+ * @details Starts from the biases and adds the weights of every non-king piece on the board.
+ */
+void NnueNetwork::refreshPerspective(NnueAccumulator &accumulator, const BitboardArray &board,
+                                     const enumColor perspective) const {
+    int16_t *values = accumulator.values[perspective].data();
+    const int king = kingSquare(board, perspective);
+
+    std::copy(featureBiases.begin(), featureBiases.end(), values);
+
+    for (int color = nWhite; color <= nBlack; color++) {
+        for (int piece = nPawn; piece <= nQueen; piece++) {
+            uint64_t pieces = (board[piece] & board[color]).to_ullong();
+
+            while (pieces) {
+                const int feature = nnueFeatureIndex(perspective, king, static_cast<enumColor>(color), piece,
+                                                     leastSignificantSetBit(pieces));
+                addRow(values, featureWeights.data() + static_cast<size_t>(feature) * nnueHidden);
+                pieces &= pieces - 1;
+            }
+        }
+    }
+}
+
+
+NnueAccumulator NnueNetwork::refresh(const BitboardArray &board) const {
+    NnueAccumulator accumulator{};
+
+    refreshPerspective(accumulator, board, nWhite);
+    refreshPerspective(accumulator, board, nBlack);
+
+    return accumulator;
+}
+
+
+/**
+ * @details Kings are not input features, so a king move only changes the features of its own perspective (all of them,
+ * since every feature depends on the king square) and a captured king leaves its perspective without a king.
+ */
+void NnueNetwork::update(NnueAccumulator &accumulator, const BitboardArray &board, const enumColor color,
+                         const int piece, const int landing, const int from, const int to, const int captured) const {
+    const enumColor enemyColor = color == nWhite ? nBlack : nWhite;
+
+    for (int p = nWhite; p <= nBlack; p++) {
+        const auto perspective = static_cast<enumColor>(p);
+
+        if ((piece == nKing && perspective == color) || (captured == nKing && perspective == enemyColor)) {
+            refreshPerspective(accumulator, board, perspective);
+            continue;
+        }
+
+        int16_t *values = accumulator.values[perspective].data();
+        const int king = kingSquare(board, perspective);
+
+        auto row = [&](const enumColor c, const int pc, const int square) {
+            return featureWeights.data() +
+                   static_cast<size_t>(nnueFeatureIndex(perspective, king, c, pc, square)) * nnueHidden;
+        };
+
+        if (piece != nKing) {
+            subRow(values, row(color, piece, from));
+            addRow(values, row(color, landing, to));
+        }
+
+        if (captured >= nPawn && captured != nKing)
+            subRow(values, row(enemyColor, captured, to));
+    }
+}
+
+
+/**
+ * @details The perspective of \p color fills the first half of the hidden layer input, the other perspective the
+ * second half.
+ */
+int NnueNetwork::evaluate(const NnueAccumulator &accumulator, const enumColor color) const {
+    alignas(32) uint8_t input[2 * nnueHidden];
+    alignas(32) uint8_t hidden2[nnueLayer2];
+    alignas(32) uint8_t hidden3[nnueLayer3];
+
+    clippedRelu(accumulator.values[color].data(), input);
+    clippedRelu(accumulator.values[color == nWhite ? nBlack : nWhite].data(), input + nnueHidden);
+
+    hiddenLayer<2 * nnueHidden, nnueLayer2>(input, layer2Weights, layer2Biases, hidden2, dot);
+    hiddenLayer<nnueLayer2, nnueLayer3>(hidden2, layer3Weights, layer3Biases, hidden3, dot);
+
+    return (outputBias + dot(hidden3, outputWeights.data(), nnueLayer3)) / nnueOutputScale;
+}
+
+
+/**
+ * @details Same computation as NnueNetwork::evaluate, with the portable kernels. The accumulator is assumed to be correct,
+ * so only the layers after the feature transformer are checked.
+ */
+int NnueNetwork::evaluateReference(const NnueAccumulator &accumulator, const enumColor color) const {
+    uint8_t input[2 * nnueHidden];
+    uint8_t hidden2[nnueLayer2];
+    uint8_t hidden3[nnueLayer3];
+
+    clippedReluScalar(accumulator.values[color].data(), input);
+    clippedReluScalar(accumulator.values[color == nWhite ? nBlack : nWhite].data(), input + nnueHidden);
+
+    hiddenLayer<2 * nnueHidden, nnueLayer2>(input, layer2Weights, layer2Biases, hidden2, dotScalar);
+    hiddenLayer<nnueLayer2, nnueLayer3>(hidden2, layer3Weights, layer3Biases, hidden3, dotScalar);
+
+    return (outputBias + dotScalar(hidden3, outputWeights.data(), nnueLayer3)) / nnueOutputScale;
+}
@@ -0,0 +1,213 @@
+#ifndef CHESSQDL_NNUE_HPP
+#define CHESSQDL_NNUE_HPP
+
+#include "const.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace chessqdl {
+
+    /**
+     * @brief Number of input features per perspective: own king square x non-king piece (5 types, 2 colors) x square
+     */
+    constexpr int nnueInputs = 64 * 10 * 64;
+
+    /**
+     * @brief Width of the feature transformer, per perspective
+     */
+    constexpr int nnueHidden = 128;
+
+    /**
+     * @brief Width of the first hidden layer after the feature transformer
+     */
+    constexpr int nnueLayer2 = 32;
+
+    /**
+     * @brief Width of the second hidden layer after the feature transformer
+     */
+    constexpr int nnueLayer3 = 32;
+
+    /**
+     * @brief Hidden layer outputs are shifted right by this many bits before being clipped to [0, 127]
+     */
+    constexpr int nnueWeightScaleBits = 6;
+
+    /**
+     * @brief The network output is divided by this value to obtain centipawns
+     */
+    constexpr int nnueOutputScale = 16;
+
+
+    /**
+     * @brief Output of the feature transformer for both perspectives (indexed by nWhite and nBlack). Kept up to date
+     * move by move, so only the small layers after it are computed at the leaves
+     */
+    struct NnueAccumulator {
+        alignas(32) std::array<std::array<int16_t, nnueHidden>, 2> values;
+
+        bool operator==(const NnueAccumulator &other) const;
+    };
+
+
+    /**
+     * @brief Efficiently updatable neural network evaluator with HalfKP-like inputs. <br>
+     *
+     * Architecture: 40960 binary inputs per perspective -> 128 (int16) per perspective, concatenated with the side to
+     * evaluate first -> clipped ReLU -> 32 (int8 weights) -> clipped ReLU -> 32 (int8 weights) -> clipped ReLU -> 1
+     */
+    class NnueNetwork {
+
+    private:
+
+        /**
+         * @brief Feature transformer biases
+         */
+        std::vector<int16_t> featureBiases;
+
+        /**
+         * @brief Feature transformer weights, one row of nnueHidden values per input feature
+         */
+        std::vector<int16_t> featureWeights;
+
+        /**
+         * @brief Biases of the first hidden layer
+         */
+        std::vector<int32_t> layer2Biases;
+
+        /**
+         * @brief Weights of the first hidden layer, one row of 2 * nnueHidden values per output
+         */
+        std::vector<int8_t> layer2Weights;
+
+        /**
+         * @brief Biases of the second hidden layer
+         */
+        std::vector<int32_t> layer3Biases;
+
+        /**
+         * @brief Weights of the second hidden layer, one row of nnueLayer2 values per output
+         */
+        std::vector<int8_t> layer3Weights;
+
+        /**
+         * @brief Bias of the output neuron
+         */
+        int32_t outputBias = 0;
+
+        /**
+         * @brief Weights of the output neuron
+         */
+        std::vector<int8_t> outputWeights;
+
+
+        /**
+         * @brief Recomputes the accumulator of a perspective from the pieces on the board
+         * @param accumulator  accumulator to be refreshed
+         * @param board  current board
+         * @param perspective  perspective to refresh
+         */
+        void refreshPerspective(NnueAccumulator &accumulator, const BitboardArray &board, enumColor perspective) const;
+
+    public:
+
+        /**
+         * @brief Creates a network with every parameter set to zero
+         */
+        NnueNetwork();
+
+
+        /**
+         * @brief Fills the network with small random parameters. Meant for tests, the resulting network plays randomly
+         * @param seed  random number generator seed
+         */
+        void randomize(uint64_t seed);
+
+
+        /**
+         * @brief Reads the parameters from a weights file. <br>
+         *
+         * The file is little endian and holds, in order: the magic "CQNN", a uint32 version (1), four uint32 with the
+         * number of inputs and the widths of the three hidden layers (which must match the compiled architecture), the
+         * int16 feature transformer biases and weights, and then for each of the two hidden layers and the output its
+         * int32 biases followed by its int8 weights, row by row
+         * @param path  path of the weights file
+         * @return True if the file was read successfully. If it was not, the network is left untouched
+         */
+        bool load(const std::string &path);
+
+
+        /**
+         * @brief Writes the parameters in the format read by NnueNetwork::load
+         * @param path  path of the weights file
+         * @return True if the file was written successfully
+         */
+        [[nodiscard]] bool save(const std::string &path) const;
+
+
+        /**
+         * @brief Computes both perspectives of the accumulator from scratch
+         * @param board  board of interest
+         * @return Accumulator of \p board
+         */
+        [[nodiscard]] NnueAccumulator refresh(const BitboardArray &board) const;
+
+
+        /**
+         * @brief Updates an accumulator after a move. A perspective whose king has moved or been captured is refreshed,
+         * the others are updated feature by feature
+         * @param accumulator  accumulator of the position before the move, updated in place
+         * @param board  board after the move
+         * @param color  color of the moving piece
+         * @param piece  type of the moving piece
+         * @param landing  type of the piece on the destination square after the move (differs from \p piece when promoting)
+         * @param from  source square
+         * @param to  destination square
+         * @param captured  type of the captured piece, or -1 if there was no capture
+         */
+        void update(NnueAccumulator &accumulator, const BitboardArray &board, enumColor color, int piece, int landing,
+                    int from, int to, int captured) const;
+
+
+        /**
+         * @brief Runs the layers after the feature transformer, using the SIMD kernels available on the target
+         * @param accumulator  accumulator of the position
+         * @param color  perspective of the evaluation
+         * @return Score of the position for \p color, in centipawns
+         */
+        [[nodiscard]] int evaluate(const NnueAccumulator &accumulator, enumColor color) const;
+
+
+        /**
+         * @brief Portable implementation of NnueNetwork::evaluate, used to validate the SIMD kernels
+         * @param accumulator  accumulator of the position
+         * @param color  perspective of the evaluation
+         * @return Same score as NnueNetwork::evaluate
+         */
+        [[nodiscard]] int evaluateReference(const NnueAccumulator &accumulator, enumColor color) const;
+    };
+
+
+    /**
+     * @brief Index of an input feature
+     * @param perspective  perspective the feature belongs to
+     * @param kingSquare  square of the king of \p perspective
+     * @param color  color of the piece
+     * @param piece  type of the piece (nPawn to nQueen)
+     * @param square  square of the piece
+     * @return Index between 0 and nnueInputs - 1
+     */
+    int nnueFeatureIndex(enumColor perspective, int kingSquare, enumColor color, int piece, int square);
+
+
+    /**
+     * @brief Returns the name of the instruction set used by the inference kernels
+     * @return "avx2", "ssse3", "sse2" or "scalar"
+     */
+    const char *nnueSimdName();
+
+}
+
+#endif //CHESSQDL_NNUE_HPP
@@ -0,0 +1,201 @@
+#include "pawns.hpp"
+#include "movegen.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+
+using namespace chessqdl;
+
+namespace {
+
+    constexpr uint64_t fileA = 0x0101010101010101ULL;
+    constexpr uint64_t fileH = fileA << 7;
+
+    constexpr int doubledPenalty[2] = {10, 20};
+    constexpr int isolatedPenalty[2] = {10, 15};
+    constexpr int backwardPenalty[2] = {8, 10};
+
+    /**
+     * @brief Passed pawn bonus by rank, relative to the color of the pawn (index 1 is the pawn's initial rank)
+     */
+    constexpr int passedBonus[2][8] = {{0, 5, 10, 20, 35, 60, 100, 0},
+                                       {0, 10, 20, 40, 70, 120, 200, 0}};
+
+    /**
+     * @brief Fills every square north of the set bits, including the bits themselves
+     */
+    uint64_t northFill(uint64_t b) {
+        b |= b << 8;
+        b |= b << 16;
+        b |= b << 32;
+        return b;
+    }
+
+    /**
+     * @brief Fills every square south of the set bits, including the bits themselves
+     */
+    uint64_t southFill(uint64_t b) {
+        b |= b >> 8;
+        b |= b >> 16;
+        b |= b >> 32;
+        return b;
+    }
+
+    /**
+     * @brief Squares in front of the given pawns, from the point of view of \p color
+     */
+    uint64_t frontSpan(const uint64_t pawns, const enumColor color) {
+        return color == nWhite ? northFill(pawns << 8) : southFill(pawns >> 8);
+    }
+
+    /**
+     * @brief Squares on the same rank as \p square or behind it, from the point of view of \p color
+     */
+    uint64_t ranksBehind(const int square, const enumColor color) {
+        const int rank = square / 8;
+
+        if (color == nWhite)
+            return rank == 7 ? ~0ULL : (1ULL << ((rank + 1) * 8)) - 1;
+
+        return ~((1ULL << (rank * 8)) - 1);
+    }
+
+    /**
+     * @brief Files next to \p file
+     */
+    uint64_t adjacentFiles(const int file) {
+        return (file > 0 ? fileA << (file - 1) : 0) | (file < 7 ? fileA << (file + 1) : 0);
+    }
+
+}
+
+
+/**
+ * @details Pawns are scored one at a time, from white's perspective: <br>
+ * <b> doubled </b> pawns have an allied pawn in front of them <br>
+ * <b> isolated </b> pawns have no allied pawns on adjacent files <br>
+ * <b> backward </b> pawns cannot be defended by adjacent pawns and cannot advance safely <br>
+ * <b> passed </b> pawns have no pawns in front of them on the same file and no enemy pawns on adjacent files <br>
+ * Each term has a middlegame and an endgame weight.
+ */
+PawnEntry chessqdl::evaluatePawns(const BitboardArray &board) {
+    PawnEntry entry{};
+
+    for (int c = nWhite; c <= nBlack; c++) {
+        const auto color = static_cast<enumColor>(c);
+        const auto enemyColor = color == nWhite ? nBlack : nWhite;
+        const int sign = color == nWhite ? 1 : -1;
+
+        const uint64_t ours = (board[nPawn] & board[color]).to_ullong();
+        const uint64_t theirs = (board[nPawn] & board[enemyColor]).to_ullong();
+        const uint64_t theirAttacks = MoveGenerator::getPawnAttacks(theirs, enemyColor).to_ullong();
+
+        const uint64_t ourAttacks = MoveGenerator::getPawnAttacks(ours, color).to_ullong();
+        entry.attackSpans[color] = color == nWhite ? northFill(ourAttacks) : southFill(ourAttacks);
+
+        uint64_t pawns = ours;
+
+        while (pawns) {
+            const uint64_t pawn = pawns & -pawns;
+            pawns &= pawns - 1;
+
+            const int square = leastSignificantSetBit(pawn);
+            const int file = square % 8;
+            const int relativeRank = color == nWhite ? square / 8 : 7 - square / 8;
+            const uint64_t front = frontSpan(pawn, color);
+            const uint64_t neighbours = adjacentFiles(file);
+
+            int mg = 0;
+            int eg = 0;
+
+            if (front & ours) {
+                mg -= doubledPenalty[0];
+                eg -= doubledPenalty[1];
+            }
+
+            if (!(ours & neighbours)) {
+                mg -= isolatedPenalty[0];
+                eg -= isolatedPenalty[1];
+            } else if (!(ours & neighbours & ranksBehind(square, color))) {
+                // Supporters can only be on adjacent files, beside or behind the pawn
+                const uint64_t stop = color == nWhite ? pawn << 8 : pawn >> 8;
+
+                if (stop & theirAttacks) {
+                    mg -= backwardPenalty[0];
+                    eg -= backwardPenalty[1];
+                }
+            }
+
+            // Only the frontmost of doubled pawns can be passed
+            if (!(front & ours) && !(theirs & (front | ((front << 1) & ~fileA) | ((front >> 1) & ~fileH)))) {
+                entry.passed[color] |= pawn;
+                mg += passedBonus[0][relativeRank];
+                eg += passedBonus[1][relativeRank];
+            }
+
+            entry.mgScore += sign * mg;
+            entry.egScore += sign * eg;
+        }
+    }
+
+    return entry;
+}
+
+
+/**
+ * @details See PawnHashTable::resize
+ */
+PawnHashTable::PawnHashTable(const size_t megabytes) {
+    resize(megabytes);
+}
+
+
+/**
+ * @details See tableEntries.
+ */
+void PawnHashTable::resize(const size_t megabytes) {
+    const size_t entries = tableEntries(megabytes, sizeof(PawnEntry));
+
+    table.assign(entries, PawnEntry{});
+    mask = entries - 1;
+    resetStats();
+}
+
+
+/**
+ * @details Always-replace scheme: pawn structures change rarely during a search, so the entry of the current
+ * structure is almost always the most useful one. Boards without pawns have key zero and match empty entries, which is
+ * fine since an empty entry is exactly the evaluation of a board without pawns
+ */
+const PawnEntry &PawnHashTable::probe(const uint64_t key, const BitboardArray &board) {
+    PawnEntry &entry = table[key & mask];
+
+    probes++;
+
+    if (entry.key == key) {
+        hits++;
+        return entry;
+    }
+
+    entry = evaluatePawns(board);
+    entry.key = key;
+
+    return entry;
+}
+
+
+/**
+ * @details Returns zero if there were no lookups
+ */
+double PawnHashTable::getHitRate() const {
+    return probes == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(probes);
+}
+
+
+/**
+ * @details Resets PawnHashTable::probes and PawnHashTable::hits
+ */
+void PawnHashTable::resetStats() {
+    probes = 0;
+    hits = 0;
+}
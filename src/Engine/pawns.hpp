@@ -0,0 +1,115 @@
+#ifndef CHESSQDL_PAWNS_HPP
+#define CHESSQDL_PAWNS_HPP
+
+#include "const.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace chessqdl {
+
+    /**
+     * @brief Everything the evaluation needs to know about a pawn structure
+     */
+    struct PawnEntry {
+        /**
+         * @brief Pawn-only Zobrist key of the structure
+         */
+        uint64_t key;
+
+        /**
+         * @brief Middlegame score of the structure, from white's perspective, in centipawns
+         */
+        int mgScore;
+
+        /**
+         * @brief Endgame score of the structure, from white's perspective, in centipawns
+         */
+        int egScore;
+
+        /**
+         * @brief Passed pawns of each color (indexed by nWhite and nBlack)
+         */
+        std::array<uint64_t, 2> passed;
+
+        /**
+         * @brief Squares each color's pawns can attack now or after advancing (indexed by nWhite and nBlack)
+         */
+        std::array<uint64_t, 2> attackSpans;
+    };
+
+
+    /**
+     * @brief Evaluates the pawn structure of a board: doubled, isolated, backward and passed pawns
+     * @param board  board of interest
+     * @return Entry describing the pawn structure. Its key is left as zero
+     */
+    PawnEntry evaluatePawns(const BitboardArray &board);
+
+
+    class PawnHashTable {
+
+    private:
+
+        /**
+         * @brief Table entries. The number of entries is always a power of two
+         */
+        std::vector<PawnEntry> table;
+
+        /**
+         * @brief Mask applied to a key to obtain its index in the table
+         */
+        uint64_t mask = 0;
+
+        /**
+         * @brief Number of lookups since the last call to resetStats
+         */
+        uint64_t probes = 0;
+
+        /**
+         * @brief Number of successful lookups since the last call to resetStats
+         */
+        uint64_t hits = 0;
+
+    public:
+
+        /**
+         * @brief Allocates a table of (at most) \p megabytes megabytes
+         * @param megabytes  size of the table in megabytes
+         */
+        explicit PawnHashTable(size_t megabytes = 2);
+
+
+        /**
+         * @brief Reallocates the table with (at most) \p megabytes megabytes. All entries are lost
+         * @param megabytes  new size of the table in megabytes
+         */
+        void resize(size_t megabytes);
+
+
+        /**
+         * @brief Returns the entry of a pawn structure, evaluating and storing it first if it is not in the table
+         * @param key  pawn-only Zobrist key of the structure
+         * @param board  board holding the structure
+         * @return Entry of the structure
+         */
+        const PawnEntry &probe(uint64_t key, const BitboardArray &board);
+
+
+        /**
+         * @brief Get method that returns the fraction of lookups that were found in the table
+         * @return hit rate, between 0 and 1
+         */
+        [[nodiscard]] double getHitRate() const;
+
+
+        /**
+         * @brief Resets the lookup counters
+         */
+        void resetStats();
+    };
+
+}
+
+#endif //CHESSQDL_PAWNS_HPP
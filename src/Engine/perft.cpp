@@ -0,0 +1,219 @@
+#include "perft.hpp"
+#include "movegen.hpp"
+#include "utils.hpp"
+#include "zobrist.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+using namespace chessqdl;
+
+namespace {
+
+    /**
+     * @brief Mixes the depth into a key, so that the same position at different depths uses different entries
+     */
+    uint64_t depthKey(const uint64_t key, const int depth) {
+        return key ^ (static_cast<uint64_t>(depth) * 0x9E3779B97F4A7C15ULL);
+    }
+
+    /**
+     * @brief Plays a move on a copy of the board
+     * @return false if the move leaves the king of \p color in check, in which case \p next must not be used
+     */
+    bool playMove(const BitboardArray &board, const enumColor color, const std::string &mv, BitboardArray &next,
+                  uint64_t &hash) {
+        const enumColor enemy = color == nWhite ? nBlack : nWhite;
+        const PackedMove packed = packMove(mv);
+        const int from = packed & 0x3f;
+        const int to = (packed >> 6) & 0x3f;
+
+        next = board;
+        hash ^= Zobrist::getSideKey();
+
+        if (next[enemy].test(to)) {
+            for (int piece = nPawn; piece <= nKing; piece++) {
+                if (next[piece].test(to)) {
+                    next[piece].reset(to);
+                    hash ^= Zobrist::getPieceKey(enemy, piece, to);
+                    break;
+                }
+            }
+
+            next[enemy].reset(to);
+        }
+
+        int piece = nPawn;
+        while (!next[piece].test(from))
+            piece++;
+
+        int landing = piece;
+        if (const int promotion = (packed >> 12) & 0x7; promotion != 0)
+            landing = nPawn + promotion;
+
+        next[piece].reset(from);
+        next[color].reset(from);
+        next[landing].set(to);
+        next[color].set(to);
+        next[nColor] = next[nWhite] | next[nBlack];
+        hash ^= Zobrist::getPieceKey(color, piece, from) ^ Zobrist::getPieceKey(color, landing, to);
+
+        const U64 king = next[nKing] & next[color];
+
+        return king.none() || (MoveGenerator::getAttackersTo(next, leastSignificantSetBit(king.to_ullong()),
+                                                             next[nColor]) & next[enemy]).none();
+    }
+
+    // NOLINTBEGIN(misc-no-recursion)
+    uint64_t perftNode(const BitboardArray &board, const enumColor toMove, const int depth, const uint64_t hash,
+                       PerftTable *table) {
+        uint64_t nodes = 0;
+
+        if (depth > 1 && table && table->probe(hash, depth, nodes))
+            return nodes;
+
+        const enumColor enemy = toMove == nWhite ? nBlack : nWhite;
+        BitboardArray next;
+
+        for (const auto &mv: MoveGenerator::getPseudoLegalMoves(board, toMove)) {
+            uint64_t nextHash = hash;
+
+            if (playMove(board, toMove, mv, next, nextHash))
+                nodes += depth == 1 ? 1 : perftNode(next, enemy, depth - 1, nextHash, table);
+        }
+
+        if (depth > 1 && table)
+            table->store(hash, depth, nodes);
+
+        return nodes;
+    }
+    // NOLINTEND(misc-no-recursion)
+
+}
+
+
+const std::vector<PerftReference> chessqdl::perftReferences = {
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - - 0 1",                  {20, 400, 8902, 197281}},
+        {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", {46, 2079, 89890}},
+        {"n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",                                {24, 496, 9483, 182838}},
+        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",                              {14, 191}},
+        {"8/P1k5/K7/8/8/8/8/8 w - - 0 1",                                          {6, 27, 273, 1329, 18135}},
+        {"8/k1P5/8/1K6/8/8/8/8 w - - 0 1",                                         {10, 25, 268, 926, 10857}},
+        {"6kq/8/8/8/8/8/8/7K w - - 0 1",                                           {2, 36, 143, 3637, 14893}}
+};
+
+
+/**
+ * @details See tableEntries.
+ */
+PerftTable::PerftTable(const size_t megabytes) {
+    const size_t entries = tableEntries(megabytes, sizeof(Entry));
+
+    table = std::make_unique<Entry[]>(entries);
+    mask = entries - 1;
+
+    for (uint64_t i = 0; i <= mask; i++) {
+        table[i].check.store(0, std::memory_order_relaxed);
+        table[i].count.store(0, std::memory_order_relaxed);
+    }
+}
+
+
+bool PerftTable::probe(const uint64_t key, const int depth, uint64_t &count) const {
+    const uint64_t mixed = depthKey(key, depth);
+    const Entry &entry = table[mixed & mask];
+    const uint64_t stored = entry.count.load(std::memory_order_relaxed);
+
+    if ((entry.check.load(std::memory_order_relaxed) ^ stored) != mixed)
+        return false;
+
+    count = stored;
+
+    return true;
+}
+
+
+void PerftTable::store(const uint64_t key, const int depth, const uint64_t count) {
+    const uint64_t mixed = depthKey(key, depth);
+    Entry &entry = table[mixed & mask];
+
+    entry.check.store(mixed ^ count, std::memory_order_relaxed);
+    entry.count.store(count, std::memory_order_relaxed);
+}
+
+
+uint64_t chessqdl::perft(const BitboardArray &board, const enumColor toMove, const int depth, PerftTable *table) {
+    if (depth <= 0)
+        return 1;
+
+    return perftNode(board, toMove, depth, Zobrist::hashBoard(board, toMove), table);
+}
+
+
+/**
+ * @details Threads take the next root move that nobody has counted yet, so a thread stuck on a large subtree does not
+ * hold back the others. The counts are written to the slot of their move, keeping the generation order.
+ */
+PerftResult chessqdl::perftDivide(const BitboardArray &board, const enumColor toMove, const int depth,
+                                  unsigned threads, const size_t hashMegabytes) {
+    const auto begin = std::chrono::steady_clock::now();
+    const enumColor enemy = toMove == nWhite ? nBlack : nWhite;
+    const uint64_t hash = Zobrist::hashBoard(board, toMove);
+
+    std::vector<BitboardArray> children;
+    std::vector<uint64_t> hashes;
+    PerftResult result;
+
+    for (const auto &mv: MoveGenerator::getPseudoLegalMoves(board, toMove)) {
+        BitboardArray next;
+        uint64_t nextHash = hash;
+
+        if (playMove(board, toMove, mv, next, nextHash)) {
+            children.push_back(next);
+            hashes.push_back(nextHash);
+            result.divide.emplace_back(mv, 1);
+        }
+    }
+
+    std::unique_ptr<PerftTable> table = hashMegabytes > 0 ? std::make_unique<PerftTable>(hashMegabytes) : nullptr;
+    std::atomic<size_t> nextMove = 0;
+
+    const auto work = [&] {
+        for (size_t i = nextMove++; i < children.size(); i = nextMove++)
+            result.divide[i].second = perftNode(children[i], enemy, depth - 1, hashes[i], table.get());
+    };
+
+    if (depth > 1) {
+        threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(resolveThreads(threads),
+                                                                             children.size())));
+
+        std::vector<std::thread> workers;
+
+        for (unsigned t = 1; t < threads; t++)
+            workers.emplace_back(work);
+
+        work();
+
+        for (auto &worker: workers)
+            worker.join();
+    }
+
+    for (const auto &[mv, nodes]: result.divide)
+        result.nodes += nodes;
+
+    result.time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin)
+            .count();
+
+    return result;
+}
+
+
+void chessqdl::printPerft(std::ostream &output, const PerftResult &result) {
+    for (const auto &[mv, nodes]: result.divide)
+        output << mv << ": " << nodes << std::endl;
+
+    output << std::endl << "Nodes: " << result.nodes << std::endl;
+    output << "Time: " << result.time << " ms" << std::endl;
+    output << "Nodes/second: " << result.nodes * 1000 / std::max(1LL, result.time) << std::endl;
+}
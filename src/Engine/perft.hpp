@@ -0,0 +1,145 @@
+#ifndef CHESSQDL_PERFT_HPP
+#define CHESSQDL_PERFT_HPP
+
+#include "const.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace chessqdl {
+
+    /**
+     * @brief Direct-mapped table of perft node counts, keyed by Zobrist hash and depth. <br>
+     *
+     * Entries are two words, the count and the key xor'ed with the count, so an entry torn by a concurrent write fails
+     * the key check instead of returning a wrong count. Threads can share the table without locking
+     */
+    class PerftTable {
+
+    private:
+
+        struct Entry {
+            std::atomic<uint64_t> check;
+            std::atomic<uint64_t> count;
+        };
+
+        /**
+         * @brief Table entries. The number of entries is always a power of two
+         */
+        std::unique_ptr<Entry[]> table;
+
+        /**
+         * @brief Mask applied to a key to obtain its index in the table
+         */
+        uint64_t mask = 0;
+
+    public:
+
+        /**
+         * @brief Allocates a table of (at most) \p megabytes megabytes
+         * @param megabytes  size of the table in megabytes
+         */
+        explicit PerftTable(size_t megabytes);
+
+
+        /**
+         * @brief Looks up the number of leaves below a position
+         * @param key  Zobrist hash of the position
+         * @param depth  remaining depth
+         * @param count  filled with the stored count if the position is found
+         * @return true if the position was found at the same depth, false otherwise
+         */
+        bool probe(uint64_t key, int depth, uint64_t &count) const;
+
+
+        /**
+         * @brief Stores the number of leaves below a position, replacing whatever was stored at its index
+         * @param key  Zobrist hash of the position
+         * @param depth  remaining depth
+         * @param count  number of leaves
+         */
+        void store(uint64_t key, int depth, uint64_t count);
+    };
+
+
+    /**
+     * @brief Outcome of a perft run
+     */
+    struct PerftResult {
+        /**
+         * @brief Total number of leaves
+         */
+        uint64_t nodes = 0;
+
+        /**
+         * @brief Number of leaves below each legal root move, in move generation order
+         */
+        std::vector<std::pair<std::string, uint64_t>> divide;
+
+        /**
+         * @brief Duration of the run in milliseconds
+         */
+        long long time = 0;
+    };
+
+
+    /**
+     * @brief A position with its known perft results
+     */
+    struct PerftReference {
+        std::string fen;
+
+        /**
+         * @brief Number of leaves at depth 1, 2, ...
+         */
+        std::vector<uint64_t> counts;
+    };
+
+
+    /**
+     * @brief Standard perft positions with their published node counts. Castling and en passant are not generated yet,
+     * so only positions and depths where neither move can occur are listed
+     */
+    extern const std::vector<PerftReference> perftReferences;
+
+
+    /**
+     * @brief Counts the leaves of the legal move tree of a position. Leaves at depth 1 are counted without being
+     * visited (bulk counting)
+     * @param board  position of interest
+     * @param toMove  side to move
+     * @param depth  depth of the tree
+     * @param table  table to share counts between transpositions, or nullptr
+     * @return Number of leaves
+     */
+    uint64_t perft(const BitboardArray &board, enumColor toMove, int depth, PerftTable *table = nullptr);
+
+
+    /**
+     * @brief Runs perft with the number of leaves below each root move. Root moves are shared between threads
+     * @param board  position of interest
+     * @param toMove  side to move
+     * @param depth  depth of the tree, at least 1
+     * @param threads  number of threads to use. 0 uses one thread per hardware thread
+     * @param hashMegabytes  size of the table shared by the threads. 0 runs without a table
+     * @return Total and per move node counts, and the duration of the run
+     */
+    PerftResult perftDivide(const BitboardArray &board, enumColor toMove, int depth, unsigned threads = 1,
+                            size_t hashMegabytes = 0);
+
+
+    /**
+     * @brief Prints the result of a perft run: one line per root move, then the totals and the speed
+     * @param output  stream to print to
+     * @param result  result of interest
+     */
+    void printPerft(std::ostream &output, const PerftResult &result);
+
+}
+
+#endif //CHESSQDL_PERFT_HPP
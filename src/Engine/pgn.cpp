@@ -0,0 +1,425 @@
+#include "pgn.hpp"
+#include "analysis.hpp"
+#include "bitboard.hpp"
+#include "movegen.hpp"
+#include "san.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace chessqdl;
+
+namespace {
+
+    /**
+     * @brief Values returned by resultValue for tokens that do not hold a score
+     */
+    constexpr double unknownResult = -1;
+    constexpr double notAResult = -2;
+
+    bool isSpace(const char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    bool isDelimiter(const char c) {
+        return isSpace(c) || c == '{' || c == '}' || c == '(' || c == ')' || c == '[' || c == ']' || c == ';' ||
+               c == '$';
+    }
+
+    /**
+     * @brief Score of a game termination marker from white's point of view, unknownResult for "*" and notAResult for
+     * any other token
+     */
+    double resultValue(const std::string_view token) {
+        if (token == "1-0")
+            return 1;
+        if (token == "0-1")
+            return 0;
+        if (token == "1/2-1/2")
+            return 0.5;
+        if (token == "*")
+            return unknownResult;
+
+        return notAResult;
+    }
+
+    /**
+     * @brief Position of the next line at or after \p from that opens the tag section of a game: a line starting with
+     * '[' whose previous non-blank line does not
+     */
+    size_t nextGameStart(const std::string_view text, const size_t from) {
+        if (from == 0 && !text.empty() && text[0] == '[')
+            return 0;
+
+        for (size_t p = text.find("\n[", from == 0 ? 0 : from - 1); p != std::string_view::npos;
+             p = text.find("\n[", p + 1)) {
+            size_t end = p;
+
+            while (end > 0 && isSpace(text[end - 1]))
+                end--;
+
+            if (end == 0)
+                return p + 1;
+
+            const size_t newline = text.rfind('\n', end - 1);
+            size_t lineStart = newline == std::string_view::npos ? 0 : newline + 1;
+
+            while (text[lineStart] == ' ' || text[lineStart] == '\t')
+                lineStart++;
+
+            if (text[lineStart] != '[')
+                return p + 1;
+        }
+
+        return text.size();
+    }
+
+
+    /**
+     * @brief Reads the games of a part of a PGN text. Moves are buffered until the end of their game, where the
+     * result is known, in a buffer that keeps its capacity from one game to the next
+     */
+    class GameReader {
+
+    private:
+        const PgnCallback &onPosition;
+        const unsigned thread;
+        const BitboardArray startBoard = Bitboard(startFen).getBitBoards();
+
+        PgnStats stats;
+        std::vector<PgnPosition> moves;
+
+        bool hasContent = false;
+        bool inMovetext = false;
+        bool started = false;
+        bool invalid = false;
+        bool truncated = false;
+        std::string fen;
+        double tagResult = unknownResult;
+        double markerResult = unknownResult;
+
+        BitboardArray board{};
+        enumColor toMove = nWhite;
+
+
+        void finishGame() {
+            if (hasContent) {
+                const double result = tagResult != unknownResult ? tagResult : markerResult;
+
+                if (invalid || result == unknownResult) {
+                    stats.skipped++;
+                } else {
+                    for (PgnPosition &position: moves) {
+                        position.result = result;
+                        onPosition(position, thread);
+                    }
+
+                    stats.games++;
+                    stats.positions += static_cast<long long>(moves.size());
+                    stats.truncated += truncated;
+                }
+            }
+
+            moves.clear();
+            hasContent = false;
+            inMovetext = false;
+            started = false;
+            invalid = false;
+            truncated = false;
+            fen.clear();
+            tagResult = unknownResult;
+            markerResult = unknownResult;
+        }
+
+
+        /**
+         * @brief Reads the tag pair that starts at \p i and returns the position right after it
+         */
+        size_t readTag(const std::string_view text, size_t i) {
+            if (inMovetext)
+                finishGame();
+
+            hasContent = true;
+
+            const size_t nameBegin = ++i;
+            while (i < text.size() && !isSpace(text[i]) && text[i] != '"' && text[i] != ']')
+                i++;
+
+            const std::string_view name = text.substr(nameBegin, i - nameBegin);
+
+            while (i < text.size() && text[i] != '"' && text[i] != ']' && text[i] != '\n')
+                i++;
+
+            std::string_view value;
+
+            if (i < text.size() && text[i] == '"') {
+                const size_t valueBegin = ++i;
+
+                while (i < text.size() && text[i] != '"' && text[i] != '\n')
+                    i += text[i] == '\\' ? 2 : 1;
+
+                i = std::min(i, text.size());
+                value = text.substr(valueBegin, i - valueBegin);
+            }
+
+            while (i < text.size() && text[i] != ']' && text[i] != '\n')
+                i++;
+
+            if (name == "FEN")
+                fen = value;
+            else if (name == "Result")
+                tagResult = std::max(resultValue(value), unknownResult);
+
+            return i < text.size() && text[i] == ']' ? i + 1 : i;
+        }
+
+
+        void readMove(const std::string_view san) {
+            inMovetext = true;
+            hasContent = true;
+
+            if (invalid || truncated)
+                return;
+
+            if (!started) {
+                started = true;
+
+                if (fen.empty()) {
+                    board = startBoard;
+                    toMove = nWhite;
+                } else {
+                    std::string validFen, id;
+
+                    if (!parsePosition(fen, validFen, id)) {
+                        invalid = true;
+                        return;
+                    }
+
+                    board = Bitboard(validFen).getBitBoards();
+                    toMove = validFen[validFen.find(' ') + 1] == 'w' ? nWhite : nBlack;
+                }
+            }
+
+            const PackedMove mv = sanToPackedMove(board, toMove, san);
+
+            if (mv == nullMove) {
+                truncated = true;
+                return;
+            }
+
+            moves.push_back({board, toMove, mv, static_cast<int>(moves.size()), 0});
+            board = MoveGenerator::playMove(board, toMove, mv);
+            toMove = toMove == nWhite ? nBlack : nWhite;
+        }
+
+
+        void readToken(std::string_view token) {
+            if (const double result = resultValue(token); result != notAResult) {
+                markerResult = result;
+                finishGame();
+                return;
+            }
+
+            // Move numbers, possibly glued to the move that follows them (e.g. "12.", "12...", "12.Nf3")
+            if (token[0] >= '0' && token[0] <= '9') {
+                const size_t move = token.find_first_not_of("0123456789.");
+
+                if (move == std::string_view::npos)
+                    return;
+
+                token.remove_prefix(move);
+            }
+
+            readMove(token);
+        }
+
+    public:
+        GameReader(const PgnCallback &onPosition, const unsigned thread) : onPosition(onPosition), thread(thread) {
+        }
+
+
+        PgnStats read(const std::string_view text) {
+            size_t i = 0;
+
+            while (i < text.size()) {
+                const char c = text[i];
+
+                if (isSpace(c) || c == ')' || c == ']' || c == '}') {
+                    i++;
+                } else if (c == '%' && (i == 0 || text[i - 1] == '\n')) {
+                    i = std::min(text.find('\n', i), text.size());
+                } else if (c == ';') {
+                    i = std::min(text.find('\n', i), text.size());
+                } else if (c == '{') {
+                    i = std::min(text.find('}', i), text.size());
+                } else if (c == '[') {
+                    i = readTag(text, i);
+                } else if (c == '$') {
+                    i++;
+
+                    while (i < text.size() && text[i] >= '0' && text[i] <= '9')
+                        i++;
+                } else if (c == '(') {
+                    // Variations, which may be nested and hold comments
+                    int depth = 0;
+
+                    for (; i < text.size(); i++) {
+                        if (text[i] == '{')
+                            i = std::min(text.find('}', i), text.size() - 1);
+                        else if (text[i] == '(')
+                            depth++;
+                        else if (text[i] == ')' && --depth == 0)
+                            break;
+                    }
+                } else {
+                    const size_t begin = i;
+
+                    while (i < text.size() && !isDelimiter(text[i]))
+                        i++;
+
+                    readToken(text.substr(begin, i - begin));
+                }
+            }
+
+            finishGame();
+
+            return stats;
+        }
+    };
+
+}
+
+
+MappedFile::MappedFile(const std::string &path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd < 0)
+        return;
+
+    struct stat status{};
+
+    if (fstat(fd, &status) == 0) {
+        size = static_cast<size_t>(status.st_size);
+
+        if (size == 0) {
+            mapped = true;
+        } else if (void *address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0); address != MAP_FAILED) {
+            data = static_cast<const char *>(address);
+            mapped = true;
+            madvise(address, size, MADV_SEQUENTIAL);
+        }
+    }
+
+    ::close(fd);
+}
+
+
+MappedFile::~MappedFile() {
+    if (data)
+        munmap(const_cast<char *>(data), size);
+}
+
+
+bool MappedFile::isOpen() const {
+    return mapped;
+}
+
+
+std::string_view MappedFile::view() const {
+    return {data, data ? size : 0};
+}
+
+
+PgnStats &PgnStats::operator+=(const PgnStats &other) {
+    games += other.games;
+    positions += other.positions;
+    truncated += other.truncated;
+    skipped += other.skipped;
+
+    return *this;
+}
+
+
+/**
+ * @details Tags other than FEN and Result are ignored, as are comments, variations, numeric annotation glyphs and
+ * escaped lines. The result is taken from the Result tag, or from the game termination marker when the tag is missing
+ * or holds "*". <br>
+ *
+ * Games are separated either by their termination marker or by the tag section of the next game. Moves are decoded by
+ * matching them against the legal moves, so castling and en passant, which are not generated, end the decoding of a
+ * game.
+ */
+PgnStats chessqdl::readPgn(const std::string_view text, const PgnCallback &onPosition) {
+    return GameReader(onPosition, 0).read(text);
+}
+
+
+/**
+ * @details Each part ends where a game starts: at a line starting with '[' that follows movetext. Parts are cut at
+ * evenly spaced offsets, moved forward to the next game.
+ */
+std::vector<std::string_view> chessqdl::splitPgn(const std::string_view text, const size_t parts) {
+    std::vector<std::string_view> split;
+    size_t begin = 0;
+
+    for (size_t k = 1; k < parts; k++) {
+        const size_t start = nextGameStart(text, std::max(begin + 1, text.size() * k / parts));
+
+        if (start >= text.size())
+            break;
+
+        split.push_back(text.substr(begin, start - begin));
+        begin = start;
+    }
+
+    split.push_back(text.substr(begin));
+
+    return split;
+}
+
+
+/**
+ * @details The file is cut into several parts per thread, which threads take in turn, so that a part full of long
+ * games does not hold back the others.
+ */
+bool chessqdl::readPgnFile(const std::string &path, const PgnCallback &onPosition, PgnStats &stats, unsigned threads) {
+    const MappedFile file(path);
+
+    if (!file.isOpen())
+        return false;
+
+    threads = resolveThreads(threads);
+
+    const std::vector<std::string_view> parts = splitPgn(file.view(), static_cast<size_t>(threads) * 8);
+    std::vector<PgnStats> threadStats(threads);
+    std::atomic<size_t> next = 0;
+
+    const auto work = [&](const unsigned t) {
+        for (size_t i = next++; i < parts.size(); i = next++)
+            threadStats[t] += GameReader(onPosition, t).read(parts[i]);
+    };
+
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 1; t < threads; t++)
+        workers.emplace_back(work, t);
+
+    work(0);
+
+    for (auto &worker: workers)
+        worker.join();
+
+    stats = PgnStats();
+
+    for (const PgnStats &s: threadStats)
+        stats += s;
+
+    return true;
+}
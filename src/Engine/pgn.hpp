@@ -0,0 +1,134 @@
+#ifndef CHESSQDL_PGN_HPP
+#define CHESSQDL_PGN_HPP
+
+#include "const.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace chessqdl {
+
+    /**
+     * @brief Read-only memory mapping of a whole file
+     */
+    class MappedFile {
+
+    private:
+        const char *data = nullptr;
+        size_t size = 0;
+        bool mapped = false;
+
+    public:
+        /**
+         * @brief Maps the file at \p path. Pages are read by the kernel as they are accessed
+         * @param path  path of the file
+         */
+        explicit MappedFile(const std::string &path);
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        ~MappedFile();
+
+
+        /**
+         * @brief Checks if the file could be mapped
+         */
+        [[nodiscard]] bool isOpen() const;
+
+
+        /**
+         * @brief Contents of the file, valid as long as the mapping is alive
+         */
+        [[nodiscard]] std::string_view view() const;
+    };
+
+
+    /**
+     * @brief A move of a game, along with the position it was played from and the result of the game
+     */
+    struct PgnPosition {
+        BitboardArray board;
+        enumColor toMove;
+        PackedMove move;
+
+        /**
+         * @brief Number of moves played before this one in the game
+         */
+        int ply;
+
+        /**
+         * @brief Result of the game from white's point of view (1 for a win, 0.5 for a draw, 0 for a loss)
+         */
+        double result;
+    };
+
+
+    /**
+     * @brief Counters of a PGN read
+     */
+    struct PgnStats {
+        /**
+         * @brief Games whose moves were reported
+         */
+        long long games = 0;
+
+        long long positions = 0;
+
+        /**
+         * @brief Games with a move that could not be decoded (illegal, ambiguous, castling or en passant). The moves
+         * before it are still reported
+         */
+        long long truncated = 0;
+
+        /**
+         * @brief Games without a result or with an invalid FEN tag, none of whose moves are reported
+         */
+        long long skipped = 0;
+
+        PgnStats &operator+=(const PgnStats &other);
+    };
+
+
+    /**
+     * @brief Called once for each move read, with the index of the thread that read it. The moves of a game are
+     * reported in order, by one thread
+     */
+    using PgnCallback = std::function<void(const PgnPosition &position, unsigned thread)>;
+
+
+    /**
+     * @brief Reads the games of a PGN text and reports every move of every game with a result
+     * @param text  games to read
+     * @param onPosition  called for every move, always with thread 0
+     * @return Counters of the read
+     */
+    PgnStats readPgn(std::string_view text, const PgnCallback &onPosition);
+
+
+    /**
+     * @brief Splits a PGN text into parts that each start at the beginning of a game
+     * @param text  games to split
+     * @param parts  number of parts wanted. Fewer are returned when there are not enough games
+     * @return Consecutive parts that cover all of \p text
+     */
+    std::vector<std::string_view> splitPgn(std::string_view text, size_t parts);
+
+
+    /**
+     * @brief Maps a PGN file into memory and reads its games in parallel, each thread taking the next part of the
+     * file that starts at a game boundary
+     * @param path  path of the file
+     * @param onPosition  called for every move. It is called by several threads at the same time
+     * @param stats  filled with the counters of the read
+     * @param threads  number of threads to use. 0 uses one thread per hardware thread
+     * @return False if the file could not be mapped
+     */
+    bool readPgnFile(const std::string &path, const PgnCallback &onPosition, PgnStats &stats, unsigned threads = 0);
+
+}
+
+#endif //CHESSQDL_PGN_HPP
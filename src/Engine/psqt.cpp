@@ -0,0 +1,244 @@
+#include "psqt.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+using namespace chessqdl;
+
+namespace {
+
+    typedef std::array<int, 64> Diagram;
+
+    /**
+     * @brief Names of the pieces in the weights file. Indexing follows enumPiece
+     */
+    const std::array<std::string, 9> pieceNames = {"", "", "", "pawn", "knight", "bishop", "rook", "queen", "king"};
+
+    /*
+     * Tables are written as seen from white's side of the board: the first row is the eighth rank.
+     */
+
+    constexpr Diagram pawnMg = {
+              0,   0,   0,   0,   0,   0,   0,   0,
+             50,  50,  50,  50,  50,  50,  50,  50,
+             10,  10,  20,  30,  30,  20,  10,  10,
+              5,   5,  10,  25,  25,  10,   5,   5,
+              0,   0,   0,  20,  20,   0,   0,   0,
+              5,  -5, -10,   0,   0, -10,  -5,   5,
+              5,  10,  10, -20, -20,  10,  10,   5,
+              0,   0,   0,   0,   0,   0,   0,   0};
+
+    constexpr Diagram pawnEg = {
+              0,   0,   0,   0,   0,   0,   0,   0,
+             40,  40,  40,  40,  40,  40,  40,  40,
+             25,  25,  25,  25,  25,  25,  25,  25,
+             15,  15,  15,  15,  15,  15,  15,  15,
+              8,   8,   8,   8,   8,   8,   8,   8,
+              3,   3,   3,   3,   3,   3,   3,   3,
+              0,   0,   0,   0,   0,   0,   0,   0,
+              0,   0,   0,   0,   0,   0,   0,   0};
+
+    constexpr Diagram knight = {
+            -50, -40, -30, -30, -30, -30, -40, -50,
+            -40, -20,   0,   0,   0,   0, -20, -40,
+            -30,   0,  10,  15,  15,  10,   0, -30,
+            -30,   5,  15,  20,  20,  15,   5, -30,
+            -30,   0,  15,  20,  20,  15,   0, -30,
+            -30,   5,  10,  15,  15,  10,   5, -30,
+            -40, -20,   0,   5,   5,   0, -20, -40,
+            -50, -40, -30, -30, -30, -30, -40, -50};
+
+    constexpr Diagram bishop = {
+            -20, -10, -10, -10, -10, -10, -10, -20,
+            -10,   0,   0,   0,   0,   0,   0, -10,
+            -10,   0,   5,  10,  10,   5,   0, -10,
+            -10,   5,   5,  10,  10,   5,   5, -10,
+            -10,   0,  10,  10,  10,  10,   0, -10,
+            -10,  10,  10,  10,  10,  10,  10, -10,
+            -10,   5,   0,   0,   0,   0,   5, -10,
+            -20, -10, -10, -10, -10, -10, -10, -20};
+
+    constexpr Diagram rookMg = {
+              0,   0,   0,   0,   0,   0,   0,   0,
+              5,  10,  10,  10,  10,  10,  10,   5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+              0,   0,   0,   5,   5,   0,   0,   0};
+
+    constexpr Diagram rookEg = {
+              0,   0,   0,   0,   0,   0,   0,   0,
+             10,  10,  10,  10,  10,  10,  10,  10,
+              0,   0,   0,   0,   0,   0,   0,   0,
+              0,   0,   0,   0,   0,   0,   0,   0,
+              0,   0,   0,   0,   0,   0,   0,   0,
+              0,   0,   0,   0,   0,   0,   0,   0,
+              0,   0,   0,   0,   0,   0,   0,   0,
+              0,   0,   0,   0,   0,   0,   0,   0};
+
+    constexpr Diagram queen = {
+            -20, -10, -10,  -5,  -5, -10, -10, -20,
+            -10,   0,   0,   0,   0,   0,   0, -10,
+            -10,   0,   5,   5,   5,   5,   0, -10,
+             -5,   0,   5,   5,   5,   5,   0,  -5,
+              0,   0,   5,   5,   5,   5,   0,  -5,
+            -10,   5,   5,   5,   5,   5,   0, -10,
+            -10,   0,   5,   0,   0,   0,   0, -10,
+            -20, -10, -10,  -5,  -5, -10, -10, -20};
+
+    constexpr Diagram kingMg = {
+            -30, -40, -40, -50, -50, -40, -40, -30,
+            -30, -40, -40, -50, -50, -40, -40, -30,
+            -30, -40, -40, -50, -50, -40, -40, -30,
+            -30, -40, -40, -50, -50, -40, -40, -30,
+            -20, -30, -30, -40, -40, -30, -30, -20,
+            -10, -20, -20, -20, -20, -20, -20, -10,
+             20,  20,   0,   0,   0,   0,  20,  20,
+             20,  30,  10,   0,   0,  10,  30,  20};
+
+    constexpr Diagram kingEg = {
+            -50, -40, -30, -20, -20, -30, -40, -50,
+            -30, -20, -10,   0,   0, -10, -20, -30,
+            -30, -10,  20,  30,  30,  20, -10, -30,
+            -30, -10,  30,  40,  40,  30, -10, -30,
+            -30, -10,  30,  40,  40,  30, -10, -30,
+            -30, -10,  20,  30,  30,  20, -10, -30,
+            -30, -30,   0,   0,   0,   0, -30, -30,
+            -50, -30, -30, -30, -30, -30, -30, -50};
+
+    /**
+     * @brief Converts a diagram, whose first row is the eighth rank, to a table indexed by square
+     */
+    constexpr std::array<int, 64> fromDiagram(const Diagram &diagram) {
+        std::array<int, 64> table{};
+
+        for (int square = 0; square < 64; square++)
+            table[square] = diagram[square ^ 56];
+
+        return table;
+    }
+
+    constexpr PieceSquareTables makeDefaultTables() {
+        PieceSquareTables tables{};
+
+        tables.mg[nPawn] = fromDiagram(pawnMg);
+        tables.eg[nPawn] = fromDiagram(pawnEg);
+        tables.mg[nKnight] = tables.eg[nKnight] = fromDiagram(knight);
+        tables.mg[nBishop] = tables.eg[nBishop] = fromDiagram(bishop);
+        tables.mg[nRook] = fromDiagram(rookMg);
+        tables.eg[nRook] = fromDiagram(rookEg);
+        tables.mg[nQueen] = tables.eg[nQueen] = fromDiagram(queen);
+        tables.mg[nKing] = fromDiagram(kingMg);
+        tables.eg[nKing] = fromDiagram(kingEg);
+
+        return tables;
+    }
+
+    constexpr PieceSquareTables defaultTables = makeDefaultTables();
+
+    // e2 is the fifth square of the second rank
+    static_assert(defaultTables.mg[nPawn][12] == -20, "piece-square tables must be indexed from a1");
+
+}
+
+
+/**
+ * @details The default tables are generated at compile time from the diagrams above
+ */
+const PieceSquareTables &chessqdl::getDefaultPieceSquareTables() {
+    return defaultTables;
+}
+
+
+/**
+ * @details The deleter does nothing, since the default tables are never freed
+ */
+const std::shared_ptr<const PieceSquareTables> &chessqdl::getSharedDefaultPieceSquareTables() {
+    static const std::shared_ptr<const PieceSquareTables> shared(&defaultTables, [](const PieceSquareTables *) {});
+    return shared;
+}
+
+
+/**
+ * @details The weights file is a sequence of tables. Each table starts with a header made of a phase (mg or eg) and a
+ * piece name (pawn, knight, bishop, rook, queen or king), followed by 64 integers written as seen from white's side of
+ * the board: the first eight values are the eighth rank, from a8 to h8. Everything after a '#' on a line is ignored.
+ */
+bool chessqdl::loadPieceSquareTables(const std::string &path, PieceSquareTables &tables) {
+    std::ifstream file(path);
+
+    if (!file)
+        return false;
+
+    std::vector<std::string> tokens;
+    std::string line;
+
+    while (std::getline(file, line)) {
+        std::istringstream stream(line.substr(0, line.find('#')));
+        std::string token;
+
+        while (stream >> token)
+            tokens.push_back(token);
+    }
+
+    PieceSquareTables loaded = tables;
+    size_t i = 0;
+
+    while (i < tokens.size()) {
+        if (i + 2 + 64 > tokens.size())
+            return false;
+
+        const std::string &phase = tokens[i++];
+        const std::string &name = tokens[i++];
+
+        if (phase != "mg" && phase != "eg")
+            return false;
+
+        int piece = nPawn;
+        while (piece <= nKing && pieceNames[piece] != name)
+            piece++;
+
+        if (piece > nKing)
+            return false;
+
+        Diagram diagram{};
+
+        for (int &value: diagram) {
+            std::istringstream stream(tokens[i++]);
+
+            if (!(stream >> value) || !stream.eof())
+                return false;
+        }
+
+        (phase == "mg" ? loaded.mg : loaded.eg)[piece] = fromDiagram(diagram);
+    }
+
+    tables = loaded;
+
+    return true;
+}
+
+
+/**
+ * @details Tables are written in the same layout they are read in, one rank per line
+ */
+void chessqdl::writePieceSquareTables(std::ostream &out, const PieceSquareTables &tables) {
+    for (int phase = 0; phase < 2; phase++) {
+        for (int piece = nPawn; piece <= nKing; piece++) {
+            const auto &table = (phase == 0 ? tables.mg : tables.eg)[piece];
+
+            out << (phase == 0 ? "mg " : "eg ") << pieceNames[piece] << "\n";
+
+            for (int rank = 7; rank >= 0; rank--) {
+                for (int file = 0; file < 8; file++)
+                    out << (file ? " " : "") << table[rank * 8 + file];
+                out << "\n";
+            }
+
+            out << "\n";
+        }
+    }
+}
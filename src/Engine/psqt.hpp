@@ -0,0 +1,74 @@
+#ifndef CHESSQDL_PSQT_HPP
+#define CHESSQDL_PSQT_HPP
+
+#include "const.hpp"
+
+#include <array>
+#include <memory>
+#include <ostream>
+#include <string>
+
+namespace chessqdl {
+
+    /**
+     * @brief Bonus of a piece standing on a square, in centipawns. Indexed by enumPiece and then by square (a1 to h8),
+     * from white's point of view
+     */
+    typedef std::array<std::array<int, 64>, 9> PieceSquareTable;
+
+
+    /**
+     * @brief Middlegame and endgame piece-square tables
+     */
+    struct PieceSquareTables {
+        PieceSquareTable mg;
+        PieceSquareTable eg;
+    };
+
+
+    /**
+     * @brief Maps a square to the square seen by white, so that both colors can share the same tables
+     * @param color  color of the piece
+     * @param square  square the piece stands on
+     * @return \p square for white, \p square mirrored vertically for black
+     */
+    constexpr int relativeSquare(const enumColor color, const int square) {
+        return color == nWhite ? square : square ^ 56;
+    }
+
+
+    /**
+     * @brief Returns the tables that are built into the engine
+     * @return Default piece-square tables
+     */
+    const PieceSquareTables &getDefaultPieceSquareTables();
+
+
+    /**
+     * @brief Returns the default tables as a shared pointer, for the engines that have not loaded their own. The pointer
+     * does not own the tables, which are static
+     * @return Default piece-square tables
+     */
+    const std::shared_ptr<const PieceSquareTables> &getSharedDefaultPieceSquareTables();
+
+
+    /**
+     * @brief Reads the tables of a weights file into \p tables. Tables that are not in the file keep their current
+     * values
+     * @param path  path of the weights file
+     * @param tables  tables to update
+     * @return True if the file was read successfully. If it was not, \p tables is left untouched
+     */
+    bool loadPieceSquareTables(const std::string &path, PieceSquareTables &tables);
+
+
+    /**
+     * @brief Writes piece-square tables in the weights file format read by loadPieceSquareTables
+     * @param out  output stream
+     * @param tables  tables to write
+     */
+    void writePieceSquareTables(std::ostream &out, const PieceSquareTables &tables);
+
+}
+
+#endif //CHESSQDL_PSQT_HPP
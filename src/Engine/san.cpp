@@ -0,0 +1,289 @@
+#include "san.hpp"
+#include "movegen.hpp"
+#include "utils.hpp"
+
+#include <cctype>
+
+using namespace chessqdl;
+
+namespace {
+
+    constexpr char pieceLetters[] = "   PNBRQK";
+
+    /**
+     * @brief Longest move text read or written, without hyphens and suffixes (e.g. "e7xd8=Q" is 7 characters)
+     */
+    constexpr size_t maxMoveLength = 8;
+
+    int pieceAt(const BitboardArray &board, const int square) {
+        for (int piece = nPawn; piece <= nKing; piece++) {
+            if (board[piece].test(square))
+                return piece;
+        }
+
+        return -1;
+    }
+
+    bool isFile(const char c) {
+        return c >= 'a' && c <= 'h';
+    }
+
+    bool isRank(const char c) {
+        return c >= '1' && c <= '8';
+    }
+
+    /**
+     * @brief Checks that a pseudo-legal move does not leave the king of the side to move attacked
+     */
+    bool isLegal(const BitboardArray &board, const enumColor toMove, const std::string &mv) {
+        return !MoveGenerator::isKingAttacked(MoveGenerator::playMove(board, toMove, mv), toMove);
+    }
+
+    /**
+     * @brief "+" if the move gives check, "#" if it mates, and nothing otherwise
+     */
+    const char *checkSuffix(const BitboardArray &board, const enumColor toMove, const std::string &mv) {
+        const enumColor enemy = toMove == nWhite ? nBlack : nWhite;
+        const BitboardArray next = MoveGenerator::playMove(board, toMove, mv);
+
+        if (!MoveGenerator::isKingAttacked(next, enemy))
+            return "";
+
+        return MoveGenerator::getLegalMoves(next, enemy).empty() ? "#" : "+";
+    }
+
+}
+
+
+/**
+ * @details The move is split into piece letter, disambiguation, destination square and promotion. The squares its
+ * piece could come from are found with the attack sets of the destination square, as MoveGenerator would generate them,
+ * so that no move list is built. Only those candidates are checked for legality, which is the expensive part. Castling
+ * is not generated, so "O-O" and "O-O-O" never match.
+ */
+PackedMove chessqdl::sanToPackedMove(const BitboardArray &board, const enumColor toMove, std::string_view san) {
+    while (!san.empty() && std::string_view("+#!?").find(san.back()) != std::string_view::npos)
+        san.remove_suffix(1);
+
+    // Long algebraic notation separates the squares with a hyphen
+    char text[maxMoveLength];
+    size_t size = 0;
+
+    for (const char c: san) {
+        if (c == '-')
+            continue;
+        if (size == maxMoveLength)
+            return nullMove;
+
+        text[size++] = c;
+    }
+
+    int piece = nPawn;
+    char fromFile = 0;
+    char fromRank = 0;
+    char promotion = 0;
+
+    // Coordinate notation
+    if ((size == 4 || size == 5) && isFile(text[0]) && isRank(text[1]) && isFile(text[2]) && isRank(text[3])) {
+        fromFile = text[0];
+        fromRank = text[1];
+        piece = pieceAt(board, (fromRank - '1') * 8 + fromFile - 'a');
+
+        if (size == 5)
+            promotion = static_cast<char>(std::tolower(text[4]));
+        size = 4;
+    } else {
+        size_t begin = 0;
+
+        if (size > 0 && std::string_view("NBRQK").find(text[0]) != std::string_view::npos) {
+            piece = static_cast<int>(std::string_view(pieceLetters).find(text[0]));
+            begin = 1;
+        }
+
+        if (size > begin + 2 && std::string_view("NBRQ").find(text[size - 1]) != std::string_view::npos) {
+            promotion = static_cast<char>(std::tolower(text[size - 1]));
+            size--;
+
+            if (text[size - 1] == '=')
+                size--;
+        }
+
+        if (size < begin + 2 || !isFile(text[size - 2]) || !isRank(text[size - 1]))
+            return nullMove;
+
+        for (size_t i = begin; i + 2 < size; i++) {
+            if (isFile(text[i]))
+                fromFile = text[i];
+            else if (isRank(text[i]))
+                fromRank = text[i];
+            else if (text[i] != 'x' && text[i] != ':')
+                return nullMove;
+        }
+    }
+
+    const int to = (text[size - 1] - '1') * 8 + text[size - 2] - 'a';
+    const enumColor enemy = toMove == nWhite ? nBlack : nWhite;
+    const size_t promotionPiece = std::string_view(" nbrq").find(promotion ? promotion : ' ');
+    const bool lastRank = to / 8 == (toMove == nWhite ? 7 : 0);
+
+    // Pawns promote exactly when they reach the last rank, and other pieces never do
+    if (piece < nPawn || board[toMove].test(to) || promotionPiece == std::string_view::npos ||
+        (promotionPiece != 0) != (piece == nPawn && lastRank))
+        return nullMove;
+
+    U64 target;
+    target.set(to);
+    U64 origins;
+
+    switch (piece) {
+        case nPawn:
+            if (board[enemy].test(to)) {
+                origins = MoveGenerator::getPawnAttacks(target, enemy);
+            } else if (!board[nColor].test(to)) {
+                // A double push starts on the second rank and crosses an empty square
+                const int behind = toMove == nWhite ? to - 8 : to + 8;
+                const int start = toMove == nWhite ? 1 : 6;
+
+                if (behind >= 0 && behind < 64) {
+                    origins.set(behind);
+
+                    if (behind / 8 == start + (toMove == nWhite ? 1 : -1) && !board[nColor].test(behind))
+                        origins.set(toMove == nWhite ? behind - 8 : behind + 8);
+                }
+            }
+            break;
+        case nKnight:
+            origins = MoveGenerator::getKnightAttacks(target);
+            break;
+        case nBishop:
+            origins = MoveGenerator::getBishopAttacks(target, board[nColor]);
+            break;
+        case nRook:
+            origins = MoveGenerator::getRookAttacks(target, board[nColor]);
+            break;
+        case nQueen:
+            origins = MoveGenerator::getBishopAttacks(target, board[nColor]) |
+                      MoveGenerator::getRookAttacks(target, board[nColor]);
+            break;
+        default:
+            origins = MoveGenerator::getKingAttacks(target);
+            break;
+    }
+
+    origins &= board[piece] & board[toMove];
+
+    PackedMove found = nullMove;
+
+    while (origins.any()) {
+        const int from = leastSignificantSetBit(origins.to_ullong());
+        origins.reset(from);
+
+        const auto mv = static_cast<PackedMove>(from | to << 6 | promotionPiece << 12);
+
+        if ((fromFile && from % 8 != fromFile - 'a') || (fromRank && from / 8 != fromRank - '1') ||
+            MoveGenerator::isKingAttacked(MoveGenerator::playMove(board, toMove, mv), toMove))
+            continue;
+
+        // Ambiguous
+        if (found != nullMove)
+            return nullMove;
+
+        found = mv;
+    }
+
+    return found;
+}
+
+
+std::string chessqdl::sanToMove(const BitboardArray &board, const enumColor toMove, const std::string_view san) {
+    const PackedMove mv = sanToPackedMove(board, toMove, san);
+
+    return mv == nullMove ? "" : unpackMove(mv);
+}
+
+
+/**
+ * @details A piece move is disambiguated by the file of its origin if that is enough to tell it apart from the other
+ * pieces of the same type that can legally reach the same square, then by the rank, and by both as a last resort.
+ */
+std::string chessqdl::moveToSan(const BitboardArray &board, const enumColor toMove, const std::string &mv) {
+    const enumColor enemy = toMove == nWhite ? nBlack : nWhite;
+    const int from = packMove(mv) & 0x3f;
+    const int to = (packMove(mv) >> 6) & 0x3f;
+    const int piece = pieceAt(board, from);
+    const bool capture = board[enemy].test(to);
+
+    std::string san;
+    san.reserve(maxMoveLength);
+
+    if (piece == nPawn) {
+        if (capture) {
+            san += mv[0];
+            san += 'x';
+        }
+
+        san.append(mv, 2, 2);
+
+        if (mv.size() > 4) {
+            san += '=';
+            san += static_cast<char>(std::toupper(mv[4]));
+        }
+    } else {
+        san = pieceLetters[piece];
+
+        bool ambiguous = false;
+        bool sameFile = false;
+        bool sameRank = false;
+
+        for (const auto &other: MoveGenerator::getPseudoLegalMoves(board, toMove)) {
+            const int otherFrom = packMove(other) & 0x3f;
+
+            if (otherFrom == from || other.compare(2, 2, mv, 2, 2) != 0 || pieceAt(board, otherFrom) != piece ||
+                !isLegal(board, toMove, other))
+                continue;
+
+            ambiguous = true;
+            sameFile |= other[0] == mv[0];
+            sameRank |= other[1] == mv[1];
+        }
+
+        if (ambiguous && (!sameFile || sameRank))
+            san += mv[0];
+        if (ambiguous && sameFile)
+            san += mv[1];
+
+        if (capture)
+            san += 'x';
+
+        san.append(mv, 2, 2);
+    }
+
+    san += checkSuffix(board, toMove, mv);
+
+    return san;
+}
+
+
+std::string chessqdl::moveToLan(const BitboardArray &board, const enumColor toMove, const std::string &mv) {
+    const enumColor enemy = toMove == nWhite ? nBlack : nWhite;
+    const int piece = pieceAt(board, packMove(mv) & 0x3f);
+
+    std::string lan;
+    lan.reserve(maxMoveLength + 1);
+
+    if (piece != nPawn)
+        lan += pieceLetters[piece];
+
+    lan.append(mv, 0, 2);
+    lan += board[enemy].test((packMove(mv) >> 6) & 0x3f) ? 'x' : '-';
+    lan.append(mv, 2, 2);
+
+    if (mv.size() > 4) {
+        lan += '=';
+        lan += static_cast<char>(std::toupper(mv[4]));
+    }
+
+    lan += checkSuffix(board, toMove, mv);
+
+    return lan;
+}
@@ -0,0 +1,54 @@
+#ifndef CHESSQDL_SAN_HPP
+#define CHESSQDL_SAN_HPP
+
+#include "const.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace chessqdl {
+
+    /**
+     * @brief Finds the legal move written in standard algebraic notation (e.g. "Nf3", "exd5", "Raxd1", "e8=Q+").
+     * Coordinate notation (e.g. "g1f3", "e7e8q") and long algebraic notation (e.g. "Ng1-f3", "e7xd8=Q") are accepted
+     * as well
+     * @param board  position the move is played from
+     * @param toMove  side to move
+     * @param san  move of interest. Check, mate and annotation suffixes are ignored
+     * @return The packed move (see packMove), or nullMove if \p san does not describe exactly one legal move
+     */
+    PackedMove sanToPackedMove(const BitboardArray &board, enumColor toMove, std::string_view san);
+
+
+    /**
+     * @brief Same as sanToPackedMove, for callers that work with moves in coordinate notation
+     * @return The move in coordinate notation (e.g. "e7e8q"), or an empty string if \p san does not describe exactly one
+     * legal move
+     */
+    std::string sanToMove(const BitboardArray &board, enumColor toMove, std::string_view san);
+
+
+    /**
+     * @brief Writes a legal move in standard algebraic notation, with the disambiguation, promotion piece and check
+     * or mate suffix it needs (e.g. "Nbd2", "exd5", "e8=Q+", "Rd8#")
+     * @param board  position the move is played from
+     * @param toMove  side to move
+     * @param mv  legal move in coordinate notation (e.g. "e7e8q")
+     * @return The move in standard algebraic notation
+     */
+    std::string moveToSan(const BitboardArray &board, enumColor toMove, const std::string &mv);
+
+
+    /**
+     * @brief Writes a legal move in long algebraic notation: piece letter, origin, "-" or "x", destination, promotion
+     * piece and check or mate suffix (e.g. "Ng1-f3", "e4xd5", "e7-e8=Q+")
+     * @param board  position the move is played from
+     * @param toMove  side to move
+     * @param mv  legal move in coordinate notation (e.g. "e7e8q")
+     * @return The move in long algebraic notation
+     */
+    std::string moveToLan(const BitboardArray &board, enumColor toMove, const std::string &mv);
+
+}
+
+#endif //CHESSQDL_SAN_HPP
@@ -0,0 +1,182 @@
+#include "see.hpp"
+#include "movegen.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+
+using namespace chessqdl;
+
+namespace {
+
+    /**
+     * @brief Returns the type of the piece standing on \p square, or -1 if the square is empty
+     */
+    int pieceAt(const BitboardArray &board, const int square) {
+        for (int piece = nPawn; piece <= nKing; piece++)
+            if (board[piece].test(square))
+                return piece;
+
+        return -1;
+    }
+
+
+    /**
+     * @brief Returns the type of the least valuable piece in \p attackers, or -1 if there is none
+     */
+    int leastValuablePiece(const BitboardArray &board, const U64 attackers) {
+        for (int piece = nPawn; piece <= nKing; piece++)
+            if ((attackers & board[piece]).any())
+                return piece;
+
+        return -1;
+    }
+
+
+    /**
+     * @brief Returns the piece a move promotes to, or -1 if it is not a promotion
+     */
+    int promotionPiece(const PackedMove mv) {
+        const int promotion = (mv >> 12) & 0x7;
+
+        return promotion == 0 ? -1 : nPawn + promotion;
+    }
+
+}
+
+
+/**
+ * @details Swap algorithm: the gain of every capture of the sequence is speculatively stored, assuming the capturing
+ * piece is lost on the next capture. The list is then folded backwards, letting each side stop the exchange whenever
+ * continuing would be worse. Removing each capturing piece from the occupancy reveals the sliders behind it. Promotions
+ * are accounted for on the first capture only.
+ * @ref https://www.chessprogramming.org/SEE_-_The_Swap_Algorithm
+ */
+int chessqdl::see(const BitboardArray &board, const std::string &mv) {
+    const PackedMove packed = packMove(mv);
+    const int from = packed & 0x3f;
+    const int to = (packed >> 6) & 0x3f;
+
+    int attacker = pieceAt(board, from);
+    if (attacker == -1)
+        return 0;
+
+    const int captured = pieceAt(board, to);
+    enumColor side = board[nWhite].test(from) ? nWhite : nBlack;
+
+    int gain[32];
+    int depth = 0;
+    gain[0] = captured == -1 ? 0 : seeValues[captured];
+
+    // Value of the piece that will stand on the destination square
+    int attackerValue = seeValues[attacker];
+
+    if (const int promotion = promotionPiece(packed); promotion != -1 && attacker == nPawn) {
+        gain[0] += seeValues[promotion] - seeValues[nPawn];
+        attackerValue = seeValues[promotion];
+    }
+
+    U64 occupied = board[nColor];
+    U64 fromSquare;
+    fromSquare.set(from);
+
+    do {
+        depth++;
+        gain[depth] = attackerValue - gain[depth - 1];
+
+        // Neither side can gain anything by continuing
+        if (std::max(-gain[depth - 1], gain[depth]) < 0)
+            break;
+
+        occupied &= ~fromSquare;
+        side = side == nWhite ? nBlack : nWhite;
+
+        const U64 attackers = MoveGenerator::getAttackersTo(board, to, occupied) & occupied & board[side];
+        attacker = leastValuablePiece(board, attackers);
+
+        if (attacker != -1) {
+            fromSquare.reset();
+            fromSquare.set(leastSignificantSetBit((attackers & board[attacker]).to_ullong()));
+            attackerValue = seeValues[attacker];
+        }
+    } while (attacker != -1 && depth < 31);
+
+    while (--depth)
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+
+    return gain[0];
+}
+
+
+/**
+ * @details Threshold variant of the swap algorithm. Instead of building the whole list of gains, it keeps track of
+ * whether the side making the move is currently above \p threshold and stops as soon as the side to capture cannot
+ * change that. If the least valuable attacker left is a king and the opponent still has attackers, capturing with the
+ * king would lose it, so the exchange ends there. Promotions are handled by the full swap algorithm.
+ * @ref https://www.chessprogramming.org/Static_Exchange_Evaluation
+ */
+bool chessqdl::seeGe(const BitboardArray &board, const std::string &mv, const int threshold) {
+    const PackedMove packed = packMove(mv);
+    const int from = packed & 0x3f;
+    const int to = (packed >> 6) & 0x3f;
+
+    const int moving = pieceAt(board, from);
+    if (moving == -1)
+        return threshold <= 0;
+
+    if (promotionPiece(packed) != -1 && moving == nPawn)
+        return see(board, mv) >= threshold;
+
+    const int captured = pieceAt(board, to);
+
+    int swap = (captured == -1 ? 0 : seeValues[captured]) - threshold;
+    if (swap < 0)
+        return false;
+
+    swap = seeValues[moving] - swap;
+    if (swap <= 0)
+        return true;
+
+    U64 occupied = board[nColor];
+    occupied.reset(from);
+    occupied.reset(to);
+
+    const U64 diagonalSliders = board[nBishop] | board[nQueen];
+    const U64 orthogonalSliders = board[nRook] | board[nQueen];
+
+    U64 target;
+    target.set(to);
+
+    enumColor side = board[nWhite].test(from) ? nWhite : nBlack;
+    U64 attackers = MoveGenerator::getAttackersTo(board, to, occupied);
+    bool result = true;
+
+    while (true) {
+        side = side == nWhite ? nBlack : nWhite;
+        attackers &= occupied;
+
+        const U64 sideAttackers = attackers & board[side];
+        if (sideAttackers.none())
+            break;
+
+        result = !result;
+
+        const int attacker = leastValuablePiece(board, sideAttackers);
+
+        if (attacker == nKing)
+            return (attackers & ~board[side]).any() ? !result : result;
+
+        swap = seeValues[attacker] - swap;
+        if (swap < static_cast<int>(result))
+            break;
+
+        occupied.reset(leastSignificantSetBit((sideAttackers & board[attacker]).to_ullong()));
+
+        // Sliders lined up behind the capturing piece join the exchange
+        if (attacker == nPawn || attacker == nBishop || attacker == nQueen)
+            attackers |= MoveGenerator::getBishopAttacks(target, occupied) & diagonalSliders;
+        if (attacker == nRook || attacker == nQueen)
+            attackers |= MoveGenerator::getRookAttacks(target, occupied) & orthogonalSliders;
+    }
+
+    return result;
+}
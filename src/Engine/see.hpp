@@ -0,0 +1,36 @@
+#ifndef CHESSQDL_SEE_HPP
+#define CHESSQDL_SEE_HPP
+
+#include "const.hpp"
+
+namespace chessqdl {
+
+    /**
+     * @brief Piece values used by the static exchange evaluation, in centipawns. Indexing follows enumPiece
+     */
+    constexpr std::array<int, 9> seeValues = {0, 0, 0, 100, 300, 300, 500, 900, 20000};
+
+
+    /**
+     * @brief Static exchange evaluation. Computes the material balance of the sequence of captures on the destination
+     * square of \p mv, assuming both sides always recapture with their least valuable attacker and may stop at any time
+     * @param board  board on which \p mv is about to be made
+     * @param mv  move in algebraic notation (e.g. e4d5). Does not need to be a capture
+     * @return Material won (positive) or lost (negative) by the side making \p mv, in centipawns
+     */
+    int see(const BitboardArray &board, const std::string &mv);
+
+
+    /**
+     * @brief Checks whether the static exchange evaluation of \p mv is at least \p threshold. Cheaper than calling see
+     * since the exchange stops as soon as its outcome relative to \p threshold is known
+     * @param board  board on which \p mv is about to be made
+     * @param mv  move in algebraic notation (e.g. e4d5). Does not need to be a capture
+     * @param threshold  minimum balance, in centipawns
+     * @return true if see(board, mv) >= threshold, false otherwise
+     */
+    bool seeGe(const BitboardArray &board, const std::string &mv, int threshold);
+
+}
+
+#endif //CHESSQDL_SEE_HPP
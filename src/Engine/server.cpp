@@ -0,0 +1,573 @@
+#include "server.hpp"
+#include "analysis.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <map>
+#include <sstream>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace chessqdl;
+
+namespace {
+
+    /**
+     * @brief Longest request line accepted. Longer lines close the connection
+     */
+    constexpr size_t maxRequestLength = 1 << 16;
+
+    /**
+     * @brief Value of a JSON object member. Numbers and literals are kept as written
+     */
+    struct JsonValue {
+        bool isString;
+        std::string text;
+    };
+
+    void skipSpaces(const std::string &text, size_t &i) {
+        while (i < text.size() && std::isspace(static_cast<unsigned char>(text[i])))
+            i++;
+    }
+
+    /**
+     * @brief Reads the JSON string that starts at \p i. Escaped characters are kept as the character they escape, and
+     * \\u escapes are replaced by '?'
+     */
+    bool readString(const std::string &text, size_t &i, std::string &value) {
+        if (i >= text.size() || text[i] != '"')
+            return false;
+
+        value.clear();
+
+        for (i++; i < text.size(); i++) {
+            if (text[i] == '"') {
+                i++;
+                return true;
+            }
+
+            if (text[i] != '\\') {
+                value += text[i];
+                continue;
+            }
+
+            if (++i == text.size())
+                return false;
+
+            switch (text[i]) {
+                case 'n':
+                    value += '\n';
+                    break;
+                case 't':
+                    value += '\t';
+                    break;
+                case 'u':
+                    value += '?';
+                    i = std::min(i + 4, text.size() - 1);
+                    break;
+                default:
+                    value += text[i];
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Reads a JSON object whose members are strings, numbers or literals
+     */
+    bool readFlatObject(const std::string &text, std::map<std::string, JsonValue> &members) {
+        size_t i = 0;
+        skipSpaces(text, i);
+
+        if (i >= text.size() || text[i++] != '{')
+            return false;
+
+        skipSpaces(text, i);
+
+        if (i < text.size() && text[i] == '}')
+            i++;
+        else {
+            while (true) {
+                std::string key;
+                JsonValue value{false, ""};
+
+                skipSpaces(text, i);
+
+                if (!readString(text, i, key))
+                    return false;
+
+                skipSpaces(text, i);
+
+                if (i >= text.size() || text[i++] != ':')
+                    return false;
+
+                skipSpaces(text, i);
+
+                if (i < text.size() && text[i] == '"') {
+                    value.isString = true;
+
+                    if (!readString(text, i, value.text))
+                        return false;
+                } else {
+                    while (i < text.size() && (std::isalnum(static_cast<unsigned char>(text[i])) || text[i] == '-' ||
+                                               text[i] == '+' || text[i] == '.'))
+                        value.text += text[i++];
+
+                    if (value.text.empty())
+                        return false;
+                }
+
+                members[key] = value;
+                skipSpaces(text, i);
+
+                if (i < text.size() && text[i] == ',') {
+                    i++;
+                    continue;
+                }
+
+                if (i >= text.size() || text[i++] != '}')
+                    return false;
+
+                break;
+            }
+        }
+
+        skipSpaces(text, i);
+
+        return i == text.size();
+    }
+
+    /**
+     * @brief Reads a non-negative integer member. Members that are not given leave \p value unchanged
+     */
+    bool readLimit(const std::map<std::string, JsonValue> &members, const std::string &name, long long &value) {
+        const auto it = members.find(name);
+
+        if (it == members.end())
+            return true;
+
+        const std::string &text = it->second.text;
+
+        if (it->second.isString || text.empty() || text.size() > 15 ||
+            !std::all_of(text.begin(), text.end(), [](const unsigned char c) { return std::isdigit(c); }))
+            return false;
+
+        value = std::stoll(text);
+
+        return true;
+    }
+
+    void writeMoves(std::ostringstream &output, const std::vector<std::string> &moves) {
+        output << "[";
+
+        for (size_t i = 0; i < moves.size(); i++)
+            output << (i > 0 ? ",\"" : "\"") << moves[i] << "\"";
+
+        output << "]";
+    }
+
+}
+
+
+struct AnalysisServer::Connection {
+    const int fd;
+
+    /**
+     * @brief Keeps the lines written by different engines apart
+     */
+    std::mutex writeMutex;
+
+
+    explicit Connection(const int fd) : fd(fd) {
+    }
+
+
+    ~Connection() {
+        ::close(fd);
+    }
+
+
+    /**
+     * @brief Writes a line. Errors are ignored, since they only mean that the client is gone
+     */
+    void send(const std::string &line) {
+        const std::string data = line + "\n";
+        size_t sent = 0;
+
+        std::lock_guard<std::mutex> lock(writeMutex);
+
+        while (sent < data.size()) {
+            const ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+
+            if (n <= 0)
+                return;
+
+            sent += static_cast<size_t>(n);
+        }
+    }
+};
+
+
+/**
+ * @details Members other than "id", "fen" and the limits are ignored, as are nested objects and arrays, which make the
+ * request invalid. The depth, node and time limits of a request replace all of the default ones, so that a request for
+ * a fixed depth is not cut short by a default time limit. A request must end up with at least one of them.
+ */
+bool chessqdl::parseServerRequest(const std::string &line, const SearchLimits &defaults, ServerRequest &request,
+                                  std::string &error) {
+    std::map<std::string, JsonValue> members;
+
+    request = ServerRequest();
+
+    if (!readFlatObject(line, members)) {
+        error = "invalid JSON";
+        return false;
+    }
+
+    if (const auto it = members.find("id"); it != members.end())
+        request.id = it->second.text;
+
+    const auto fen = members.find("fen");
+
+    if (fen == members.end() || !fen->second.isString) {
+        error = "missing fen";
+        return false;
+    }
+
+    std::string id;
+
+    if (!parsePosition(fen->second.text == "startpos" ? startFen : fen->second.text, request.fen, id)) {
+        error = "invalid position";
+        return false;
+    }
+
+    long long depth = 0;
+    long long nodes = 0;
+    long long moveTime = 0;
+    long long multiPv = 1;
+
+    if (!readLimit(members, "depth", depth) || depth > maxSearchDepth) {
+        error = "invalid depth";
+        return false;
+    }
+
+    if (!readLimit(members, "nodes", nodes)) {
+        error = "invalid nodes";
+        return false;
+    }
+
+    if (!readLimit(members, "movetime", moveTime)) {
+        error = "invalid movetime";
+        return false;
+    }
+
+    if (!readLimit(members, "multipv", multiPv) || multiPv < 1 || multiPv > 256) {
+        error = "invalid multipv";
+        return false;
+    }
+
+    if (depth > 0 || nodes > 0 || moveTime > 0) {
+        request.limits.depth = static_cast<int>(depth);
+        request.limits.nodes = nodes;
+        request.limits.moveTime = moveTime;
+    } else
+        request.limits = defaults;
+
+    request.limits.multiPv = static_cast<int>(multiPv);
+
+    if (request.limits.depth == 0 && request.limits.nodes == 0 && request.limits.moveTime == 0) {
+        error = "no search limit";
+        return false;
+    }
+
+    return true;
+}
+
+
+std::string chessqdl::analyzeRequest(Engine &engine, const ServerRequest &request) {
+    const auto begin = std::chrono::steady_clock::now();
+    SearchInfo last{0, 0, 0, 0, 0, {}, {}};
+
+    engine.setPosition(request.fen);
+    std::string bestMove = engine.search(request.limits, [&last](const SearchInfo &info) { last = info; });
+
+    const long long time = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - begin).count();
+
+    // Checkmate or stalemate
+    if (bestMove.empty())
+        bestMove = "0000";
+
+    std::ostringstream result;
+    result << R"({"id":")" << escapeJson(request.id) << R"(","bestmove":")" << bestMove << R"(","score":)"
+           << last.score << R"(,"depth":)" << last.depth << R"(,"nodes":)" << last.nodes << R"(,"time":)" << time
+           << R"(,"pv":)";
+    writeMoves(result, last.pv);
+
+    if (request.limits.multiPv > 1) {
+        result << R"(,"lines":[)";
+
+        for (size_t i = 0; i < last.lines.size(); i++) {
+            result << (i > 0 ? "," : "") << R"({"move":")" << last.lines[i].move << R"(","score":)"
+                   << last.lines[i].score << R"(,"pv":)";
+            writeMoves(result, last.lines[i].pv);
+            result << "}";
+        }
+
+        result << "]";
+    }
+
+    result << "}";
+
+    return result.str();
+}
+
+
+AnalysisServer::AnalysisServer(ServerOptions options) : options(std::move(options)) {
+}
+
+
+AnalysisServer::~AnalysisServer() {
+    stop();
+}
+
+
+/**
+ * @details A stale socket file left by a previous server is removed before binding. TCP servers only bind to the
+ * loopback interface, since requests are not authenticated.
+ */
+bool AnalysisServer::start() {
+    if (!options.socketPath.empty()) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+
+        if (options.socketPath.size() >= sizeof(address.sun_path))
+            return false;
+
+        options.socketPath.copy(address.sun_path, options.socketPath.size());
+        ::unlink(options.socketPath.c_str());
+
+        listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if (listener < 0 || ::bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+            ::listen(listener, SOMAXCONN) != 0) {
+            stop();
+            return false;
+        }
+    } else {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<uint16_t>(options.port));
+
+        listener = ::socket(AF_INET, SOCK_STREAM, 0);
+
+        const int reuse = 1;
+        socklen_t length = sizeof(address);
+
+        if (listener < 0 || ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+            ::bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+            ::listen(listener, SOMAXCONN) != 0 ||
+            ::getsockname(listener, reinterpret_cast<sockaddr *>(&address), &length) != 0) {
+            stop();
+            return false;
+        }
+
+        port = ntohs(address.sin_port);
+    }
+
+    const unsigned count = resolveThreads(options.engines);
+
+    for (unsigned i = 0; i < count; i++) {
+        auto engine = std::make_unique<Engine>(nWhite, 1, false, false, 0);
+        engine->setHashSize(options.hashSize);
+        engine->setPawnHashSize(options.pawnHashSize);
+        engine->setEvalCacheSize(options.evalCacheSize);
+        engine->setNetwork(options.network);
+        engine->setPieceSquareTables(options.pieceSquareTables);
+        engines.push_back(std::move(engine));
+    }
+
+    for (const auto &engine: engines)
+        workers.emplace_back(&AnalysisServer::analyzeRequests, this, std::ref(*engine));
+
+    acceptThread = std::thread(&AnalysisServer::acceptConnections, this);
+
+    return true;
+}
+
+
+int AnalysisServer::getPort() const {
+    return port;
+}
+
+
+void AnalysisServer::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    queueChanged.wait(lock, [this] { return stopping; });
+}
+
+
+/**
+ * @details The sockets are shut down rather than closed, which wakes up the threads blocked on them. Each connection is
+ * closed once its last reference is gone.
+ */
+void AnalysisServer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    queueChanged.notify_all();
+
+    if (listener >= 0)
+        ::shutdown(listener, SHUT_RDWR);
+
+    if (acceptThread.joinable())
+        acceptThread.join();
+
+    for (const auto &engine: engines)
+        engine->stop();
+
+    for (auto &[reader, connection]: readers) {
+        if (const auto open = connection.lock())
+            ::shutdown(open->fd, SHUT_RDWR);
+
+        reader.join();
+    }
+
+    for (auto &worker: workers)
+        worker.join();
+
+    readers.clear();
+    workers.clear();
+    queue.clear();
+
+    if (listener >= 0) {
+        ::close(listener);
+        listener = -1;
+
+        if (!options.socketPath.empty())
+            ::unlink(options.socketPath.c_str());
+    }
+}
+
+
+void AnalysisServer::acceptConnections() {
+    while (true) {
+        const int fd = ::accept(listener, nullptr, nullptr);
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (stopping) {
+            if (fd >= 0)
+                ::close(fd);
+            return;
+        }
+
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            return;
+        }
+
+        // Readers whose connection is closed are done
+        readers.erase(std::remove_if(readers.begin(), readers.end(), [](auto &reader) {
+            if (!reader.second.expired())
+                return false;
+
+            reader.first.join();
+            return true;
+        }), readers.end());
+
+        const auto connection = std::make_shared<Connection>(fd);
+        readers.emplace_back(std::thread(&AnalysisServer::readRequests, this, connection), connection);
+    }
+}
+
+
+/**
+ * @details Requests are added to the queue in the order they are read. While the queue is full, the connection is not
+ * read any further, so a client that sends requests faster than they are analyzed is held back by the socket buffers.
+ */
+void AnalysisServer::readRequests(const std::shared_ptr<Connection> &connection) {
+    std::string buffer;
+    char chunk[4096];
+
+    while (true) {
+        const ssize_t n = ::recv(connection->fd, chunk, sizeof(chunk), 0);
+
+        if (n <= 0)
+            return;
+
+        buffer.append(chunk, static_cast<size_t>(n));
+
+        size_t start = 0;
+
+        for (size_t newline = buffer.find('\n'); newline != std::string::npos;
+             newline = buffer.find('\n', start)) {
+            std::string line = buffer.substr(start, newline - start);
+            start = newline + 1;
+
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+
+            if (line.find_first_not_of(" \t") == std::string::npos)
+                continue;
+
+            ServerRequest request;
+            std::string error;
+
+            if (!parseServerRequest(line, options.limits, request, error)) {
+                connection->send(R"({"id":")" + escapeJson(request.id) + R"(","error":")" + error + "\"}");
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            queueChanged.wait(lock, [this] { return queue.size() < options.queueSize || stopping; });
+
+            if (stopping)
+                return;
+
+            queue.push_back({connection, std::move(request)});
+            queueChanged.notify_all();
+        }
+
+        buffer.erase(0, start);
+
+        if (buffer.size() > maxRequestLength) {
+            connection->send(R"({"id":"","error":"request too long"})");
+            return;
+        }
+    }
+}
+
+
+void AnalysisServer::analyzeRequests(Engine &engine) {
+    while (true) {
+        Job job;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            queueChanged.wait(lock, [this] { return !queue.empty() || stopping; });
+
+            if (stopping)
+                return;
+
+            job = std::move(queue.front());
+            queue.pop_front();
+            queueChanged.notify_all();
+        }
+
+        const std::string result = analyzeRequest(engine, job.request);
+        job.connection->send(result);
+    }
+}
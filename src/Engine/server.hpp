@@ -0,0 +1,202 @@
+#ifndef CHESSQDL_SERVER_HPP
+#define CHESSQDL_SERVER_HPP
+
+#include "engine.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace chessqdl {
+
+    /**
+     * @brief Settings of an analysis server
+     */
+    struct ServerOptions {
+        /**
+         * @brief Path of the Unix domain socket to listen on. When empty, the server listens on a TCP port of the
+         * loopback interface instead
+         */
+        std::string socketPath;
+
+        /**
+         * @brief TCP port to listen on. 0 lets the system pick a free one, see AnalysisServer::getPort
+         */
+        int port = 0;
+
+        /**
+         * @brief Number of engines, and so of requests analyzed at the same time. 0 uses one per hardware thread
+         */
+        unsigned engines = 0;
+
+        /**
+         * @brief Number of requests waiting for an engine. Connections are not read any further while it is full
+         */
+        size_t queueSize = 64;
+
+        /**
+         * @brief Limits of the requests that do not give any
+         */
+        SearchLimits limits;
+
+        /**
+         * @brief Sizes of the tables of each engine, in megabytes
+         */
+        size_t hashSize = 16;
+        size_t pawnHashSize = 2;
+        size_t evalCacheSize = 1;
+
+        /**
+         * @brief Network shared by all engines, or null for the handcrafted evaluation
+         */
+        std::shared_ptr<const NnueNetwork> network;
+
+        /**
+         * @brief Piece-square tables shared by all engines, or null for the default tables
+         */
+        std::shared_ptr<const PieceSquareTables> pieceSquareTables;
+    };
+
+
+    /**
+     * @brief An analysis request
+     */
+    struct ServerRequest {
+        /**
+         * @brief Identifier chosen by the client, sent back with the result
+         */
+        std::string id;
+
+        std::string fen;
+        SearchLimits limits;
+    };
+
+
+    /**
+     * @brief Reads an analysis request written as a JSON object on one line, such as
+     * {"id": "1", "fen": "...", "depth": 8, "nodes": 100000, "movetime": 500, "multipv": 3}. <br>
+     *
+     * Only "fen" is required, and "startpos" stands for the initial position. The limits that are not given are taken
+     * from \p defaults, unless the request gives another one
+     * @param line  line of interest
+     * @param defaults  limits of a request that does not give any
+     * @param request  filled with the request
+     * @param error  filled with the reason the request is invalid
+     * @return True if the request is valid
+     */
+    bool parseServerRequest(const std::string &line, const SearchLimits &defaults, ServerRequest &request,
+                            std::string &error);
+
+
+    /**
+     * @brief Analyzes a request and writes its result as a JSON object on one line: the id, best move, score for the
+     * side to move, depth, nodes, time in milliseconds and principal variation, plus the best lines of a multi-PV
+     * request
+     * @param engine  engine used for the analysis
+     * @param request  request of interest
+     * @return The result, without the final newline
+     */
+    std::string analyzeRequest(Engine &engine, const ServerRequest &request);
+
+
+    /**
+     * @brief Serves analysis requests over a local socket. <br>
+     *
+     * Clients send one JSON request per line (see parseServerRequest) and receive one JSON result per line (see
+     * analyzeRequest) as soon as it is ready, so the results of a connection may come in a different order than its
+     * requests. Invalid requests are answered right away with an "error" field. Requests are analyzed by a fixed pool
+     * of engines, created when the server starts
+     */
+    class AnalysisServer {
+
+    private:
+        struct Connection;
+
+        struct Job {
+            std::shared_ptr<Connection> connection;
+            ServerRequest request;
+        };
+
+        ServerOptions options;
+
+        int listener = -1;
+        int port = 0;
+
+        std::vector<std::unique_ptr<Engine>> engines;
+        std::vector<std::thread> workers;
+        std::thread acceptThread;
+
+        /**
+         * @brief Requests waiting for an engine, at most ServerOptions::queueSize
+         */
+        std::deque<Job> queue;
+        std::mutex mutex;
+        std::condition_variable queueChanged;
+        bool stopping = false;
+
+        /**
+         * @brief Thread reading each connection, along with the connection. A connection is closed once its reader
+         * and all the requests it sent are done, and its thread is joined when the next connection is accepted
+         */
+        std::vector<std::pair<std::thread, std::weak_ptr<Connection>>> readers;
+
+
+        void acceptConnections();
+
+
+        void readRequests(const std::shared_ptr<Connection> &connection);
+
+
+        void analyzeRequests(Engine &engine);
+
+    public:
+        /**
+         * @brief Creates a server that is not listening yet
+         * @param options  settings of the server
+         */
+        explicit AnalysisServer(ServerOptions options);
+
+        AnalysisServer(const AnalysisServer &) = delete;
+        AnalysisServer &operator=(const AnalysisServer &) = delete;
+
+        /**
+         * @brief Stops the server
+         */
+        ~AnalysisServer();
+
+
+        /**
+         * @brief Creates the engines and starts listening
+         * @return False if the socket could not be listened on
+         */
+        bool start();
+
+
+        /**
+         * @brief Get method that returns the TCP port the server listens on
+         * @return The port, or 0 when listening on a Unix domain socket
+         */
+        [[nodiscard]] int getPort() const;
+
+
+        /**
+         * @brief Waits until the server is stopped
+         */
+        void wait();
+
+
+        /**
+         * @brief Stops listening, closes the connections and interrupts the running analyses. Requests still waiting
+         * are dropped
+         */
+        void stop();
+    };
+
+}
+
+#endif //CHESSQDL_SERVER_HPP
@@ -0,0 +1,183 @@
+#include "suite.hpp"
+#include "bitboard.hpp"
+#include "san.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+using namespace chessqdl;
+
+namespace {
+
+    /**
+     * @brief Converts a list of moves in standard algebraic notation to coordinate notation
+     * @return false if any of the moves is not legal
+     */
+    bool convertMoves(const std::string &list, const BitboardArray &board, const enumColor toMove,
+                      std::vector<std::string> &moves) {
+        std::istringstream stream(list);
+        std::string san;
+
+        while (stream >> san) {
+            const std::string mv = sanToMove(board, toMove, san);
+
+            if (mv.empty())
+                return false;
+
+            moves.push_back(mv);
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Nearest-rank percentile of a sorted list
+     */
+    template<typename T>
+    T percentile(const std::vector<T> &sorted, const int p) {
+        const size_t rank = (sorted.size() * p + 99) / 100;
+        return sorted[std::max<size_t>(rank, 1) - 1];
+    }
+
+    template<typename T>
+    void printPercentiles(std::ostream &output, const std::string &name, std::vector<T> values) {
+        std::sort(values.begin(), values.end());
+
+        output << name << ": p50 " << percentile(values, 50) << ", p75 " << percentile(values, 75) << ", p90 "
+               << percentile(values, 90) << ", max " << values.back() << std::endl;
+    }
+
+}
+
+
+bool SuitePosition::isSolution(const std::string &mv) const {
+    return (bestMoves.empty() || std::find(bestMoves.begin(), bestMoves.end(), mv) != bestMoves.end()) &&
+           std::find(avoidMoves.begin(), avoidMoves.end(), mv) == avoidMoves.end();
+}
+
+
+bool chessqdl::parseSuitePosition(const std::string &line, SuitePosition &position) {
+    std::map<std::string, std::string> operations;
+
+    if (!parseEpd(line, position.fen, operations) || (!operations.count("bm") && !operations.count("am")))
+        return false;
+
+    const Bitboard board(position.fen);
+    const enumColor toMove = position.fen.substr(position.fen.find(' ') + 1, 1) == "w" ? nWhite : nBlack;
+
+    position.id = operations["id"];
+    position.bestMoves.clear();
+    position.avoidMoves.clear();
+
+    return convertMoves(operations["bm"], board.getBitBoards(), toMove, position.bestMoves) &&
+           convertMoves(operations["am"], board.getBitBoards(), toMove, position.avoidMoves);
+}
+
+
+/**
+ * @details The best move of every iteration is the first move of its principal variation. The solution counts as
+ * found at the first iteration of the last run of iterations that all had a solution as best move, and only if the
+ * move finally returned is a solution too.
+ */
+SuiteResult chessqdl::runSuitePosition(Engine &engine, const SuitePosition &position, const SearchLimits &limits) {
+    SuiteResult result;
+    bool holding = false;
+
+    result.id = position.id;
+
+    engine.setPosition(position.fen);
+    result.move = engine.search(limits, [&](const SearchInfo &info) {
+        const bool solution = !info.pv.empty() && position.isSolution(info.pv.front());
+
+        if (solution && !holding) {
+            result.depth = info.depth;
+            result.nodes = info.nodes;
+            result.time = info.time;
+        }
+
+        holding = solution;
+    });
+
+    result.solved = holding && position.isSolution(result.move);
+
+    return result;
+}
+
+
+/**
+ * @details Positions are taken in order by the threads, each one with an engine of its own. The engines do not
+ * shuffle their moves and start every position from empty tables, as in runBench.
+ */
+std::vector<SuiteResult> chessqdl::runSuite(const std::vector<SuitePosition> &positions,
+                                            const AnalysisOptions &options,
+                                            const std::function<void(size_t, const SuiteResult &)> &onResult) {
+    std::vector<SuiteResult> results(positions.size());
+    std::atomic<size_t> next = 0;
+    std::mutex callbackMutex;
+
+    const auto work = [&] {
+        Engine engine(nWhite, 1, false, false, 0);
+        engine.setHashSize(options.hashSize);
+        engine.setPawnHashSize(options.pawnHashSize);
+        engine.setEvalCacheSize(options.evalCacheSize);
+        engine.setNetwork(options.network);
+        engine.setPieceSquareTables(options.pieceSquareTables);
+        engine.setShuffle(false);
+
+        for (size_t i = next++; i < positions.size(); i = next++) {
+            // Time and nodes to solution must not depend on the positions the engine searched before
+            engine.clearHash();
+            results[i] = runSuitePosition(engine, positions[i], options.limits);
+
+            if (onResult) {
+                std::lock_guard<std::mutex> lock(callbackMutex);
+                onResult(i, results[i]);
+            }
+        }
+    };
+
+    const unsigned threads = resolveThreads(options.threads);
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 1; t < threads; t++)
+        workers.emplace_back(work);
+
+    work();
+
+    for (auto &worker: workers)
+        worker.join();
+
+    return results;
+}
+
+
+void chessqdl::printSuiteSummary(std::ostream &output, const std::vector<SuiteResult> &results) {
+    std::vector<long long> times;
+    std::vector<long long> nodes;
+    std::vector<int> depths;
+
+    for (const auto &result: results) {
+        if (result.solved) {
+            times.push_back(result.time);
+            nodes.push_back(result.nodes);
+            depths.push_back(result.depth);
+        }
+    }
+
+    output << "Solved " << times.size() << " of " << results.size() << " (" << std::fixed << std::setprecision(1)
+           << (results.empty() ? 0.0 : 100.0 * static_cast<double>(times.size()) / static_cast<double>(results.size()))
+           << "%)" << std::defaultfloat << std::endl;
+
+    if (times.empty())
+        return;
+
+    printPercentiles(output, "Time to solution (ms)", times);
+    printPercentiles(output, "Nodes to solution", nodes);
+    printPercentiles(output, "Depth to solution", depths);
+}
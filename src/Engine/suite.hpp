@@ -0,0 +1,104 @@
+#ifndef CHESSQDL_SUITE_HPP
+#define CHESSQDL_SUITE_HPP
+
+#include "analysis.hpp"
+#include "engine.hpp"
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace chessqdl {
+
+    /**
+     * @brief Position of a test suite, with the moves that solve it
+     */
+    struct SuitePosition {
+        std::string fen;
+        std::string id;
+
+        /**
+         * @brief Moves given by the "bm" operation, in coordinate notation. Any of them solves the position
+         */
+        std::vector<std::string> bestMoves;
+
+        /**
+         * @brief Moves given by the "am" operation, in coordinate notation. Any other move solves the position
+         */
+        std::vector<std::string> avoidMoves;
+
+
+        /**
+         * @brief Checks if a move solves the position
+         * @param mv  move in coordinate notation
+         * @return True if \p mv is one of the best moves (when there are any) and none of the moves to avoid
+         */
+        [[nodiscard]] bool isSolution(const std::string &mv) const;
+    };
+
+
+    /**
+     * @brief Outcome of the search of a suite position
+     */
+    struct SuiteResult {
+        std::string id;
+
+        /**
+         * @brief Move returned by the search
+         */
+        std::string move;
+
+        bool solved = false;
+
+        /**
+         * @brief Depth, number of nodes and time in milliseconds of the iteration from which the search kept a solution
+         * as its best move until the end. Only meaningful if the position is solved
+         */
+        int depth = 0;
+        long long nodes = 0;
+        long long time = 0;
+    };
+
+
+    /**
+     * @brief Reads a test position: an EPD line with a "bm" or an "am" operation, whose moves are in standard algebraic
+     * notation
+     * @param line  line of interest
+     * @param position  filled with the position. Its id is the "id" operation, if any
+     * @return True if the line holds a valid position and all of its moves are legal in it
+     */
+    bool parseSuitePosition(const std::string &line, SuitePosition &position);
+
+
+    /**
+     * @brief Searches a suite position and records when the solution was found
+     * @param engine  engine that searches the position
+     * @param position  position of interest
+     * @param limits  limits of the search
+     * @return Outcome of the search
+     */
+    SuiteResult runSuitePosition(Engine &engine, const SuitePosition &position, const SearchLimits &limits);
+
+
+    /**
+     * @brief Searches every position of a suite, several at a time when asked to
+     * @param positions  positions of the suite
+     * @param options  search limits, number of threads and engine settings. The output format is not used
+     * @param onResult  called with the index and outcome of every position as soon as it is searched, one call at a time
+     * @return Outcome of every position, in the order of \p positions
+     */
+    std::vector<SuiteResult> runSuite(const std::vector<SuitePosition> &positions, const AnalysisOptions &options,
+                                      const std::function<void(size_t, const SuiteResult &)> &onResult = {});
+
+
+    /**
+     * @brief Prints the number of solved positions, and percentiles of the time, nodes and depth needed to solve them
+     * @param output  stream to print to
+     * @param results  outcome of every position of a suite
+     */
+    void printSuiteSummary(std::ostream &output, const std::vector<SuiteResult> &results);
+
+}
+
+#endif //CHESSQDL_SUITE_HPP
@@ -0,0 +1,96 @@
+#include "transposition.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+
+using namespace chessqdl;
+
+
+/**
+ * @details See TranspositionTable::resize
+ */
+TranspositionTable::TranspositionTable(const size_t megabytes) {
+    resize(megabytes);
+}
+
+
+/**
+ * @details See tableEntries.
+ */
+void TranspositionTable::resize(const size_t megabytes) {
+    const size_t entries = tableEntries(megabytes, sizeof(TTEntry));
+
+    table.assign(entries, TTEntry{});
+    mask = entries - 1;
+    generation = 0;
+}
+
+
+/**
+ * @details Resets every entry to its zero state.
+ */
+void TranspositionTable::clear() {
+    std::fill(table.begin(), table.end(), TTEntry{});
+    generation = 0;
+}
+
+
+/**
+ * @details Generation is a 6 bit counter, so it wraps around after 64 searches.
+ */
+void TranspositionTable::newSearch() {
+    generation = (generation + 1) & 0x3f;
+}
+
+
+/**
+ * @details An entry is only returned if its full key matches \p key, which makes index collisions harmless.
+ */
+bool TranspositionTable::probe(const uint64_t key, TTEntry &entry) const {
+    const TTEntry &stored = table[key & mask];
+
+    if (stored.key != key)
+        return false;
+
+    entry = stored;
+    return true;
+}
+
+
+/**
+ * @details Entries of the same position are always updated. Entries of other positions are only replaced if they
+ * belong to an older search or were searched to a lower depth. The best move of a previous entry of the same position
+ * is kept when the new result does not have one.
+ */
+void TranspositionTable::store(const uint64_t key, const int depth, const int score, const enumBound bound,
+                               PackedMove move) {
+    TTEntry &stored = table[key & mask];
+
+    if (stored.key != key && stored.generation == generation && stored.depth > depth)
+        return;
+
+    if (move == nullMove && stored.key == key)
+        move = stored.move;
+
+    stored.key = key;
+    stored.score = score;
+    stored.move = move;
+    stored.depth = static_cast<int8_t>(depth);
+    stored.bound = bound;
+    stored.generation = generation;
+}
+
+
+/**
+ * @details Samples the first thousand entries, following the convention used by the UCI protocol.
+ */
+int TranspositionTable::hashfull() const {
+    const size_t samples = std::min<size_t>(1000, table.size());
+    int used = 0;
+
+    for (size_t i = 0; i < samples; i++)
+        if (table[i].key != 0 && table[i].generation == generation)
+            used++;
+
+    return static_cast<int>(used * 1000 / samples);
+}
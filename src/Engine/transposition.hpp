@@ -0,0 +1,108 @@
+#ifndef CHESSQDL_TRANSPOSITION_HPP
+#define CHESSQDL_TRANSPOSITION_HPP
+
+#include "const.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace chessqdl {
+
+    /**
+     * @brief Kind of score stored in a transposition table entry
+     */
+    enum enumBound {
+        nExact,         // score is exact
+        nLowerBound,    // search failed high, real score is at least the stored score
+        nUpperBound     // search failed low, real score is at most the stored score
+    };
+
+    /**
+     * @brief Single entry of the transposition table. Scores are stored from the perspective of the side to move
+     */
+    struct TTEntry {
+        uint64_t key;
+        int score;
+        PackedMove move;
+        int8_t depth;
+        uint8_t bound : 2;
+        uint8_t generation : 6;
+    };
+
+    class TranspositionTable {
+
+    private:
+
+        /**
+         * @brief Table entries. The number of entries is always a power of two
+         */
+        std::vector<TTEntry> table;
+
+        /**
+         * @brief Mask applied to a key to obtain its index in the table
+         */
+        uint64_t mask = 0;
+
+        /**
+         * @brief Age of the current search. Entries from older searches are replaced first
+         */
+        uint8_t generation = 0;
+
+    public:
+
+        /**
+         * @brief Allocates a table of (at most) \p megabytes megabytes
+         * @param megabytes  size of the table in megabytes
+         */
+        explicit TranspositionTable(size_t megabytes = 16);
+
+
+        /**
+         * @brief Reallocates the table with (at most) \p megabytes megabytes. All entries are lost
+         * @param megabytes  new size of the table in megabytes
+         */
+        void resize(size_t megabytes);
+
+
+        /**
+         * @brief Empties the table
+         */
+        void clear();
+
+
+        /**
+         * @brief Marks the beginning of a new search so that entries of previous searches can be told apart
+         */
+        void newSearch();
+
+
+        /**
+         * @brief Looks up a position in the table
+         * @param key  Zobrist hash of the position
+         * @param entry  filled with the stored entry if the position is found
+         * @return true if the position was found, false otherwise
+         */
+        bool probe(uint64_t key, TTEntry &entry) const;
+
+
+        /**
+         * @brief Stores the result of a search in the table
+         * @param key  Zobrist hash of the position
+         * @param depth  depth of the search that produced the score
+         * @param score  score from the perspective of the side to move
+         * @param bound  whether the score is exact, a lower bound or an upper bound
+         * @param move  best move found (nullMove if unknown)
+         */
+        void store(uint64_t key, int depth, int score, enumBound bound, PackedMove move);
+
+
+        /**
+         * @brief Estimates how full the table is
+         * @return Permille of sampled entries that belong to the current search
+         */
+        [[nodiscard]] int hashfull() const;
+    };
+
+}
+
+#endif //CHESSQDL_TRANSPOSITION_HPP
@@ -0,0 +1,376 @@
+#include "tuner.hpp"
+#include "bitboard.hpp"
+#include "evaluation.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+using namespace chessqdl;
+
+namespace {
+
+    constexpr int parameters = 6 * 64;
+    constexpr uint16_t blackFlag = 0x8000;
+
+    /**
+     * @brief Number of lines read from a file before their features are extracted
+     */
+    constexpr size_t loadBlockSize = 1 << 20;
+
+    /**
+     * @brief Expected score of a position from white's point of view
+     */
+    double sigmoid(const double k, const double score) {
+        return 1.0 / (1.0 + std::pow(10.0, -k * score / 400.0));
+    }
+
+    /**
+     * @brief Checks that the piece placement field of a FEN string describes eight ranks of eight squares
+     */
+    bool isValidPlacement(const std::string &placement) {
+        int ranks = 1;
+        int files = 0;
+
+        for (const char c: placement) {
+            if (c == '/') {
+                if (files != 8)
+                    return false;
+                ranks++;
+                files = 0;
+            } else if (c >= '1' && c <= '8')
+                files += c - '0';
+            else if (std::string("pnbrqkPNBRQK").find(c) != std::string::npos)
+                files++;
+            else
+                return false;
+
+            if (files > 8)
+                return false;
+        }
+
+        return ranks == 8 && files == 8;
+    }
+
+    /**
+     * @brief Training data extracted from a set of positions, in the same layout as the members of Tuner
+     */
+    struct Rows {
+        std::vector<uint32_t> sizes;
+        std::vector<uint16_t> entries;
+        std::vector<uint8_t> phases;
+        std::vector<float> baseScores;
+        std::vector<float> results;
+
+        /**
+         * @brief Appends the features of a labeled position
+         */
+        bool add(const std::string &line) {
+            std::string fen;
+            double result;
+
+            if (!parseLabeledPosition(line, fen, result))
+                return false;
+
+            const BitboardArray board = Bitboard(fen).getBitBoards();
+            const EvalState state = computeEvalState(board);
+            const size_t first = entries.size();
+            const int score = evaluateBoard(board, nWhite);
+
+            // Specialized endgame evaluators ignore the tables, and scaled evaluations are not linear in them
+            int endgameScore;
+            if (evaluateEndgame(board, state.materialKey, nWhite, endgameScore) ||
+                endgameScaleFactor(board, state.materialKey, score >= 0 ? nWhite : nBlack) != normalScaleFactor)
+                return false;
+
+            for (int color = nWhite; color <= nBlack; color++) {
+                for (int piece = nPawn; piece <= nKing; piece++) {
+                    uint64_t pieces = (board[piece] & board[color]).to_ullong();
+
+                    while (pieces) {
+                        const int square = relativeSquare(static_cast<enumColor>(color), leastSignificantSetBit(pieces));
+                        const auto index = static_cast<uint16_t>((piece - nPawn) * 64 + square);
+                        entries.push_back(color == nWhite ? index : index | blackFlag);
+                        pieces &= pieces - 1;
+                    }
+                }
+            }
+
+            const int phase = std::min(state.phase, maxPhase);
+            const int psqtScore = taper(state.mgPsqt[nWhite] - state.mgPsqt[nBlack],
+                                        state.egPsqt[nWhite] - state.egPsqt[nBlack], phase);
+
+            sizes.push_back(static_cast<uint32_t>(entries.size() - first));
+            phases.push_back(static_cast<uint8_t>(phase));
+            baseScores.push_back(static_cast<float>(score - psqtScore));
+            results.push_back(static_cast<float>(result));
+
+            return true;
+        }
+    };
+
+}
+
+
+/**
+ * @details Tokens are separated by whitespace. Brackets, quotes and semicolons around the result are stripped before it
+ * is interpreted.
+ */
+bool chessqdl::parseLabeledPosition(const std::string &line, std::string &fen, double &result) {
+    std::istringstream stream(line);
+    std::vector<std::string> tokens;
+    std::string token;
+
+    while (stream >> token)
+        tokens.push_back(token);
+
+    if (tokens.size() < 2)
+        return false;
+
+    std::string label = tokens.back();
+    tokens.pop_back();
+
+    label.erase(std::remove_if(label.begin(), label.end(), [](const char c) {
+        return c == '[' || c == ']' || c == '"' || c == ';';
+    }), label.end());
+
+    if (label == "1-0")
+        result = 1.0;
+    else if (label == "0-1")
+        result = 0.0;
+    else if (label == "1/2-1/2")
+        result = 0.5;
+    else {
+        char *end = nullptr;
+        result = std::strtod(label.c_str(), &end);
+
+        if (label.empty() || *end != '\0' || result < 0.0 || result > 1.0)
+            return false;
+    }
+
+    // EPD opcode announcing the result
+    if (!tokens.empty() && (tokens.back() == "c9" || tokens.back() == "c2"))
+        tokens.pop_back();
+
+    if (tokens.empty() || !isValidPlacement(tokens.front()))
+        return false;
+
+    fen.clear();
+    for (const auto &t: tokens)
+        fen += (fen.empty() ? "" : " ") + t;
+
+    return true;
+}
+
+
+Tuner::Tuner(const PieceSquareTables &tables) : mg(parameters), eg(parameters), momentum(2 * parameters),
+                                                  velocity(2 * parameters) {
+    for (int piece = nPawn; piece <= nKing; piece++) {
+        for (int square = 0; square < 64; square++) {
+            mg[(piece - nPawn) * 64 + square] = tables.mg[piece][square];
+            eg[(piece - nPawn) * 64 + square] = tables.eg[piece][square];
+        }
+    }
+}
+
+
+bool Tuner::addPosition(const std::string &line) {
+    Rows rows;
+
+    if (!rows.add(line))
+        return false;
+
+    offsets.push_back(offsets.back() + rows.sizes[0]);
+    entries.insert(entries.end(), rows.entries.begin(), rows.entries.end());
+    phases.push_back(rows.phases[0]);
+    baseScores.push_back(rows.baseScores[0]);
+    results.push_back(rows.results[0]);
+
+    return true;
+}
+
+
+/**
+ * @details The file is read in blocks of lines. The lines of a block are split between threads, and the rows extracted
+ * by each thread are appended in order, so the training set does not depend on the number of threads. Invalid lines are
+ * skipped, and so are the positions rejected by Tuner::addPosition.
+ */
+long long Tuner::load(const std::string &path, unsigned threads) {
+    std::ifstream file(path);
+
+    if (!file)
+        return -1;
+
+    threads = resolveThreads(threads);
+
+    const size_t before = size();
+    std::vector<std::string> lines;
+    std::string line;
+
+    while (file) {
+        lines.clear();
+
+        while (lines.size() < loadBlockSize && std::getline(file, line))
+            lines.push_back(line);
+
+        std::vector<Rows> rows(threads);
+
+        parallelFor(lines.size(), threads, [&](const size_t begin, const size_t end, const unsigned t) {
+            for (size_t i = begin; i < end; i++)
+                rows[t].add(lines[i]);
+        });
+
+        for (const Rows &r: rows) {
+            for (const uint32_t rowSize: r.sizes)
+                offsets.push_back(offsets.back() + rowSize);
+
+            entries.insert(entries.end(), r.entries.begin(), r.entries.end());
+            phases.insert(phases.end(), r.phases.begin(), r.phases.end());
+            baseScores.insert(baseScores.end(), r.baseScores.begin(), r.baseScores.end());
+            results.insert(results.end(), r.results.begin(), r.results.end());
+        }
+    }
+
+    return static_cast<long long>(size() - before);
+}
+
+
+size_t Tuner::size() const {
+    return results.size();
+}
+
+
+/**
+ * @details Same formula as evaluateBoard, with the piece-square terms taken from the parameters and the taper computed
+ * without rounding.
+ */
+double Tuner::evaluate(const size_t index) const {
+    double mgScore = 0;
+    double egScore = 0;
+
+    for (uint32_t i = offsets[index]; i < offsets[index + 1]; i++) {
+        const uint16_t entry = entries[i];
+        const int parameter = entry & ~blackFlag;
+        const double sign = entry & blackFlag ? -1.0 : 1.0;
+
+        mgScore += sign * mg[parameter];
+        egScore += sign * eg[parameter];
+    }
+
+    const double phase = phases[index];
+
+    return baseScores[index] + (mgScore * phase + egScore * (maxPhase - phase)) / maxPhase;
+}
+
+
+double Tuner::loss(const double k, const unsigned threads) const {
+    std::vector<double> sums(resolveThreads(threads));
+
+    parallelFor(size(), threads, [&](const size_t begin, const size_t end, const unsigned t) {
+        double sum = 0;
+
+        for (size_t i = begin; i < end; i++) {
+            const double error = results[i] - sigmoid(k, evaluate(i));
+            sum += error * error;
+        }
+
+        sums[t] = sum;
+    });
+
+    double total = 0;
+    for (const double sum: sums)
+        total += sum;
+
+    return size() == 0 ? 0.0 : total / static_cast<double>(size());
+}
+
+
+/**
+ * @details The loss is unimodal in k, so a ternary search over a generous interval is enough.
+ */
+double Tuner::findScalingConstant(const unsigned threads) const {
+    double low = 0.0;
+    double high = 10.0;
+
+    for (int i = 0; i < 60; i++) {
+        const double first = low + (high - low) / 3;
+        const double second = high - (high - low) / 3;
+
+        if (loss(first, threads) < loss(second, threads))
+            high = second;
+        else
+            low = first;
+    }
+
+    return (low + high) / 2;
+}
+
+
+/**
+ * @details Every thread accumulates the gradient of its range of positions in a dense vector of its own. The vectors are
+ * summed before the Adam update, which is cheap since there are only 2 * 6 * 64 parameters.
+ */
+void Tuner::step(const double k, const double learningRate, const unsigned threads) {
+    constexpr double beta1 = 0.9;
+    constexpr double beta2 = 0.999;
+    constexpr double epsilon = 1e-8;
+
+    if (size() == 0)
+        return;
+
+    std::vector<std::vector<double>> gradients(resolveThreads(threads), std::vector<double>(2 * parameters));
+
+    parallelFor(size(), threads, [&](const size_t begin, const size_t end, const unsigned t) {
+        std::vector<double> &gradient = gradients[t];
+
+        for (size_t i = begin; i < end; i++) {
+            const double expected = sigmoid(k, evaluate(i));
+            // Derivative of the squared error with respect to the evaluation
+            const double slope = -2.0 * (results[i] - expected) * expected * (1.0 - expected) * k * std::log(10.0) / 400.0;
+            const double mgWeight = slope * phases[i] / maxPhase;
+            const double egWeight = slope * (maxPhase - phases[i]) / maxPhase;
+
+            for (uint32_t j = offsets[i]; j < offsets[i + 1]; j++) {
+                const uint16_t entry = entries[j];
+                const int parameter = entry & ~blackFlag;
+                const double sign = entry & blackFlag ? -1.0 : 1.0;
+
+                gradient[parameter] += sign * mgWeight;
+                gradient[parameters + parameter] += sign * egWeight;
+            }
+        }
+    });
+
+    steps++;
+
+    for (int p = 0; p < 2 * parameters; p++) {
+        double gradient = 0;
+        for (const auto &g: gradients)
+            gradient += g[p];
+        gradient /= static_cast<double>(size());
+
+        momentum[p] = beta1 * momentum[p] + (1 - beta1) * gradient;
+        velocity[p] = beta2 * velocity[p] + (1 - beta2) * gradient * gradient;
+
+        const double m = momentum[p] / (1 - std::pow(beta1, steps));
+        const double v = velocity[p] / (1 - std::pow(beta2, steps));
+
+        (p < parameters ? mg[p] : eg[p - parameters]) -= learningRate * m / (std::sqrt(v) + epsilon);
+    }
+}
+
+
+PieceSquareTables Tuner::getTables() const {
+    PieceSquareTables tables{};
+
+    for (int piece = nPawn; piece <= nKing; piece++) {
+        for (int square = 0; square < 64; square++) {
+            tables.mg[piece][square] = static_cast<int>(std::lround(mg[(piece - nPawn) * 64 + square]));
+            tables.eg[piece][square] = static_cast<int>(std::lround(eg[(piece - nPawn) * 64 + square]));
+        }
+    }
+
+    return tables;
+}
@@ -0,0 +1,162 @@
+#ifndef CHESSQDL_TUNER_HPP
+#define CHESSQDL_TUNER_HPP
+
+#include "const.hpp"
+#include "psqt.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace chessqdl {
+
+    /**
+     * @brief Splits a line of a labeled position file into a FEN string and a game result. <br>
+     *
+     * The result is the last token of the line and may be written as 1-0, 0-1, 1/2-1/2 or as a number between 0 and 1,
+     * optionally surrounded by brackets, quotes or a trailing semicolon. Everything before it up to an optional "c9" or
+     * "c2" EPD opcode is the FEN
+     * @param line  line to parse
+     * @param fen  filled with the FEN string
+     * @param result  filled with the result from white's point of view (1 for a win, 0.5 for a draw, 0 for a loss)
+     * @return True if the line holds a position and a result
+     */
+    bool parseLabeledPosition(const std::string &line, std::string &fen, double &result);
+
+
+    /**
+     * @brief Fits the piece-square tables to a set of labeled positions with the Texel method: the evaluation is mapped
+     * to an expected score with a sigmoid and the mean squared error against the game results is minimized with Adam. <br>
+     *
+     * Every term of the evaluation other than the piece-square tables is computed once per position and kept constant.
+     * The piece-square tables enter the evaluation linearly (up to the rounding of the taper), so each position is
+     * reduced to a sparse row of signed table indices, its game phase, its constant term and its result
+     */
+    class Tuner {
+
+    private:
+
+        /**
+         * @brief Offset of the first entry of each position in Tuner::entries, plus a final offset past the last one
+         */
+        std::vector<uint32_t> offsets = {0};
+
+        /**
+         * @brief Sparse feature matrix. Each entry is a table index (piece * 64 + square, from white's point of view),
+         * with the highest bit set for black pieces
+         */
+        std::vector<uint16_t> entries;
+
+        /**
+         * @brief Game phase of each position, clamped to maxPhase
+         */
+        std::vector<uint8_t> phases;
+
+        /**
+         * @brief Evaluation of each position from white's point of view, without the piece-square terms
+         */
+        std::vector<float> baseScores;
+
+        /**
+         * @brief Game result of each position from white's point of view
+         */
+        std::vector<float> results;
+
+        /**
+         * @brief Middlegame and endgame parameters, one table of 6 * 64 values each
+         */
+        std::vector<double> mg, eg;
+
+        /**
+         * @brief First moment estimates of Adam
+         */
+        std::vector<double> momentum;
+
+        /**
+         * @brief Second moment estimates of Adam
+         */
+        std::vector<double> velocity;
+
+        /**
+         * @brief Number of Adam steps taken
+         */
+        int steps = 0;
+
+
+        /**
+         * @brief Evaluation of a position with the current parameters, from white's point of view
+         * @param index  index of the position
+         * @return Score in centipawns
+         */
+        [[nodiscard]] double evaluate(size_t index) const;
+
+    public:
+
+        /**
+         * @brief Creates a tuner whose parameters start from \p tables
+         * @param tables  initial piece-square tables
+         */
+        explicit Tuner(const PieceSquareTables &tables);
+
+
+        /**
+         * @brief Extracts the features of a labeled position and adds it to the training set
+         * @param line  line in the format read by parseLabeledPosition
+         * @return True if the position was added. Invalid lines are rejected, as are endgames scored by a specialized
+         * evaluator or scaled down, whose evaluation is not linear in the piece-square tables
+         */
+        bool addPosition(const std::string &line);
+
+
+        /**
+         * @brief Reads every labeled position of a file. Features are extracted in parallel
+         * @param path  path of the file
+         * @param threads  number of threads to use. 0 uses one thread per hardware thread
+         * @return Number of positions added, or -1 if the file could not be opened
+         */
+        long long load(const std::string &path, unsigned threads = 0);
+
+
+        /**
+         * @brief Get method that returns the number of positions in the training set
+         * @return number of positions
+         */
+        [[nodiscard]] size_t size() const;
+
+
+        /**
+         * @brief Mean squared error between the results and the expected scores of the positions
+         * @param k  scaling constant of the sigmoid
+         * @param threads  number of threads to use. 0 uses one thread per hardware thread
+         * @return Mean squared error
+         */
+        [[nodiscard]] double loss(double k, unsigned threads = 0) const;
+
+
+        /**
+         * @brief Finds the scaling constant of the sigmoid that best fits the current parameters
+         * @param threads  number of threads to use. 0 uses one thread per hardware thread
+         * @return Scaling constant minimizing Tuner::loss
+         */
+        [[nodiscard]] double findScalingConstant(unsigned threads = 0) const;
+
+
+        /**
+         * @brief Runs one epoch of full-batch Adam
+         * @param k  scaling constant of the sigmoid
+         * @param learningRate  Adam step size, in centipawns
+         * @param threads  number of threads to use. 0 uses one thread per hardware thread
+         */
+        void step(double k, double learningRate, unsigned threads = 0);
+
+
+        /**
+         * @brief Get method that returns the current parameters, rounded to whole centipawns
+         * @return Piece-square tables holding the current parameters
+         */
+        [[nodiscard]] PieceSquareTables getTables() const;
+    };
+
+}
+
+#endif //CHESSQDL_TUNER_HPP
@@ -0,0 +1,294 @@
+#include "engine.hpp"
+#include "bench.hpp"
+#include "perft.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <sstream>
+
+using namespace chessqdl;
+
+namespace {
+
+    /**
+     * @brief Bounds of the Hash option, in megabytes
+     */
+    constexpr unsigned long long minHashSize = 1;
+    constexpr unsigned long long maxHashSize = 4096;
+
+    /**
+     * @brief Formats the progress of a search as an info line
+     */
+    std::string formatInfo(const SearchInfo &info) {
+        std::ostringstream line;
+
+        line << "info depth " << info.depth << " score cp " << info.score << " nodes " << info.nodes << " nps "
+             << info.nodes * 1000 / std::max(1LL, info.time) << " time " << info.time << " hashfull " << info.hashfull;
+
+        if (!info.pv.empty()) {
+            line << " pv";
+            for (const auto &mv: info.pv)
+                line << " " << mv;
+        }
+
+        return line.str();
+    }
+
+    /**
+     * @brief Reads the arguments of a go command. Unknown arguments are skipped
+     */
+    SearchLimits parseGo(std::istringstream &stream, bool &infinite) {
+        SearchLimits limits;
+        std::string token;
+
+        infinite = false;
+
+        while (stream >> token) {
+            if (token == "depth")
+                stream >> limits.depth;
+            else if (token == "nodes")
+                stream >> limits.nodes;
+            else if (token == "movetime")
+                stream >> limits.moveTime;
+            else if (token == "wtime")
+                stream >> limits.time[nWhite];
+            else if (token == "btime")
+                stream >> limits.time[nBlack];
+            else if (token == "winc")
+                stream >> limits.increment[nWhite];
+            else if (token == "binc")
+                stream >> limits.increment[nBlack];
+            else if (token == "movestogo")
+                stream >> limits.movesToGo;
+            else if (token == "infinite")
+                infinite = true;
+            else if (token == "ponder")
+                limits.ponder = true;
+        }
+
+        return limits;
+    }
+
+    /**
+     * @brief Joins the remaining tokens of a stream with single spaces, up to (and excluding) \p end
+     */
+    std::string readWords(std::istringstream &stream, const std::string &end = "") {
+        std::string words;
+        std::string token;
+
+        while (stream >> token && token != end)
+            words += (words.empty() ? "" : " ") + token;
+
+        return words;
+    }
+
+}
+
+
+/**
+ * @details Commands are read on the calling thread while searches run on a thread of their own, so "isready", "stop"
+ * and "ponderhit" are answered during a search. Every other command waits for the search to be stopped, since it
+ * changes the position or the settings the search is using. <br>
+ *
+ * Infinite and ponder searches hold their best move back until "stop" (or "ponderhit") is received, as required by
+ * the protocol. When the input ends, a bounded search is allowed to finish before returning. <br>
+ *
+ * "bench [depth] [threads] [hash]" is understood as well, and prints the output of printBench.
+ */
+void Engine::uci(std::istream &input, std::ostream &output) {
+    std::mutex outputMutex;
+    std::mutex releaseMutex;
+    std::condition_variable releaseSignal;
+    bool holdBestMove = false;
+    std::thread searchThread;
+
+    const auto send = [&output, &outputMutex](const std::string &message) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        output << message << std::endl;
+    };
+
+    const auto release = [&] {
+        {
+            std::lock_guard<std::mutex> lock(releaseMutex);
+            holdBestMove = false;
+        }
+        releaseSignal.notify_all();
+    };
+
+    const auto waitForSearch = [&](const bool abort) {
+        if (!searchThread.joinable())
+            return;
+
+        if (abort) {
+            stop();
+            release();
+        }
+
+        searchThread.join();
+    };
+
+    beVerbose = false;
+
+    std::string line;
+
+    while (std::getline(input, line)) {
+        std::istringstream stream(line);
+        std::string command;
+        stream >> command;
+
+        if (command.empty())
+            continue;
+
+        if (command == "uci") {
+            send("id name ChessQDL");
+            send("id author Vinicius Couto Tasso");
+            send("option name Hash type spin default 16 min " + std::to_string(minHashSize) + " max " +
+                 std::to_string(maxHashSize));
+            send("option name Ponder type check default false");
+            send("option name EvalFile type string default <empty>");
+            send("option name Clear Hash type button");
+            send("uciok");
+        } else if (command == "isready")
+            send("readyok");
+        else if (command == "stop")
+            waitForSearch(true);
+        else if (command == "ponderhit") {
+            startClock();
+            release();
+        } else if (command == "quit") {
+            waitForSearch(true);
+            return;
+        } else {
+            waitForSearch(true);
+
+            if (command == "ucinewgame") {
+                clearHash();
+                setPosition(startFen);
+            } else if (command == "position") {
+                std::string token;
+                std::string fen;
+                stream >> token;
+
+                if (token == "startpos") {
+                    fen = startFen;
+                    token.clear();
+                    stream >> token;
+                } else if (token == "fen") {
+                    fen = readWords(stream, "moves");
+                    token = "moves";
+                } else {
+                    send("info string Invalid position command");
+                    continue;
+                }
+
+                setPosition(fen);
+
+                while (token == "moves" && stream >> token) {
+                    const auto moves = getLegalMoves();
+
+                    if (std::find(moves.begin(), moves.end(), token) == moves.end()) {
+                        send("info string Illegal move " + token);
+                        break;
+                    }
+
+                    makeMove(token, false, false);
+                    token = "moves";
+                }
+            } else if (command == "go" && line.find(" perft ") != std::string::npos) {
+                // Not part of the protocol, but understood by most engines and by the tools that validate them
+                std::string token;
+                int depth = 1;
+                stream >> token >> depth;
+
+                const PerftResult result = perftDivide(bitboard.getBitBoards(), toMove, std::max(depth, 1), 0, 64);
+                std::lock_guard<std::mutex> lock(outputMutex);
+                printPerft(output, result);
+            } else if (command == "bench") {
+                // Not part of the protocol either, but the usual way to get the node signature of an engine build
+                BenchOptions options;
+                options.network = network;
+                options.pieceSquareTables = pieceSquareTables;
+                stream >> options.depth >> options.threads >> options.hashSize;
+
+                const BenchResult result = runBench(options);
+                std::lock_guard<std::mutex> lock(outputMutex);
+                printBench(output, result);
+            } else if (command == "go") {
+                bool infinite;
+                const SearchLimits limits = parseGo(stream, infinite);
+
+                {
+                    std::lock_guard<std::mutex> lock(releaseMutex);
+                    holdBestMove = infinite || limits.ponder;
+                }
+
+                // A stop or ponderhit that arrived after the previous search was over must not affect this one
+                stopSearch = false;
+                clockRunning = false;
+
+                searchThread = std::thread([this, limits, &send, &releaseMutex, &releaseSignal, &holdBestMove] {
+                    std::string bestMove = search(limits, [&send](const SearchInfo &info) { send(formatInfo(info)); });
+
+                    {
+                        std::unique_lock<std::mutex> lock(releaseMutex);
+                        releaseSignal.wait(lock, [&holdBestMove] { return !holdBestMove; });
+                    }
+
+                    // Stopped before the first move was searched
+                    if (bestMove.empty()) {
+                        const auto moves = getLegalMoves();
+                        bestMove = moves.empty() ? "0000" : moves.front();
+                    }
+
+                    std::string message = "bestmove " + bestMove;
+
+                    if (bestMove != "0000") {
+                        makeMove(bestMove, false, false);
+                        const auto reply = getPrincipalVariation(1);
+                        takeMove();
+
+                        if (!reply.empty())
+                            message += " ponder " + reply.front();
+                    }
+
+                    send(message);
+                });
+            } else if (command == "setoption") {
+                std::string token;
+                stream >> token;
+
+                const std::string name = readWords(stream, "value");
+                const std::string value = readWords(stream);
+
+                if (name == "Hash") {
+                    char *end = nullptr;
+                    const unsigned long long megabytes = std::strtoull(value.c_str(), &end, 10);
+
+                    // Out of range values are clamped to what the option line promises, rather than failing to
+                    // allocate the table in the middle of a game
+                    if (end != value.c_str())
+                        setHashSize(std::clamp(megabytes, minHashSize, maxHashSize));
+                } else if (name == "EvalFile") {
+                    if (value.empty() || value == "<empty>")
+                        setNetwork(nullptr);
+                    else if (!loadNetwork(value))
+                        send("info string Could not read network file " + value);
+                } else if (name == "Clear Hash")
+                    clearHash();
+                else if (name != "Ponder")
+                    send("info string Unknown option " + name);
+            } else
+                send("info string Unknown command " + command);
+        }
+    }
+
+    bool held;
+    {
+        std::lock_guard<std::mutex> lock(releaseMutex);
+        held = holdBestMove;
+    }
+
+    waitForSearch(held);
+}
@@ -1,8 +1,8 @@
 #include "utils.hpp"
-#include "movegen.hpp"
 
 #include <cmath>
 #include <iostream>
+#include <thread>
 
 using namespace chessqdl;
 
@@ -19,59 +19,6 @@ std::string chessqdl::posToStr(uint64_t pos) {
 }
 
 
-/**
- * @details Performs an evaluation that takes into account the material balance and number of available moves. <br>
- *
- * Piece value is as follows: <br>
- * King   - 200 <br>
- * Queen  - 9 <br>
- * Rook   - 5 <br>
- * Bishop - 3 <br>
- * Knight - 3 <br>
- * Pawn   - 1 <br>
- *
- * @todo Count only legal moves and create separate files for board evaluation
- */
-int chessqdl::evaluateBoard(const BitboardArray &board, const enumColor color) {
-	// King count
-	const int k = static_cast<int>((board[nKing] & board[color]).count());
-	const int kPrime = static_cast<int>(board[nKing].count() - k);
-
-	// Queen count
-	const int q = static_cast<int>((board[nQueen] & board[color]).count());
-	const int qPrime = static_cast<int>(board[nQueen].count() - q);
-
-	// Rook count
-	const int r = static_cast<int>((board[nRook] & board[color]).count());
-	const int rPrime = static_cast<int>(board[nRook].count() - r);
-
-	// Knight count
-	const int n = static_cast<int>((board[nKnight] & board[color]).count());
-	const int nPrime = static_cast<int>(board[nKnight].count() - n);
-
-	// Bishop count
-	const int b = static_cast<int>((board[nBishop] & board[color]).count());
-	const int bPrime = static_cast<int>(board[nBishop].count() - b);
-
-	// Pawn count
-	const int p = static_cast<int>((board[nPawn] & board[color]).count());
-	const int pPrime = static_cast<int>(board[nPawn].count() - p);
-
-	const enumColor enemyColor = color == nWhite ? nBlack : nWhite;
-
-	// Move count
-	const int m = static_cast<int>(MoveGenerator::getPseudoLegalMoves(board, color).size());
-	const int mPrime = static_cast<int>(MoveGenerator::getPseudoLegalMoves(board, enemyColor).size());
-
-	int score = 200 * (k - kPrime) + 9 * (q - qPrime) + 5 * (r - rPrime) + 3 * (n - nPrime + b - bPrime) + (p - pPrime);
-	score += static_cast<int>(0.1 * (m - mPrime));
-
-	//if (color == nBlack) score *= -1;
-
-	return score;
-}
-
-
 /**
  * @details Ignore input if not a valid integer and keep reading from stdin until the input is valid
  */
@@ -102,3 +49,56 @@ std::string chessqdl::moveName(const uint64_t from, const uint64_t to) {
 
 	return from_str.append(to_str);
 }
+
+
+/**
+ * @details Squares are parsed directly from their file and rank characters. The promotion piece, if any, is stored as
+ * 1 (knight) to 4 (queen).
+ */
+PackedMove chessqdl::packMove(const std::string &mv) {
+	if (mv.size() < 4 || mv[0] < 'a' || mv[0] > 'h' || mv[1] < '1' || mv[1] > '8' || mv[2] < 'a' || mv[2] > 'h' ||
+		mv[3] < '1' || mv[3] > '8')
+		return nullMove;
+
+	const int from = (mv[1] - '1') * 8 + (mv[0] - 'a');
+	const int to = (mv[3] - '1') * 8 + (mv[2] - 'a');
+
+	int promotion = 0;
+	if (mv.size() > 4) {
+		const std::string promotions = "nbrq";
+		const auto pos = promotions.find(mv[4]);
+		if (pos != std::string::npos)
+			promotion = static_cast<int>(pos) + 1;
+	}
+
+	return static_cast<PackedMove>(from | (to << 6) | (promotion << 12));
+}
+
+
+/**
+ * @details Inverse of packMove.
+ */
+std::string chessqdl::unpackMove(const PackedMove mv) {
+	std::string name = mapPositions[mv & 0x3f] + mapPositions[(mv >> 6) & 0x3f];
+
+	if (const int promotion = (mv >> 12) & 0x7; promotion != 0)
+		name += "nbrq"[promotion - 1];
+
+	return name;
+}
+
+
+size_t chessqdl::tableEntries(const size_t megabytes, const size_t entrySize) {
+	const size_t maxEntries = std::max<size_t>(megabytes, 1) * 1024 * 1024 / entrySize;
+
+	size_t entries = 1;
+	while (entries * 2 <= maxEntries)
+		entries *= 2;
+
+	return entries;
+}
+
+
+unsigned chessqdl::resolveThreads(const unsigned threads) {
+	return threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+}
@@ -1,7 +1,9 @@
 #ifndef CHESSQDL_UTILS_HPP
 #define CHESSQDL_UTILS_HPP
 
+#include <algorithm>
 #include <cstdint>
+#include <thread>
 #include "const.hpp"
 
 namespace chessqdl {
@@ -14,15 +16,6 @@ namespace chessqdl {
 	std::string posToStr(uint64_t pos);
 
 
-	/**
-	 * @brief Heuristic function to evaluate the color.
-	 * @param board  board to evaluate
-	 * @param color  here colors defines the perspective of the evaluation. If the board is better for the \p color pieces, result will be positive. Otherwise, it will be negative
-	 * @return Score of the board indicating who has the advantage
-	 */
-	int evaluateBoard(const BitboardArray &board, enumColor color);
-
-
 	/**
 	 * @brief Method to read an integer from stdin in a clean and sanitized way.
 	 * @param n  variable that will store the integer read from std::cin
@@ -44,11 +37,66 @@ namespace chessqdl {
 	 */
 	std::string moveName(uint64_t from, uint64_t to);
 
+	/**
+	 * @brief Converts a move in algebraic notation (e.g. e2e4, e7e8q) to its packed representation
+	 * @param mv  move string as generated by MoveGenerator
+	 * @return The packed move, or nullMove if \p mv is malformed
+	 */
+	PackedMove packMove(const std::string &mv);
+
+	/**
+	 * @brief Converts a packed move back to algebraic notation
+	 * @param mv  packed move
+	 * @return Name of the move (e.g. e2e4, e7e8q)
+	 */
+	std::string unpackMove(PackedMove mv);
+
+	/**
+	 * @brief Number of entries of a hash table that fills at most a given size
+	 * @param megabytes  size of the table. 0 is taken as 1
+	 * @param entrySize  size of an entry, in bytes
+	 * @return The largest power of two of entries that fits, so that indexing is a simple mask operation. At least 1
+	 */
+	size_t tableEntries(size_t megabytes, size_t entrySize);
+
+	/**
+	 * @brief Number of threads to use for a requested number of threads
+	 * @param threads  requested number of threads. 0 stands for one per hardware thread
+	 * @return \p threads, or the number of hardware threads if it is 0. At least 1
+	 */
+	unsigned resolveThreads(unsigned threads);
+
+	/**
+	 * @brief Calls \p fn(begin, end, thread) on contiguous ranges covering [0, size), one per thread, in parallel. The
+	 * calling thread takes the first range
+	 * @param size  number of items
+	 * @param threads  number of threads, as given to resolveThreads. No more threads than items are used
+	 * @param fn  function called with the range of each thread and its index, from 0
+	 */
+	template<typename Function>
+	void parallelFor(const size_t size, unsigned threads, Function fn) {
+		threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(resolveThreads(threads), size)));
+		const size_t chunk = (size + threads - 1) / threads;
+		std::vector<std::thread> workers;
+
+		for (unsigned t = 1; t < threads; t++)
+			workers.emplace_back(fn, std::min(size, t * chunk), std::min(size, (t + 1) * chunk), t);
+
+		fn(0, std::min(size, chunk), 0u);
+
+		for (auto &worker: workers)
+			worker.join();
+	}
+
 	typedef struct scoreStruct scoreStruct;
 
+	/**
+	 * @brief A move along with its score and the principal variation that starts with it
+	 */
 	struct scoreStruct {
 		int score;
 		std::string move;
+		std::vector<std::string> pv;
 	};
 
 
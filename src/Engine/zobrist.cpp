@@ -0,0 +1,70 @@
+#include "zobrist.hpp"
+#include "utils.hpp"
+
+#include <random>
+
+using namespace chessqdl;
+
+namespace {
+
+    /**
+     * @brief All random keys used by the hashing scheme. The seed is fixed so hashes are reproducible between runs
+     */
+    struct ZobristKeys {
+        uint64_t pieces[2][6][64];
+        uint64_t side;
+
+        ZobristKeys() {
+            std::mt19937_64 rng(0x9e3779b97f4a7c15ULL);
+
+            for (auto &color: pieces)
+                for (auto &piece: color)
+                    for (auto &square: piece)
+                        square = rng();
+
+            side = rng();
+        }
+    };
+
+    const ZobristKeys keys;
+
+}
+
+
+/**
+ * @details Pieces are indexed from nPawn, so the piece type is offset before indexing the key table.
+ */
+uint64_t Zobrist::getPieceKey(const enumColor color, const int piece, const int square) {
+    return keys.pieces[color][piece - nPawn][square];
+}
+
+
+/**
+ * @details The side key is XORed into the hash when black is to move.
+ */
+uint64_t Zobrist::getSideKey() {
+    return keys.side;
+}
+
+
+/**
+ * @details XORs the keys of every piece on the board, plus the side key if black is to move. Engine keeps its hash
+ * up to date incrementally, so this is only needed when a position is set up from scratch.
+ */
+uint64_t Zobrist::hashBoard(const BitboardArray &board, const enumColor toMove) {
+    uint64_t hash = toMove == nBlack ? keys.side : 0;
+
+    for (int color = nWhite; color <= nBlack; color++) {
+        for (int piece = nPawn; piece <= nKing; piece++) {
+            uint64_t pieces = (board[piece] & board[color]).to_ullong();
+
+            while (pieces) {
+                const int square = leastSignificantSetBit(pieces);
+                pieces &= pieces - 1;
+                hash ^= getPieceKey(static_cast<enumColor>(color), piece, square);
+            }
+        }
+    }
+
+    return hash;
+}
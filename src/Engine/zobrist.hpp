@@ -0,0 +1,45 @@
+#ifndef CHESSQDL_ZOBRIST_HPP
+#define CHESSQDL_ZOBRIST_HPP
+
+#include "const.hpp"
+
+#include <cstdint>
+
+namespace chessqdl {
+
+    class Zobrist {
+
+    public:
+
+        Zobrist() = default;
+
+
+        /**
+         * @brief Returns the random key associated with a piece standing on a square
+         * @param color  color of the piece (nWhite or nBlack)
+         * @param piece  type of the piece (nPawn to nKing)
+         * @param square  index of the square (a1 to h8)
+         * @return 64 bit key of the piece-square pair
+         */
+        static uint64_t getPieceKey(enumColor color, int piece, int square);
+
+
+        /**
+         * @brief Returns the key that is toggled whenever the side to move changes
+         * @return 64 bit key of the side to move
+         */
+        static uint64_t getSideKey();
+
+
+        /**
+         * @brief Computes the hash of a board from scratch
+         * @param board  board to be hashed
+         * @param toMove  color of the pieces to move
+         * @return 64 bit Zobrist hash of the position
+         */
+        static uint64_t hashBoard(const BitboardArray &board, enumColor toMove);
+    };
+
+}
+
+#endif //CHESSQDL_ZOBRIST_HPP
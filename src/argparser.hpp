@@ -3,21 +3,40 @@
 
 #include <iostream>
 #include <cxxopts.hpp>
+#include "Engine/analysis.hpp"
+#include "Engine/bench.hpp"
 #include "Engine/utils.hpp"
 
 using namespace chessqdl;
 
 
-inline void argumentParser(const int argc, char **argv, int &level, enumColor &enginePieces, bool &verbose, std::string &fen, bool &pvp, std::optional<int> &seed) {
+inline void argumentParser(const int argc, char **argv, int &level, enumColor &enginePieces, bool &verbose, std::string &fen, bool &pvp, std::optional<int> &seed, bool &ponder, size_t &hashSize, size_t &pawnHashSize, size_t &evalCacheSize, std::string &weights, std::string &evalFile, bool &uci, std::string &batchFile, AnalysisOptions &analysis, std::string &serveAddress, bool &bench, BenchOptions &benchOptions) {
 	cxxopts::Options options("ChessQDL", "Simple chess engine with a terminal interface");
 
+	std::string format = "csv";
+
 	options.add_options()
 			("play_as_black", "Play with black pieces against the engine's white pieces")
 			("p,pvp", "Player vs player")
+			("ponder", "Think on the opponent's time")
+			("uci", "Speak the Universal Chess Interface protocol instead of the terminal interface")
 			("v,verbose", "Be verbose")
 			("l,level", "Level of the engine. The higher the value, the higher the difficulty. Accepted values range from 1 to 10", cxxopts::value(level))
 			("f,fen", "FEN string that represents the initial state of the desired board", cxxopts::value(fen))
 			("s,seed", "Random number generator seed", cxxopts::value(seed))
+			("hash", "Size of the transposition table in megabytes", cxxopts::value(hashSize))
+			("pawn-hash", "Size of the pawn hash table in megabytes", cxxopts::value(pawnHashSize))
+			("eval-cache", "Size of the evaluation cache in megabytes", cxxopts::value(evalCacheSize))
+			("w,weights", "File with the piece-square tables used by the evaluation", cxxopts::value(weights))
+			("eval-file", "Neural network weights file. When given, the network replaces the handcrafted evaluation", cxxopts::value(evalFile))
+			("batch", "Analyze every position of a FEN or EPD file (- for stdin), print the results and exit", cxxopts::value(batchFile))
+			("format", "Format of the batch results: csv or jsonl", cxxopts::value(format))
+			("bench", "Search a fixed set of positions to a fixed depth, print the total nodes and the speed, and exit")
+			("depth", "Depth searched for each batch position, served request or bench position. Defaults to the level, or to 5 for bench", cxxopts::value(analysis.limits.depth))
+			("nodes", "Maximum number of nodes searched for each batch position or served request", cxxopts::value(analysis.limits.nodes))
+			("movetime", "Time spent on each batch position or served request, in milliseconds", cxxopts::value(analysis.limits.moveTime))
+			("serve", "Serve JSON analysis requests on a Unix domain socket (unix:PATH) or on a localhost TCP port", cxxopts::value(serveAddress))
+			("threads", "Number of batch positions, served requests or bench positions analyzed at the same time. Defaults to one per hardware thread, or to 1 for bench", cxxopts::value(analysis.threads))
 			("h,help", "Display this help and exit");
 
 	try {
@@ -30,6 +49,8 @@ inline void argumentParser(const int argc, char **argv, int &level, enumColor &e
 
 		verbose = args.count("verbose") != 0;
 		pvp = args.count("pvp") != 0;
+		ponder = args.count("ponder") != 0;
+		uci = args.count("uci") != 0;
 
 		if (args.count("level")) {
 			if (args["level"].as<int>() > 10 || args["level"].as<int>() < 1) {
@@ -38,6 +59,36 @@ inline void argumentParser(const int argc, char **argv, int &level, enumColor &e
 			} else level = args["level"].as<int>();
 		} else level = 3;
 
+		if (!args.count("hash"))
+			hashSize = 16;
+
+		if (!args.count("pawn-hash"))
+			pawnHashSize = 2;
+
+		if (!args.count("eval-cache"))
+			evalCacheSize = 1;
+
+		if (format == "jsonl")
+			analysis.format = nJsonl;
+		else if (format == "csv")
+			analysis.format = nCsv;
+		else {
+			std::cout << "ChessQDL: Unknown batch format " << format << std::endl;
+			exit(1);
+		}
+
+		bench = args.count("bench") != 0;
+		benchOptions.hashSize = hashSize;
+
+		if (args.count("depth"))
+			benchOptions.depth = analysis.limits.depth;
+
+		if (args.count("threads"))
+			benchOptions.threads = analysis.threads;
+
+		if (!args.count("depth") && !args.count("nodes") && !args.count("movetime"))
+			analysis.limits.depth = level;
+
 		if (args.count("play_as_black"))
 			enginePieces = nWhite;
 		else
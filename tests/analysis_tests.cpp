@@ -0,0 +1,132 @@
+#include "gtest/gtest.h"
+
+#include "Engine/analysis.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+	std::vector<std::string> splitLines(const std::string &text) {
+		std::vector<std::string> lines;
+		std::istringstream stream(text);
+		std::string line;
+
+		while (std::getline(stream, line))
+			lines.push_back(line);
+
+		return lines;
+	}
+
+}
+
+TEST(Analysis, ParsePosition_Test) {
+	std::string fen;
+	std::string id;
+
+	EXPECT_TRUE(chessqdl::parsePosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", fen, id));
+	EXPECT_EQ(fen, "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+	EXPECT_TRUE(id.empty());
+
+	EXPECT_TRUE(chessqdl::parsePosition(R"(6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - bm Rd8#; id "back rank";)", fen, id));
+	EXPECT_EQ(fen, "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1");
+	EXPECT_EQ(id, "back rank");
+
+	// Missing king, bad rank length and bad side to move
+	EXPECT_FALSE(chessqdl::parsePosition("8/8/8/8/8/8/8/4K3 w - - 0 1", fen, id));
+	EXPECT_FALSE(chessqdl::parsePosition("4k3/9/8/8/8/8/8/4K3 w - - 0 1", fen, id));
+	EXPECT_FALSE(chessqdl::parsePosition("4k3/8/8/8/8/8/8/4K3 x - - 0 1", fen, id));
+}
+
+TEST(Analysis, CsvInInputOrder_Test) {
+	std::string input = "# comment\n\n";
+	for (int i = 0; i < 20; i++) {
+		input += i % 2 == 0 ? "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1\n"
+		                    : "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3\n";
+	}
+	input += "not a position\n";
+
+	chessqdl::AnalysisOptions options;
+	options.limits.depth = 2;
+	options.threads = 3;
+	options.hashSize = 1;
+
+	std::istringstream stream(input);
+	std::ostringstream output;
+
+	EXPECT_EQ(chessqdl::analyzePositions(stream, output, options), 21);
+
+	const auto lines = splitLines(output.str());
+	ASSERT_EQ(lines.size(), 22);
+	EXPECT_EQ(lines[0], "id,bestmove,score,depth,nodes,time");
+
+	// Positions without an id are named after their line, counting the skipped ones
+	for (int i = 0; i < 20; i++) {
+		EXPECT_EQ(lines[i + 1].substr(0, lines[i + 1].find(',')), std::to_string(i + 3));
+
+		// The back rank mate is found at depth 1
+		if (i % 2 == 0) {
+			EXPECT_EQ(lines[i + 1].substr(0, lines[i + 1].find(',', lines[i + 1].find(',') + 1)),
+					  std::to_string(i + 3) + ",d1d8");
+		}
+	}
+
+	EXPECT_EQ(lines[21], "23,,,,,");
+}
+
+TEST(Analysis, Jsonl_Test) {
+	chessqdl::AnalysisOptions options;
+	options.limits.nodes = 500;
+	options.threads = 2;
+	options.format = chessqdl::nJsonl;
+	options.hashSize = 1;
+
+	std::istringstream stream("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - - id \"start\";\n"
+							  "k7/8/1QK5/8/8/8/8/8 b - - 0 1\n");
+	std::ostringstream output;
+
+	EXPECT_EQ(chessqdl::analyzePositions(stream, output, options), 2);
+
+	const auto lines = splitLines(output.str());
+	ASSERT_EQ(lines.size(), 2);
+	EXPECT_EQ(lines[0].rfind(R"({"id":"start","bestmove":")", 0), 0);
+	EXPECT_NE(lines[0].find(R"("nodes":)"), std::string::npos);
+	// Stalemate
+	EXPECT_EQ(lines[1].rfind(R"({"id":"2","bestmove":"0000")", 0), 0);
+}
+
+TEST(Analysis, Deterministic_Test) {
+	std::string input;
+	for (int i = 0; i < 12; i++) {
+		input += i % 3 == 0 ? "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w - - 2 3\n"
+		       : i % 3 == 1 ? "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w - - 0 1\n"
+		                    : "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1\n";
+	}
+
+	chessqdl::AnalysisOptions options;
+	options.limits.depth = 3;
+	options.hashSize = 1;
+
+	// Everything but the id and the time is the same whatever the thread that searched each position before
+	const auto analyze = [&](const unsigned threads) {
+		options.threads = threads;
+		std::istringstream stream(input);
+		std::ostringstream output;
+		chessqdl::analyzePositions(stream, output, options);
+
+		std::vector<std::string> lines = splitLines(output.str());
+		for (auto &line: lines)
+			line = line.substr(line.find(','), line.rfind(',') - line.find(','));
+
+		return lines;
+	};
+
+	const auto expected = analyze(1);
+	ASSERT_EQ(expected.size(), 13);
+
+	for (int i = 1; i <= 12; i += 3)
+		EXPECT_EQ(expected[i], expected[1]);
+
+	EXPECT_EQ(analyze(3), expected);
+}
@@ -0,0 +1,74 @@
+#include "gtest/gtest.h"
+
+#include "Engine/batch.hpp"
+#include "Engine/engine.hpp"
+#include "Engine/evaluation.hpp"
+#include "Engine/movegen.hpp"
+
+#include <random>
+
+namespace {
+
+	/**
+	 * @brief Collects the positions of random playouts from a few starting positions
+	 */
+	chessqdl::PositionBatch makeBatch(const size_t size) {
+		const std::vector<std::string> fens = {
+			"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+			"r1bqk1nr/pppp1ppp/2n5/2b1p3/1PB1P3/5N2/P1PP1PPP/RNBQK2R b KQkq b3 1 4",
+			"1r2k3/P1P5/8/8/8/8/1p4p1/R3K3 w - - 0 1"
+		};
+
+		chessqdl::PositionBatch batch;
+		std::mt19937 rng(7);
+
+		while (batch.size() < size) {
+			chessqdl::Engine engine(fens[batch.size() % fens.size()], chessqdl::nWhite, 1, false, false, 0);
+
+			for (int ply = 0; ply < 60 && batch.size() < size; ply++) {
+				const auto board = engine.getBitboard().getBitBoards();
+				const auto moves = chessqdl::MoveGenerator::getPseudoLegalMoves(board, engine.getToMove());
+
+				if (moves.empty() || board[chessqdl::nKing].count() < 2)
+					break;
+
+				batch.add(board);
+				engine.makeMove(moves[rng() % moves.size()], false, false);
+			}
+		}
+
+		return batch;
+	}
+
+}
+
+TEST(Batch, Layout_Test) {
+	chessqdl::Bitboard board("r1bqk1nr/pppp1ppp/2n5/2b1p3/1PB1P3/5N2/P1PP1PPP/RNBQK2R b KQkq b3 1 4");
+	chessqdl::PositionBatch batch;
+
+	EXPECT_EQ(batch.size(), 0);
+	EXPECT_TRUE(chessqdl::evaluateBatch(batch, chessqdl::nWhite).empty());
+
+	batch.add(chessqdl::Bitboard().getBitBoards());
+	batch.add(board.getBitBoards());
+
+	EXPECT_EQ(batch.size(), 2);
+	EXPECT_EQ(batch.get(1), board.getBitBoards());
+	EXPECT_EQ(batch.boards[chessqdl::nPawn][0], 0x00ff00000000ff00ULL);
+}
+
+TEST(Batch, MatchesScalarEvaluation_Test) {
+	const chessqdl::PositionBatch batch = makeBatch(1500);
+
+	for (int color = chessqdl::nWhite; color <= chessqdl::nBlack; color++) {
+		const auto c = static_cast<chessqdl::enumColor>(color);
+
+		for (const unsigned threads: {1u, 4u}) {
+			const std::vector<int> scores = chessqdl::evaluateBatch(batch, c, threads);
+			ASSERT_EQ(scores.size(), batch.size());
+
+			for (size_t i = 0; i < batch.size(); i++)
+				ASSERT_EQ(scores[i], chessqdl::evaluateBoard(batch.get(i), c)) << "position " << i;
+		}
+	}
+}
@@ -0,0 +1,47 @@
+#include "gtest/gtest.h"
+
+#include "Engine/analysis.hpp"
+#include "Engine/bench.hpp"
+#include "Engine/bitboard.hpp"
+#include "Engine/movegen.hpp"
+
+#include <numeric>
+
+TEST(Bench, Positions_Test) {
+	EXPECT_EQ(chessqdl::benchPositions.size(), 40);
+
+	for (const auto &position: chessqdl::benchPositions) {
+		std::string fen, id;
+		ASSERT_TRUE(chessqdl::parsePosition(position, fen, id)) << position;
+		EXPECT_EQ(fen, position);
+
+		const chessqdl::BitboardArray board = chessqdl::Bitboard(fen).getBitBoards();
+		const chessqdl::enumColor toMove = fen[fen.find(' ') + 1] == 'w' ? chessqdl::nWhite : chessqdl::nBlack;
+
+		EXPECT_FALSE(chessqdl::MoveGenerator::getLegalMoves(board, toMove).empty()) << position;
+		EXPECT_FALSE(chessqdl::MoveGenerator::isKingAttacked(board, toMove == chessqdl::nWhite ? chessqdl::nBlack
+																							  : chessqdl::nWhite))
+							<< position;
+	}
+}
+
+TEST(Bench, Deterministic_Test) {
+	chessqdl::BenchOptions options;
+	options.depth = 2;
+	options.hashSize = 1;
+
+	const chessqdl::BenchResult first = chessqdl::runBench(options);
+	ASSERT_EQ(first.positionNodes.size(), chessqdl::benchPositions.size());
+	EXPECT_EQ(first.nodes, std::accumulate(first.positionNodes.begin(), first.positionNodes.end(), 0LL));
+
+	for (const long long nodes: first.positionNodes)
+		EXPECT_GT(nodes, 0);
+
+	// Neither the number of threads nor the previous run change the nodes searched
+	options.threads = 3;
+	const chessqdl::BenchResult second = chessqdl::runBench(options);
+	EXPECT_EQ(second.positionNodes, first.positionNodes);
+
+	options.depth = 3;
+	EXPECT_GT(chessqdl::runBench(options).nodes, first.nodes);
+}
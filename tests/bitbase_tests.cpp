@@ -0,0 +1,190 @@
+#include "gtest/gtest.h"
+
+#include "Engine/bitbase.hpp"
+#include "Engine/bitboard.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+	int distance(const int a, const int b) {
+		return std::max(std::abs(a % 8 - b % 8), std::abs(a / 8 - b / 8));
+	}
+
+	/**
+	 * Forward search over king and pawn against king positions, white having the pawn. White wins when the pawn is
+	 * promoted and the new queen cannot be taken at once, which is the definition used by the bitbase
+	 */
+	class BruteForce {
+	private:
+		// Smallest number of plies known to be enough to win, and largest number known not to be, for each position
+		std::vector<int> winPlies = std::vector<int>(2 * 64 * 64 * 64, 1000);
+		std::vector<int> failPlies = std::vector<int>(2 * 64 * 64 * 64, -1);
+
+		static int index(const int whiteKing, const int pawn, const int blackKing, const bool whiteToMove) {
+			return whiteKing | pawn << 6 | blackKing << 12 | (whiteToMove ? 1 << 18 : 0);
+		}
+
+		bool search(const int whiteKing, const int pawn, const int blackKing, const bool whiteToMove, const int plies) {
+			const int i = index(whiteKing, pawn, blackKing, whiteToMove);
+
+			if (plies >= winPlies[i])
+				return true;
+			if (plies <= failPlies[i] || plies <= 0)
+				return false;
+
+			const bool result = whiteToMove ? searchWhite(whiteKing, pawn, blackKing, plies)
+			                                : searchBlack(whiteKing, pawn, blackKing, plies);
+
+			if (result)
+				winPlies[i] = std::min(winPlies[i], plies);
+			else
+				failPlies[i] = std::max(failPlies[i], plies);
+
+			return result;
+		}
+
+		bool searchWhite(const int whiteKing, const int pawn, const int blackKing, const int plies) {
+			for (int to = 0; to < 64; to++) {
+				if (distance(to, whiteKing) == 1 && distance(to, blackKing) > 1 && to != pawn &&
+				    search(to, pawn, blackKing, false, plies - 1))
+					return true;
+			}
+
+			const int front = pawn + 8;
+
+			if (front == whiteKing || front == blackKing)
+				return false;
+
+			if (front / 8 == 7)
+				return distance(blackKing, front) > 1 || distance(whiteKing, front) == 1;
+
+			if (search(whiteKing, front, blackKing, false, plies - 1))
+				return true;
+
+			return pawn / 8 == 1 && front + 8 != whiteKing && front + 8 != blackKing &&
+			       search(whiteKing, front + 8, blackKing, false, plies - 1);
+		}
+
+		bool searchBlack(const int whiteKing, const int pawn, const int blackKing, const int plies) {
+			bool hasMove = false;
+
+			for (int to = 0; to < 64; to++) {
+				const bool attackedByPawn = to / 8 == pawn / 8 + 1 && std::abs(to % 8 - pawn % 8) == 1;
+
+				if (distance(to, blackKing) != 1 || distance(to, whiteKing) <= 1 || attackedByPawn)
+					continue;
+
+				// Taking the pawn draws
+				if (to == pawn)
+					return false;
+
+				hasMove = true;
+
+				if (!search(whiteKing, pawn, to, true, plies - 1))
+					return false;
+			}
+
+			// Stalemate
+			return hasMove;
+		}
+
+	public:
+		bool wins(const int whiteKing, const int pawn, const int blackKing, const bool whiteToMove) {
+			return search(whiteKing, pawn, blackKing, whiteToMove, 100);
+		}
+	};
+
+	bool probeFen(const std::string &fen, const chessqdl::enumColor sideToMove) {
+		chessqdl::Bitboard board(fen);
+		return chessqdl::probeKPK(board.getBitBoards(), sideToMove) == chessqdl::nBitbaseWin;
+	}
+
+}
+
+TEST(Bitbase, KnownPositions_Test) {
+	// King on the sixth rank in front of its pawn wins whoever is to move
+	EXPECT_TRUE(probeFen("4k3/8/4K3/4P3/8/8/8/8 w - - 0 1", chessqdl::nWhite));
+	EXPECT_TRUE(probeFen("4k3/8/4K3/4P3/8/8/8/8 b - - 0 1", chessqdl::nBlack));
+
+	// Pushing the pawn to the seventh rank with check only stalemates
+	EXPECT_FALSE(probeFen("4k3/8/4P3/4K3/8/8/8/8 w - - 0 1", chessqdl::nWhite));
+
+	// The black king cannot be driven out of the corner of a rook pawn
+	EXPECT_FALSE(probeFen("k7/8/8/P7/8/8/8/4K3 w - - 0 1", chessqdl::nWhite));
+
+	// The black king is outside the square of the pawn
+	EXPECT_TRUE(probeFen("8/8/8/4P3/8/8/8/k3K3 b - - 0 1", chessqdl::nBlack));
+
+	// Same positions with the colors swapped
+	EXPECT_TRUE(probeFen("8/8/8/8/4p3/4k3/8/4K3 b - - 0 1", chessqdl::nBlack));
+	EXPECT_FALSE(probeFen("8/8/8/8/4k3/4p3/8/4K3 b - - 0 1", chessqdl::nBlack));
+}
+
+TEST(Bitbase, InvalidPositions_Test) {
+	using chessqdl::probeKPK;
+
+	// Kings next to each other, the black king in check with white to move, and pieces on the same square
+	EXPECT_EQ(probeKPK(chessqdl::nWhite, chessqdl::e6, chessqdl::e5, chessqdl::e7, chessqdl::nBlack),
+	          chessqdl::nBitbaseInvalid);
+	EXPECT_EQ(probeKPK(chessqdl::nWhite, chessqdl::e1, chessqdl::e5, chessqdl::d6, chessqdl::nWhite),
+	          chessqdl::nBitbaseInvalid);
+	EXPECT_EQ(probeKPK(chessqdl::nWhite, chessqdl::e5, chessqdl::e5, chessqdl::e8, chessqdl::nWhite),
+	          chessqdl::nBitbaseInvalid);
+
+	// The same black king in check is legal with black to move
+	EXPECT_NE(probeKPK(chessqdl::nWhite, chessqdl::e1, chessqdl::e5, chessqdl::d6, chessqdl::nBlack),
+	          chessqdl::nBitbaseInvalid);
+
+	// Pawns on the first and last ranks have no entry
+	EXPECT_EQ(probeKPK(chessqdl::nWhite, chessqdl::e1, chessqdl::a8, chessqdl::h1, chessqdl::nWhite),
+	          chessqdl::nBitbaseInvalid);
+	EXPECT_EQ(probeKPK(chessqdl::nBlack, chessqdl::e8, chessqdl::h1, chessqdl::a8, chessqdl::nBlack),
+	          chessqdl::nBitbaseInvalid);
+	EXPECT_EQ(probeKPK(chessqdl::nWhite, chessqdl::e8, chessqdl::h1, chessqdl::a8, chessqdl::nBlack),
+	          chessqdl::nBitbaseInvalid);
+
+	// Boards left without a king by the search
+	EXPECT_EQ(chessqdl::probeKPK(chessqdl::Bitboard("8/8/4K3/4P3/8/8/8/8 w - - 0 1").getBitBoards(),
+	                             chessqdl::nWhite), chessqdl::nBitbaseInvalid);
+}
+
+TEST(Bitbase, BruteForce_Test) {
+	chessqdl::initBitbases(4);
+
+	BruteForce bruteForce;
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<int> square(0, 63);
+	std::uniform_int_distribution<int> pawnSquare(8, 55);
+
+	int tested = 0;
+
+	while (tested < 3000) {
+		const int whiteKing = square(generator);
+		const int pawn = pawnSquare(generator);
+		const int blackKing = square(generator);
+		const bool whiteToMove = tested % 2 == 0;
+		const bool blackInCheck = blackKing / 8 == pawn / 8 + 1 && std::abs(blackKing % 8 - pawn % 8) == 1;
+
+		if (distance(whiteKing, blackKing) <= 1 || whiteKing == pawn || blackKing == pawn ||
+		    (whiteToMove && blackInCheck))
+			continue;
+
+		tested++;
+
+		const chessqdl::enumColor sideToMove = whiteToMove ? chessqdl::nWhite : chessqdl::nBlack;
+		const chessqdl::enumColor flippedToMove = whiteToMove ? chessqdl::nBlack : chessqdl::nWhite;
+		const bool expected = bruteForce.wins(whiteKing, pawn, blackKing, whiteToMove);
+
+		ASSERT_EQ(chessqdl::probeKPK(chessqdl::nWhite, whiteKing, pawn, blackKing, sideToMove) == chessqdl::nBitbaseWin,
+		          expected)
+			<< "white king " << whiteKing << ", pawn " << pawn << ", black king " << blackKing;
+
+		// The same position with the colors swapped
+		ASSERT_EQ(chessqdl::probeKPK(chessqdl::nBlack, whiteKing ^ 56, pawn ^ 56, blackKing ^ 56, flippedToMove) ==
+		          chessqdl::nBitbaseWin, expected);
+	}
+}
@@ -0,0 +1,172 @@
+#include "gtest/gtest.h"
+
+#include "ChessQDL/chessqdl.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+	uint16_t move(const cqdl_engine *engine, const char *text) {
+		uint16_t mv = 0;
+		EXPECT_EQ(cqdl_parse_move(engine, text, &mv), CQDL_OK) << text;
+		return mv;
+	}
+
+	std::string name(const uint16_t mv) {
+		char buffer[6];
+		EXPECT_EQ(cqdl_move_to_string(mv, buffer, sizeof(buffer)), CQDL_OK);
+		return buffer;
+	}
+
+}
+
+TEST(CApi, Position_Test) {
+	EXPECT_EQ(cqdl_api_version(), CQDL_API_VERSION);
+
+	cqdl_engine *engine = cqdl_create();
+	ASSERT_NE(engine, nullptr);
+
+	cqdl_position position;
+	ASSERT_EQ(cqdl_get_position(engine, &position), CQDL_OK);
+	EXPECT_EQ(position.colors[CQDL_WHITE], 0xffffULL);
+	EXPECT_EQ(position.pieces[0], 0x00ff00000000ff00ULL);
+	EXPECT_EQ(position.side_to_move, CQDL_WHITE);
+
+	// Legal moves, into buffers that are too small and large enough
+	size_t count = 0;
+	EXPECT_EQ(cqdl_legal_moves(engine, nullptr, 0, &count), CQDL_BUFFER_TOO_SMALL);
+	EXPECT_EQ(count, 20);
+
+	std::vector<uint16_t> moves(count);
+	EXPECT_EQ(cqdl_legal_moves(engine, moves.data(), 5, &count), CQDL_BUFFER_TOO_SMALL);
+	EXPECT_EQ(cqdl_legal_moves(engine, moves.data(), moves.size(), &count), CQDL_OK);
+	EXPECT_NE(std::find(moves.begin(), moves.end(), move(engine, "Nf3")), moves.end());
+
+	// Moves in any notation, played and taken back
+	EXPECT_EQ(name(move(engine, "e2e4")), "e2e4");
+	EXPECT_EQ(cqdl_make_move(engine, move(engine, "e4")), CQDL_OK);
+	EXPECT_EQ(cqdl_make_move(engine, move(engine, "e7-e5")), CQDL_OK);
+	uint16_t illegal = 0;
+	EXPECT_EQ(cqdl_parse_move(engine, "Ke3", &illegal), CQDL_ILLEGAL_MOVE);
+	EXPECT_EQ(cqdl_make_move(engine, 0), CQDL_ILLEGAL_MOVE);
+
+	// Promotion bits that do not name a piece
+	char buffer[6];
+	EXPECT_EQ(cqdl_make_move(engine, static_cast<uint16_t>(move(engine, "Nc3") | 5 << 12)), CQDL_INVALID_ARGUMENT);
+	EXPECT_EQ(cqdl_move_to_string(7 << 12, buffer, sizeof(buffer)), CQDL_INVALID_ARGUMENT);
+	EXPECT_EQ(name(4 << 12 | 63 << 6 | 55), "h7h8q");
+	EXPECT_EQ(cqdl_take_move(engine), CQDL_OK);
+	EXPECT_EQ(cqdl_take_move(engine), CQDL_OK);
+	EXPECT_EQ(cqdl_take_move(engine), CQDL_ILLEGAL_MOVE);
+
+	// The bitboards of a position set from a FEN set the same position back
+	ASSERT_EQ(cqdl_set_fen(engine, "4k3/8/8/8/8/8/4P3/4K2R b - -"), CQDL_OK);
+	ASSERT_EQ(cqdl_get_position(engine, &position), CQDL_OK);
+	EXPECT_EQ(position.side_to_move, CQDL_BLACK);
+	EXPECT_EQ(position.pieces[5], (1ULL << 4) | (1ULL << 60));
+	ASSERT_EQ(cqdl_set_position(engine, &position), CQDL_OK);
+	EXPECT_EQ(cqdl_legal_moves(engine, moves.data(), moves.size(), &count), CQDL_OK);
+	EXPECT_EQ(count, 5);
+
+	// Inconsistent positions
+	cqdl_position invalid = position;
+	invalid.pieces[0] |= 1ULL << 4;
+	EXPECT_EQ(cqdl_set_position(engine, &invalid), CQDL_INVALID_POSITION);
+	invalid = position;
+	invalid.colors[CQDL_BLACK] |= 1ULL << 7;
+	EXPECT_EQ(cqdl_set_position(engine, &invalid), CQDL_INVALID_POSITION);
+	invalid = position;
+	invalid.side_to_move = CQDL_WHITE;
+	invalid.pieces[3] = (1ULL << 7) | (1ULL << 63);
+	invalid.colors[CQDL_WHITE] = (invalid.colors[CQDL_WHITE] & ~(1ULL << 7)) | (1ULL << 63) | (1ULL << 7);
+	EXPECT_EQ(cqdl_set_position(engine, &invalid), CQDL_INVALID_POSITION);
+	EXPECT_EQ(cqdl_set_fen(engine, "8/8/8/8/8/8/8/4K3 w - -"), CQDL_INVALID_POSITION);
+	EXPECT_EQ(cqdl_set_fen(engine, "not a fen"), CQDL_INVALID_POSITION);
+	EXPECT_EQ(cqdl_set_fen(engine, nullptr), CQDL_INVALID_ARGUMENT);
+
+	// A failed call leaves the position as it was
+	EXPECT_EQ(cqdl_legal_moves(engine, moves.data(), moves.size(), &count), CQDL_OK);
+	EXPECT_EQ(count, 5);
+
+	cqdl_destroy(engine);
+	cqdl_destroy(nullptr);
+}
+
+TEST(CApi, Perft_Test) {
+	cqdl_engine *engine = cqdl_create();
+	ASSERT_NE(engine, nullptr);
+
+	uint64_t nodes = 0;
+	EXPECT_EQ(cqdl_perft(engine, 3, 1, &nodes), CQDL_OK);
+	EXPECT_EQ(nodes, 8902);
+	EXPECT_EQ(cqdl_perft(engine, 4, 2, &nodes), CQDL_OK);
+	EXPECT_EQ(nodes, 197281);
+	EXPECT_EQ(cqdl_perft(engine, 0, 1, &nodes), CQDL_INVALID_ARGUMENT);
+
+	cqdl_destroy(engine);
+}
+
+TEST(CApi, Search_Test) {
+	cqdl_engine *engine = cqdl_create();
+	ASSERT_NE(engine, nullptr);
+	ASSERT_EQ(cqdl_set_fen(engine, "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1"), CQDL_OK);
+
+	struct Progress {
+		int iterations = 0;
+		int lines = 0;
+		std::vector<uint16_t> pv;
+	} progress;
+
+	const auto callback = [](const cqdl_info *info, void *userData) {
+		auto *seen = static_cast<Progress *>(userData);
+		seen->iterations += info->line == 1;
+		seen->lines = std::max(seen->lines, static_cast<int>(info->line));
+		if (info->line == 1)
+			seen->pv.assign(info->pv, info->pv + info->pv_length);
+	};
+
+	cqdl_limits limits{};
+	limits.depth = 3;
+	limits.multipv = 2;
+	uint16_t best = 0;
+
+	ASSERT_EQ(cqdl_search(engine, &limits, callback, &progress, &best), CQDL_OK);
+	EXPECT_EQ(name(best), "d1d8");
+	EXPECT_EQ(progress.iterations, 3);
+	EXPECT_EQ(progress.lines, 2);
+	ASSERT_FALSE(progress.pv.empty());
+	EXPECT_EQ(progress.pv.front(), best);
+
+	// No limit, and no move in a mated position
+	EXPECT_EQ(cqdl_search(engine, &limits, nullptr, nullptr, nullptr), CQDL_INVALID_ARGUMENT);
+	limits = cqdl_limits{};
+	EXPECT_EQ(cqdl_search(engine, &limits, nullptr, nullptr, &best), CQDL_INVALID_ARGUMENT);
+
+	ASSERT_EQ(cqdl_set_fen(engine, "3R2k1/5ppp/8/8/8/8/5PPP/6K1 b - - 1 1"), CQDL_OK);
+	limits.depth = 2;
+	ASSERT_EQ(cqdl_search(engine, &limits, nullptr, nullptr, &best), CQDL_OK);
+	EXPECT_EQ(best, 0);
+
+	// A search stopped from another thread
+	ASSERT_EQ(cqdl_set_fen(engine, "startpos"), CQDL_INVALID_POSITION);
+	ASSERT_EQ(cqdl_set_fen(engine, "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - -"), CQDL_OK);
+	limits = cqdl_limits{};
+	limits.move_time = 60000;
+
+	std::thread stopper([engine] {
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		cqdl_stop(engine);
+	});
+
+	const auto start = std::chrono::steady_clock::now();
+	ASSERT_EQ(cqdl_search(engine, &limits, nullptr, nullptr, &best), CQDL_OK);
+	stopper.join();
+
+	EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(30));
+	EXPECT_NE(best, 0);
+
+	cqdl_destroy(engine);
+}
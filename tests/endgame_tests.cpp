@@ -0,0 +1,139 @@
+#include "gtest/gtest.h"
+
+#include "Engine/batch.hpp"
+#include "Engine/bitboard.hpp"
+#include "Engine/endgame.hpp"
+#include "Engine/evaluation.hpp"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+	int evaluateFen(const std::string &fen, const chessqdl::enumColor color) {
+		chessqdl::Bitboard board(fen);
+		return chessqdl::evaluateBoard(board.getBitBoards(), color);
+	}
+
+	uint64_t materialKey(const std::string &fen) {
+		chessqdl::Bitboard board(fen);
+		return chessqdl::computeMaterialKey(board.getBitBoards());
+	}
+
+}
+
+TEST(Endgame, MaterialKey_Test) {
+	EXPECT_EQ(materialKey("8/8/4k3/8/8/3NKB2/8/8 w - - 0 1"), chessqdl::materialKeyFromCode("KBNK"));
+	EXPECT_EQ(materialKey("8/8/3nkb2/8/8/4K3/8/8 w - - 0 1"), chessqdl::materialKeyFromCode("KKBN"));
+	EXPECT_EQ(materialKey("8/8/4k3/3p4/8/4K3/8/R7 w - - 0 1"), chessqdl::materialKeyFromCode("KRKP"));
+	EXPECT_NE(materialKey("8/8/4k3/3p4/8/4K3/8/R7 w - - 0 1"), chessqdl::materialKeyFromCode("KPKR"));
+
+	chessqdl::Bitboard board;
+	EXPECT_EQ(chessqdl::computeEvalState(board.getBitBoards()).materialKey,
+	          chessqdl::materialKeyFromCode("KQRRBBNNPPPPPPPPKQRRBBNNPPPPPPPP"));
+}
+
+TEST(Endgame, InsufficientMaterial_Test) {
+	const std::vector<std::string> draws = {"8/8/4k3/8/8/4K3/8/8 w - - 0 1",
+	                                        "8/8/4k3/8/8/3NK3/8/8 w - - 0 1",
+	                                        "8/8/4k3/8/8/4KB2/8/8 b - - 0 1",
+	                                        "8/8/4k3/8/8/2N1K1N1/8/8 w - - 0 1",
+	                                        "8/8/4kb2/8/8/4KB2/8/8 w - - 0 1",
+	                                        "8/8/3nk3/8/8/4KB2/8/8 w - - 0 1"};
+
+	for (const std::string &fen: draws) {
+		EXPECT_EQ(evaluateFen(fen, chessqdl::nWhite), 0) << fen;
+		EXPECT_EQ(evaluateFen(fen, chessqdl::nBlack), 0) << fen;
+	}
+}
+
+TEST(Endgame, MissingKing_Test) {
+	// Boards where the search has just taken a king are not specialized endgames, so they are not scored as draws
+	for (const std::string fen: {"8/8/8/8/8/4K3/8/8 w - - 0 1", "8/8/8/4P3/8/4K3/8/8 w - - 0 1",
+	                             "8/8/4k3/8/8/3N4/8/8 w - - 0 1"}) {
+		chessqdl::Bitboard board(fen);
+		int score = 0;
+		EXPECT_FALSE(chessqdl::evaluateEndgame(board.getBitBoards(), materialKey(fen), chessqdl::nWhite, score)) << fen;
+	}
+
+	EXPECT_GT(evaluateFen("8/8/8/4P3/8/4K3/8/8 w - - 0 1", chessqdl::nWhite), chessqdl::pieceValues[chessqdl::nQueen]);
+	EXPECT_LT(evaluateFen("8/8/4k3/8/8/3N4/8/8 w - - 0 1", chessqdl::nWhite), -chessqdl::pieceValues[chessqdl::nQueen]);
+}
+
+TEST(Endgame, LoneKing_Test) {
+	// The weak king is better off in the center than in a corner
+	const int center = evaluateFen("8/8/8/3k4/8/8/8/Q3K3 w - - 0 1", chessqdl::nWhite);
+	const int corner = evaluateFen("k7/8/8/8/8/8/8/Q3K3 w - - 0 1", chessqdl::nWhite);
+
+	EXPECT_GT(center, chessqdl::knownWinBonus);
+	EXPECT_GT(corner, center);
+	EXPECT_EQ(evaluateFen("8/8/8/3k4/8/8/8/Q3K3 w - - 0 1", chessqdl::nBlack), -center);
+
+	// Same for black
+	EXPECT_GT(evaluateFen("q3k3/8/8/8/8/8/8/7K w - - 0 1", chessqdl::nBlack), chessqdl::knownWinBonus);
+}
+
+TEST(Endgame, BishopAndKnight_Test) {
+	// Dark-squared bishop on c1: the mate happens in a1 or h8, not in h1 or a8
+	const int rightCorner = evaluateFen("8/8/8/8/8/8/2K5/k1B1N3 w - - 0 1", chessqdl::nWhite);
+	const int wrongCorner = evaluateFen("8/8/8/8/8/8/5K2/2B1N2k w - - 0 1", chessqdl::nWhite);
+
+	EXPECT_GT(rightCorner, chessqdl::knownWinBonus);
+	EXPECT_GT(rightCorner, wrongCorner);
+}
+
+TEST(Endgame, KingAndPawn_Test) {
+	// The black king is outside the square of the pawn
+	EXPECT_GT(evaluateFen("8/8/8/4P3/8/8/8/k3K3 w - - 0 1", chessqdl::nWhite), chessqdl::knownWinBonus);
+
+	// The white king stands on a key square of the pawn
+	EXPECT_GT(evaluateFen("4k3/8/3K4/8/3P4/8/8/8 w - - 0 1", chessqdl::nWhite), chessqdl::knownWinBonus);
+
+	// The black king reaches the queening corner of a rook pawn
+	EXPECT_EQ(evaluateFen("k7/8/8/P7/8/8/8/1K6 w - - 0 1", chessqdl::nWhite), 0);
+
+	// Same for black, with the board flipped
+	EXPECT_GT(evaluateFen("k3K3/8/8/8/4p3/8/8/8 w - - 0 1", chessqdl::nBlack), chessqdl::knownWinBonus);
+}
+
+TEST(Endgame, RookAgainstPawn_Test) {
+	// The white king blocks the pawn
+	const int blocked = evaluateFen("7k/8/8/8/3p4/8/3K4/7R w - - 0 1", chessqdl::nWhite);
+	// The pawn is about to promote with the support of its king
+	const int advanced = evaluateFen("R7/8/8/8/8/8/2kp4/7K w - - 0 1", chessqdl::nWhite);
+
+	EXPECT_GT(blocked, chessqdl::pieceValues[chessqdl::nRook] - 10);
+	EXPECT_LT(advanced, blocked);
+}
+
+TEST(Endgame, OppositeColoredBishops_Test) {
+	// c1 is a dark square and c8 a light one
+	chessqdl::Bitboard opposite("2b3k1/5ppp/8/8/8/8/P4PPP/2B3K1 w - - 0 1");
+	chessqdl::Bitboard same("3b2k1/5ppp/8/8/8/8/P4PPP/2B3K1 w - - 0 1");
+
+	const uint64_t key = chessqdl::computeMaterialKey(opposite.getBitBoards());
+
+	EXPECT_EQ(chessqdl::endgameScaleFactor(opposite.getBitBoards(), key, chessqdl::nWhite), 16);
+	EXPECT_EQ(chessqdl::endgameScaleFactor(same.getBitBoards(), key, chessqdl::nWhite), chessqdl::normalScaleFactor);
+}
+
+TEST(Endgame, Batch_Test) {
+	const std::vector<std::string> fens = {"8/8/4k3/8/8/3NK3/8/8 w - - 0 1",
+	                                       "k7/8/8/8/8/8/8/Q3K3 w - - 0 1",
+	                                       "8/8/8/8/8/8/2K5/k1B1N3 w - - 0 1",
+	                                       "8/8/8/4P3/8/8/8/k3K3 w - - 0 1",
+	                                       "7k/8/8/8/3p4/8/3K4/7R w - - 0 1",
+	                                       "2b3k1/5ppp/8/8/8/8/P4PPP/2B3K1 w - - 0 1",
+	                                       "8/8/4k3/8/8/4KR2/8/5b2 w - - 0 1"};
+
+	chessqdl::PositionBatch batch;
+	for (const std::string &fen: fens)
+		batch.add(chessqdl::Bitboard(fen).getBitBoards());
+
+	for (const chessqdl::enumColor color: {chessqdl::nWhite, chessqdl::nBlack}) {
+		const std::vector<int> scores = chessqdl::evaluateBatch(batch, color);
+
+		for (size_t i = 0; i < fens.size(); i++)
+			EXPECT_EQ(scores[i], evaluateFen(fens[i], color)) << fens[i];
+	}
+}
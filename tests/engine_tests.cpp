@@ -0,0 +1,164 @@
+#include "gtest/gtest.h"
+
+#include "Engine/endgame.hpp"
+#include "Engine/engine.hpp"
+#include "Engine/movegen.hpp"
+#include "Engine/san.hpp"
+
+#include <iostream>
+#include <set>
+#include <sstream>
+
+namespace {
+
+	/**
+	 * @brief Plays a game against an engine through its interactive parser, the engine playing black and pondering
+	 * @return Everything the parser printed
+	 */
+	std::string playInteractive(const std::string &commands) {
+		chessqdl::Engine engine(chessqdl::nBlack, 2, true, false, 7);
+		engine.setPonder(true);
+
+		std::istringstream input(commands);
+		std::ostringstream output;
+		std::streambuf *const cinBuffer = std::cin.rdbuf(input.rdbuf());
+		std::streambuf *const coutBuffer = std::cout.rdbuf(output.rdbuf());
+
+		engine.parser();
+
+		std::cin.rdbuf(cinBuffer);
+		std::cout.rdbuf(coutBuffer);
+		return output.str();
+	}
+
+	size_t countOccurrences(const std::string &text, const std::string &pattern) {
+		size_t count = 0;
+		for (size_t i = text.find(pattern); i != std::string::npos; i = text.find(pattern, i + 1))
+			count++;
+		return count;
+	}
+
+}
+
+TEST(Engine, MultiPV_Test) {
+	chessqdl::Engine engine("4k3/8/8/8/8/2r5/3q4/4K3 w - - 0 1", chessqdl::nWhite, 3, false, false, 0);
+
+	const auto lines = engine.getBestMoves(2, chessqdl::nWhite, 3);
+
+	// Only two king moves get out of check
+	ASSERT_EQ(lines.size(), 2);
+	EXPECT_EQ(lines[0].move, "e1d2");
+
+	std::set<std::string> moves;
+	for (size_t i = 0; i < lines.size(); i++) {
+		moves.insert(lines[i].move);
+		ASSERT_FALSE(lines[i].pv.empty());
+		EXPECT_EQ(lines[i].pv.front(), lines[i].move);
+		if (i > 0) {
+			EXPECT_GE(lines[i - 1].score, lines[i].score);
+		}
+	}
+
+	// Every line starts with a different move
+	EXPECT_EQ(moves.size(), lines.size());
+}
+
+TEST(Engine, MultiPVSingleLine_Test) {
+	chessqdl::Engine engine("4k3/8/8/8/8/2r5/3q4/4K3 w - - 0 1", chessqdl::nWhite, 3, false, false, 0);
+
+	EXPECT_EQ(engine.getBestMoves(2, chessqdl::nWhite, 1).front().move, engine.getBestMove(2, chessqdl::nWhite));
+}
+
+TEST(Engine, MultiPVMoreLinesThanMoves_Test) {
+	chessqdl::Engine engine("k7/8/8/8/8/8/8/K7 w - - 0 1", chessqdl::nWhite, 3, false, false, 0);
+
+	EXPECT_EQ(engine.getBestMoves(1, chessqdl::nWhite, 10).size(), 3);
+}
+
+TEST(Engine, MoveHistory_Test) {
+	chessqdl::Engine engine("r3k3/1P6/8/8/8/8/8/4K2R w - - 0 1", chessqdl::nWhite, 3, false, false, 0);
+	const uint64_t hash = engine.getHash();
+
+	// A capture with promotion, a king move and a rook check
+	engine.makeMove("b7a8q", false, false);
+	engine.makeMove("e8d7", false, false);
+	engine.makeMove("h1h7", false, false);
+
+	ASSERT_EQ(engine.getMoveHistory().size(), 3);
+	EXPECT_EQ(chessqdl::unpackMove(engine.getMoveHistory()[0]), "b7a8q");
+	EXPECT_EQ(engine.getSanHistory(), (std::vector<std::string>{"bxa8=Q+", "Kd7", "Rh7+"}));
+
+	// Taking the moves back restores the pawn and the captured rook
+	for (int i = 0; i < 3; i++)
+		engine.takeMove();
+
+	EXPECT_TRUE(engine.getMoveHistory().empty());
+	EXPECT_EQ(engine.getHash(), hash);
+	EXPECT_TRUE(engine.getBitboard().getBitBoards()[chessqdl::nPawn].test(49));
+	EXPECT_TRUE(engine.getBitboard().getBitBoards()[chessqdl::nRook].test(56));
+	EXPECT_FALSE(engine.getBitboard().getBitBoards()[chessqdl::nQueen].test(56));
+	EXPECT_EQ(engine.getToMove(), chessqdl::nWhite);
+}
+
+TEST(Engine, LegalRootMoves_Test) {
+	// Fool's mate: every pseudo-legal move of white loses the king
+	const std::string mated = "rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3";
+	chessqdl::Engine engine(mated, chessqdl::nWhite, 3, false, false, 0);
+
+	EXPECT_EQ(engine.getBestMove(3, chessqdl::nWhite), "");
+	EXPECT_TRUE(engine.getBestMoves(3, chessqdl::nWhite, 2).empty());
+	EXPECT_EQ(engine.search({}, nullptr), "");
+
+	// In check, with a single legal move
+	chessqdl::Engine check("k7/8/8/8/8/8/1r6/K6r w - - 0 1", chessqdl::nWhite, 3, false, false, 0);
+	EXPECT_EQ(check.getBestMove(3, chessqdl::nWhite), "a1b2");
+}
+
+TEST(Engine, BitbaseLegalMoves_Test) {
+	// Moving the black king to d7, e7 or f7 walks into check, and the positions after these moves are invalid in the
+	// bitbase rather than drawn
+	const std::set<std::string> legal = {"e8d8", "e8f8"};
+
+	for (int depth = 1; depth <= 4; depth++) {
+		chessqdl::Engine black("4k3/8/4K3/4P3/8/8/8/8 b - - 0 1", chessqdl::nBlack, depth, false, false, 0);
+		EXPECT_EQ(legal.count(black.getBestMove(depth, chessqdl::nBlack)), 1) << "depth " << depth;
+
+		// Replies that leave the king in check do not save black from the won bitbase positions
+		chessqdl::Engine white("4k3/8/4K3/4P3/8/8/8/8 w - - 0 1", chessqdl::nWhite, depth, false, false, 0);
+		EXPECT_GE(white.getBestMoves(depth, chessqdl::nWhite, 1).front().score, chessqdl::knownWinBonus)
+			<< "depth " << depth;
+	}
+}
+
+TEST(Engine, PonderHitAndMiss_Test) {
+	// The reply the engine expects is the second move of its principal variation
+	const std::string first = playInteractive("e2e4\nquit\n");
+	std::istringstream pv(first.substr(first.find("Principal variation:") + 20));
+	std::string engineMove, expected;
+	pv >> engineMove >> expected;
+	ASSERT_FALSE(expected.empty()) << first;
+
+	chessqdl::Engine game(chessqdl::nBlack, 2, false, false, 0);
+	game.makeMove("e2e4", false, false);
+	game.makeMove(engineMove, false, false);
+	const std::string san = chessqdl::moveToSan(game.getBitboard().getBitBoards(), chessqdl::nWhite, expected);
+
+	// Commands in between do not count as a reply, and the reply may be written in standard algebraic notation
+	const std::string hit = playInteractive("e2e4\nhelp\nprint\nhistory\n" + san + "\nquit\n");
+	EXPECT_EQ(countOccurrences(hit, "Ponder hit"), 1) << hit;
+	EXPECT_EQ(countOccurrences(hit, "Best move found"), 1);
+
+	// Any other reply is a miss, after which the engine searches again
+	std::string other;
+	for (const std::string &mv: chessqdl::MoveGenerator::getLegalMoves(game.getBitboard().getBitBoards(),
+	                                                                   chessqdl::nWhite)) {
+		if (mv != expected) {
+			other = mv;
+			break;
+		}
+	}
+
+	const std::string miss = playInteractive("e2e4\nmove " + other + "\nquit\n");
+	EXPECT_EQ(countOccurrences(miss, "Ponder hit"), 0) << miss;
+	EXPECT_EQ(countOccurrences(miss, "Best move found"), 2);
+}
@@ -0,0 +1,45 @@
+#include "gtest/gtest.h"
+
+#include "Engine/evalcache.hpp"
+
+TEST(EvalCache, StoreAndProbe_Test) {
+	chessqdl::EvalCache cache(1);
+	int score = 0;
+
+	EXPECT_FALSE(cache.probe(0x123456789abcdef0ULL, score));
+
+	cache.store(0x123456789abcdef0ULL, -250);
+	ASSERT_TRUE(cache.probe(0x123456789abcdef0ULL, score));
+	EXPECT_EQ(score, -250);
+
+	cache.store(0x0fedcba987654321ULL, 20000);
+	ASSERT_TRUE(cache.probe(0x0fedcba987654321ULL, score));
+	EXPECT_EQ(score, 20000);
+
+	EXPECT_EQ(cache.getProbes(), 3);
+	EXPECT_EQ(cache.getHits(), 2);
+
+	cache.resetStats();
+	EXPECT_EQ(cache.getProbes(), 0);
+	EXPECT_EQ(cache.getHits(), 0);
+}
+
+TEST(EvalCache, Collision_Test) {
+	chessqdl::EvalCache cache(1);
+	int score = 0;
+
+	// Both keys map to the same entry, but their upper halves differ
+	const uint64_t first = 0x1111111100000042ULL;
+	const uint64_t second = 0x2222222200000042ULL;
+
+	cache.store(first, 10);
+	EXPECT_FALSE(cache.probe(second, score));
+
+	cache.store(second, 20);
+	EXPECT_FALSE(cache.probe(first, score));
+	ASSERT_TRUE(cache.probe(second, score));
+	EXPECT_EQ(score, 20);
+
+	cache.clear();
+	EXPECT_FALSE(cache.probe(second, score));
+}
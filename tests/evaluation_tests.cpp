@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+
+#include "Engine/engine.hpp"
+#include "Engine/evaluation.hpp"
+#include "Engine/movegen.hpp"
+
+#include <random>
+
+namespace {
+
+	/**
+	 * @brief Plays random pseudo-legal moves and checks that the incremental evaluation state never drifts from a full
+	 * recompute, then takes every move back
+	 */
+	void checkRandomPlayout(const std::string &fen, const unsigned seed) {
+		chessqdl::Engine engine(fen, chessqdl::nWhite, 1, false, false, 0);
+		const chessqdl::EvalState initialState = engine.getEvalState();
+		std::mt19937 rng(seed);
+		int played = 0;
+
+		for (int ply = 0; ply < 60; ply++) {
+			const auto board = engine.getBitboard().getBitBoards();
+			const auto moves = chessqdl::MoveGenerator::getPseudoLegalMoves(board, engine.getToMove());
+
+			// Stop once a king has been captured
+			if (moves.empty() || board[chessqdl::nKing].count() < 2)
+				break;
+
+			engine.makeMove(moves[rng() % moves.size()], false, false);
+			played++;
+
+			const auto after = engine.getBitboard().getBitBoards();
+			ASSERT_EQ(engine.getEvalState(), chessqdl::computeEvalState(after));
+			EXPECT_EQ(chessqdl::evaluateBoard(after, engine.getEvalState(), chessqdl::nWhite),
+					  chessqdl::evaluateBoard(after, chessqdl::nWhite));
+		}
+
+		for (int i = 0; i < played; i++)
+			engine.takeMove();
+
+		EXPECT_EQ(engine.getEvalState(), initialState);
+	}
+
+}
+
+TEST(Evaluation, InitialPosition_Test) {
+	chessqdl::Bitboard board;
+
+	EXPECT_EQ(chessqdl::evaluateBoard(board.getBitBoards(), chessqdl::nWhite), 0);
+	EXPECT_EQ(chessqdl::evaluateBoard(board.getBitBoards(), chessqdl::nBlack), 0);
+}
+
+TEST(Evaluation, Symmetry_Test) {
+	chessqdl::Bitboard board("r1bqk1nr/pppp1ppp/2n5/2b1p3/1PB1P3/5N2/P1PP1PPP/RNBQK2R b KQkq b3 1 4");
+
+	EXPECT_EQ(chessqdl::evaluateBoard(board.getBitBoards(), chessqdl::nWhite),
+			  -chessqdl::evaluateBoard(board.getBitBoards(), chessqdl::nBlack));
+}
+
+TEST(Evaluation, IncrementalState_Test) {
+	checkRandomPlayout("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 1);
+	checkRandomPlayout("r1bqk1nr/pppp1ppp/2n5/2b1p3/1PB1P3/5N2/P1PP1PPP/RNBQK2R b KQkq b3 1 4", 2);
+	// Promotions, with and without captures
+	checkRandomPlayout("1r2k3/P1P5/8/8/8/8/1p4p1/R3K3 w - - 0 1", 3);
+}
+
+TEST(Evaluation, Mobility_Test) {
+	// Knight on a1 attacks b3 and c2
+	chessqdl::Bitboard knight("4k3/8/8/8/8/8/8/N3K3 w - - 0 1");
+	EXPECT_EQ(chessqdl::evaluateMobility(knight.getBitBoards(), chessqdl::nWhite), 2 * chessqdl::mobilityWeights[chessqdl::nKnight]);
+
+	// b3 is attacked by a black pawn and c2 is occupied by a white pawn
+	chessqdl::Bitboard unsafe("4k3/8/8/8/p7/8/2P5/N3K3 w - - 0 1");
+	EXPECT_EQ(chessqdl::evaluateMobility(unsafe.getBitBoards(), chessqdl::nWhite), 0);
+
+	// Rook on a1 is blocked by the pawn on a3, but can capture the knight on c1
+	chessqdl::Bitboard rook("4k3/8/8/8/8/P7/8/R1n1K3 w - - 0 1");
+	EXPECT_EQ(chessqdl::evaluateMobility(rook.getBitBoards(), chessqdl::nWhite), 3 * chessqdl::mobilityWeights[chessqdl::nRook]);
+}
@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+
+#include "Engine/engine.hpp"
+#include "Engine/instrument.hpp"
+
+#include <sstream>
+
+TEST(Instrument, PrintInstrumentation_Test) {
+	chessqdl::Instrumentation data;
+	data.counts[chessqdl::nNodeCounter] = 300;
+	data.counts[chessqdl::nQNodeCounter] = 100;
+	data.counts[chessqdl::nTTProbeCounter] = 200;
+	data.counts[chessqdl::nTTHitCounter] = 50;
+	data.counts[chessqdl::nCutoffCounter] = 40;
+	data.counts[chessqdl::nFirstMoveCutoffCounter] = 36;
+	data.calls[chessqdl::nEvalTimer] = 100;
+	data.nanoseconds[chessqdl::nEvalTimer] = 5000000;
+
+	std::ostringstream output;
+	chessqdl::printInstrumentation(output, data, 20000000);
+	const std::string table = output.str();
+
+	EXPECT_NE(table.find("tt hits"), std::string::npos);
+	EXPECT_NE(table.find("0.125     25.0%"), std::string::npos);
+	EXPECT_NE(table.find("0.090     90.0%"), std::string::npos);
+	EXPECT_NE(table.find("5.0     50000     25.0%"), std::string::npos);
+}
+
+TEST(Instrument, Search_Test) {
+	chessqdl::Engine engine("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w - - 4 4", chessqdl::nWhite, 3,
+							false, true, 0);
+	chessqdl::SearchLimits limits;
+	limits.depth = 3;
+	engine.search(limits);
+
+	const chessqdl::Instrumentation &data = chessqdl::threadInstrumentation();
+
+#ifdef CHESSQDL_INSTRUMENT
+	EXPECT_GT(data.counts[chessqdl::nNodeCounter], 0);
+	EXPECT_GT(data.counts[chessqdl::nQNodeCounter], 0);
+	EXPECT_GT(data.counts[chessqdl::nTTHitCounter], 0);
+	EXPECT_LE(data.counts[chessqdl::nTTHitCounter], data.counts[chessqdl::nTTProbeCounter]);
+	EXPECT_GT(data.counts[chessqdl::nFirstMoveCutoffCounter], 0);
+	EXPECT_LE(data.counts[chessqdl::nFirstMoveCutoffCounter], data.counts[chessqdl::nCutoffCounter]);
+	EXPECT_EQ(data.counts[chessqdl::nEvalCounter], data.calls[chessqdl::nEvalTimer]);
+	EXPECT_GT(data.calls[chessqdl::nMoveGenTimer], 0);
+	EXPECT_EQ(data.calls[chessqdl::nMakeMoveTimer], data.calls[chessqdl::nTakeMoveTimer]);
+#else
+	// Without instrumentation, nothing is counted
+	for (const uint64_t count: data.counts)
+		EXPECT_EQ(count, 0);
+	for (const uint64_t calls: data.calls)
+		EXPECT_EQ(calls, 0);
+#endif
+}
@@ -0,0 +1,120 @@
+#include "gtest/gtest.h"
+
+#include "Engine/match.hpp"
+
+#include <cmath>
+#include <sstream>
+
+TEST(Match, Stats_Test) {
+	chessqdl::MatchStats stats;
+	EXPECT_EQ(stats.games(), 0);
+	EXPECT_DOUBLE_EQ(stats.score(), 0.5);
+	EXPECT_DOUBLE_EQ(stats.llr(0, 5), 0);
+
+	stats.wins = 6;
+	stats.losses = 2;
+	stats.draws = 2;
+	EXPECT_EQ(stats.games(), 10);
+	EXPECT_DOUBLE_EQ(stats.score(), 0.7);
+	EXPECT_NEAR(stats.elo(), 147.2, 0.1);
+	EXPECT_GT(stats.eloMargin(), 0);
+	EXPECT_GT(stats.llr(0, 5), 0);
+	EXPECT_LT(stats.llr(200, 205), 0);
+
+	stats.losses = 0;
+	stats.draws = 0;
+	EXPECT_TRUE(std::isinf(stats.elo()));
+
+	EXPECT_EQ(chessqdl::sprtVerdict(0, 0.05, 0.05), chessqdl::nContinue);
+	EXPECT_EQ(chessqdl::sprtVerdict(3, 0.05, 0.05), chessqdl::nAcceptH1);
+	EXPECT_EQ(chessqdl::sprtVerdict(-3, 0.05, 0.05), chessqdl::nAcceptH0);
+}
+
+TEST(Match, PlayGame_Test) {
+	chessqdl::Engine white(chessqdl::nWhite, 1, false, false, 0);
+	chessqdl::Engine black(chessqdl::nWhite, 1, false, false, 0);
+	chessqdl::PlayerConfig config;
+	config.depth = 2;
+	chessqdl::Adjudication adjudication;
+
+	auto game = chessqdl::playGame(white, config, black, config, "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1", adjudication);
+	EXPECT_EQ(game.moves, std::vector<std::string>{"Rd8#"});
+	EXPECT_EQ(game.result, chessqdl::nWhiteWins);
+	EXPECT_EQ(game.termination, "checkmate");
+
+	game = chessqdl::playGame(white, config, black, config, "7k/5Q2/6K1/8/8/8/8/8 b - - 0 1", adjudication);
+	EXPECT_TRUE(game.moves.empty());
+	EXPECT_EQ(game.result, chessqdl::nDrawn);
+	EXPECT_EQ(game.termination, "stalemate");
+
+	game = chessqdl::playGame(white, config, black, config, "8/8/4k3/8/8/3NK3/8/8 w - - 0 1", adjudication);
+	EXPECT_EQ(game.termination, "insufficient material");
+
+	config.depth = 1;
+	adjudication.maxPlies = 6;
+	game = chessqdl::playGame(white, config, black, config,
+							  "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - - 0 1", adjudication);
+	EXPECT_EQ(game.moves.size(), 6);
+	EXPECT_EQ(game.result, chessqdl::nDrawn);
+	EXPECT_EQ(game.termination, "maximum length");
+}
+
+TEST(Match, WritePgn_Test) {
+	chessqdl::GameRecord game;
+	game.fen = "6k1/5ppp/8/8/8/8/5PPP/3R2K1 b - - 0 12";
+	game.moves = {"h6", "Rd8+", "Kh7"};
+	game.result = chessqdl::nDrawn;
+	game.termination = "adjudication";
+
+	std::ostringstream output;
+	chessqdl::writePgn(output, game, "A", "B", 3);
+
+	const std::string pgn = output.str();
+	EXPECT_NE(pgn.find("[Round \"3\"]\n[White \"A\"]\n[Black \"B\"]\n[Result \"1/2-1/2\"]\n"), std::string::npos);
+	EXPECT_NE(pgn.find("[FEN \"6k1/5ppp/8/8/8/8/5PPP/3R2K1 b - - 0 12\"]\n[SetUp \"1\"]\n"), std::string::npos);
+	EXPECT_NE(pgn.find("\n\n12... h6 13. Rd8+ Kh7 1/2-1/2\n\n"), std::string::npos);
+
+	// Games from the initial position have no FEN tag, and long games are wrapped
+	game.fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - - 0 1";
+	game.moves = std::vector<std::string>(60, "Nf3");
+	game.result = chessqdl::nWhiteWins;
+	output.str("");
+	chessqdl::writePgn(output, game, "A", "B", 1);
+
+	EXPECT_EQ(output.str().find("[FEN"), std::string::npos);
+	std::istringstream lines(output.str());
+	std::string line;
+	while (std::getline(lines, line))
+		EXPECT_LT(line.size(), 80);
+}
+
+TEST(Match, PlayMatch_Test) {
+	chessqdl::PlayerConfig first;
+	first.depth = 2;
+	chessqdl::PlayerConfig second = first;
+	second.name = "Other";
+
+	chessqdl::MatchOptions options;
+	options.games = 4;
+	options.threads = 2;
+	options.adjudication.maxPlies = 8;
+	options.openings = {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - - 0 1",
+						"6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1"};
+
+	std::ostringstream pgn;
+	int calls = 0;
+	const auto stats = chessqdl::playMatch(first, second, options, &pgn,
+										   [&calls](const chessqdl::MatchStats &) { calls++; });
+
+	EXPECT_EQ(stats.games(), 4);
+	EXPECT_EQ(calls, 4);
+
+	// Both players mate with white from the second opening
+	EXPECT_EQ(stats.wins, 1);
+	EXPECT_EQ(stats.losses, 1);
+
+	size_t games = 0;
+	for (size_t pos = pgn.str().find("[Event"); pos != std::string::npos; pos = pgn.str().find("[Event", pos + 1))
+		games++;
+	EXPECT_EQ(games, 4);
+}
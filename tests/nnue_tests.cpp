@@ -0,0 +1,141 @@
+#include "gtest/gtest.h"
+
+#include "Engine/engine.hpp"
+#include "Engine/movegen.hpp"
+#include "Engine/nnue.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+namespace {
+
+	/**
+	 * @brief Small random network shared by every test, since filling the feature transformer takes a while
+	 */
+	std::shared_ptr<const chessqdl::NnueNetwork> getNetwork() {
+		static const auto network = [] {
+			auto net = std::make_shared<chessqdl::NnueNetwork>();
+			net->randomize(1);
+			return net;
+		}();
+
+		return network;
+	}
+
+	/**
+	 * @brief Plays random pseudo-legal moves and checks that the incremental accumulator always matches a refresh, and
+	 * that the SIMD kernels agree with the portable ones
+	 */
+	void checkRandomPlayout(const std::string &fen, const unsigned seed) {
+		const auto network = getNetwork();
+		chessqdl::Engine engine(fen, chessqdl::nWhite, 1, false, false, 0);
+		engine.setNetwork(network);
+
+		const chessqdl::NnueAccumulator initial = engine.getAccumulator();
+		std::mt19937 rng(seed);
+		int played = 0;
+
+		for (int ply = 0; ply < 80; ply++) {
+			const auto board = engine.getBitboard().getBitBoards();
+			const auto moves = chessqdl::MoveGenerator::getPseudoLegalMoves(board, engine.getToMove());
+
+			if (moves.empty() || board[chessqdl::nKing].count() < 2)
+				break;
+
+			engine.makeMove(moves[rng() % moves.size()], false, false);
+			played++;
+
+			const auto after = engine.getBitboard().getBitBoards();
+			ASSERT_EQ(engine.getAccumulator(), network->refresh(after));
+
+			for (int color = chessqdl::nWhite; color <= chessqdl::nBlack; color++) {
+				const auto c = static_cast<chessqdl::enumColor>(color);
+				EXPECT_EQ(network->evaluate(engine.getAccumulator(), c), network->evaluateReference(engine.getAccumulator(), c));
+			}
+		}
+
+		for (int i = 0; i < played; i++)
+			engine.takeMove();
+
+		EXPECT_EQ(engine.getAccumulator(), initial);
+	}
+
+}
+
+TEST(Nnue, FeatureIndex_Test) {
+	// A white pawn on e2 seen by white with the king on e1 is the same feature as a black pawn on e7 seen by black with
+	// the king on e8
+	EXPECT_EQ(chessqdl::nnueFeatureIndex(chessqdl::nWhite, chessqdl::e1, chessqdl::nWhite, chessqdl::nPawn, chessqdl::e2),
+			  chessqdl::nnueFeatureIndex(chessqdl::nBlack, chessqdl::e8, chessqdl::nBlack, chessqdl::nPawn, chessqdl::e7));
+
+	EXPECT_EQ(chessqdl::nnueFeatureIndex(chessqdl::nWhite, chessqdl::a1, chessqdl::nWhite, chessqdl::nPawn, chessqdl::a1), 0);
+	EXPECT_EQ(chessqdl::nnueFeatureIndex(chessqdl::nWhite, chessqdl::h8, chessqdl::nBlack, chessqdl::nQueen, chessqdl::h8),
+			  chessqdl::nnueInputs - 1);
+}
+
+TEST(Nnue, IncrementalAccumulator_Test) {
+	checkRandomPlayout("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 1);
+	checkRandomPlayout("r1bqk1nr/pppp1ppp/2n5/2b1p3/1PB1P3/5N2/P1PP1PPP/RNBQK2R b KQkq b3 1 4", 2);
+	// Promotions, with and without captures
+	checkRandomPlayout("1r2k3/P1P5/8/8/8/8/1p4p1/R3K3 w - - 0 1", 3);
+	// Kings close to each other, so that they get captured
+	checkRandomPlayout("8/8/8/3kK3/8/8/8/8 w - - 0 1", 4);
+}
+
+TEST(Nnue, SaveAndLoad_Test) {
+	const auto network = getNetwork();
+	const std::string path = testing::TempDir() + "chessqdl_nnue_roundtrip.bin";
+	ASSERT_TRUE(network->save(path));
+
+	chessqdl::NnueNetwork loaded;
+	ASSERT_TRUE(loaded.load(path));
+
+	chessqdl::Bitboard board("r1bqk1nr/pppp1ppp/2n5/2b1p3/1PB1P3/5N2/P1PP1PPP/RNBQK2R b KQkq b3 1 4");
+	const chessqdl::NnueAccumulator accumulator = network->refresh(board.getBitBoards());
+
+	EXPECT_EQ(loaded.refresh(board.getBitBoards()), accumulator);
+	EXPECT_EQ(loaded.evaluate(accumulator, chessqdl::nWhite), network->evaluate(accumulator, chessqdl::nWhite));
+
+	std::remove(path.c_str());
+}
+
+TEST(Nnue, InvalidFile_Test) {
+	chessqdl::NnueNetwork network;
+
+	EXPECT_FALSE(network.load(testing::TempDir() + "chessqdl_nnue_missing.bin"));
+
+	const std::string path = testing::TempDir() + "chessqdl_nnue_truncated.bin";
+	{
+		std::ofstream file(path, std::ios::binary);
+		file << "CQNN";
+	}
+	EXPECT_FALSE(network.load(path));
+
+	std::remove(path.c_str());
+}
+
+TEST(Nnue, EngineSearch_Test) {
+	chessqdl::Engine engine(chessqdl::nWhite, 3, false, false, 0);
+	engine.setNetwork(getNetwork());
+
+	const std::string move = engine.getBestMove(3, chessqdl::nWhite);
+	const auto moves = chessqdl::MoveGenerator::getPseudoLegalMoves(engine.getBitboard().getBitBoards(), chessqdl::nWhite);
+
+	EXPECT_NE(std::find(moves.begin(), moves.end(), move), moves.end());
+}
+
+TEST(Nnue, NetworkSetMidGame_Test) {
+	chessqdl::Engine engine(chessqdl::nWhite, 3, false, false, 0);
+	engine.makeMove("e2e4", false, false);
+	engine.makeMove("e7e5", false, false);
+	engine.setNetwork(getNetwork());
+
+	// Positions played before the network was set get an accumulator when they are reached again
+	engine.takeMove();
+	EXPECT_EQ(engine.getAccumulator(), getNetwork()->refresh(engine.getBitboard().getBitBoards()));
+	engine.takeMove();
+	EXPECT_EQ(engine.getAccumulator(), getNetwork()->refresh(engine.getBitboard().getBitBoards()));
+
+	EXPECT_FALSE(engine.getBestMove(2, chessqdl::nWhite).empty());
+}
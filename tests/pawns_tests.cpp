@@ -0,0 +1,102 @@
+#include "gtest/gtest.h"
+
+#include "Engine/bitboard.hpp"
+#include "Engine/evaluation.hpp"
+#include "Engine/pawns.hpp"
+
+namespace {
+
+	uint64_t squareMask(const int square) {
+		return 1ULL << square;
+	}
+
+}
+
+TEST(Pawns, InitialPosition_Test) {
+	chessqdl::Bitboard board;
+	const chessqdl::PawnEntry entry = chessqdl::evaluatePawns(board.getBitBoards());
+
+	EXPECT_EQ(entry.mgScore, 0);
+	EXPECT_EQ(entry.egScore, 0);
+	EXPECT_EQ(entry.passed[chessqdl::nWhite], 0);
+	EXPECT_EQ(entry.passed[chessqdl::nBlack], 0);
+}
+
+TEST(Pawns, PassedPawn_Test) {
+	// The pawn on d5 is passed, while the pawns on a2 and b4 stop each other
+	chessqdl::Bitboard board("4k3/8/8/3P4/1p6/8/P7/4K3 w - - 0 1");
+	const chessqdl::PawnEntry entry = chessqdl::evaluatePawns(board.getBitBoards());
+
+	// d5 = 35
+	EXPECT_EQ(entry.passed[chessqdl::nWhite], squareMask(35));
+	EXPECT_EQ(entry.passed[chessqdl::nBlack], 0);
+}
+
+TEST(Pawns, DoubledAndIsolated_Test) {
+	// Doubled, isolated white pawns on the c file
+	chessqdl::Bitboard doubled("4k3/5ppp/8/8/8/2P5/2P5/4K3 w - - 0 1");
+	chessqdl::Bitboard single("4k3/5ppp/8/8/8/8/2P5/4K3 w - - 0 1");
+
+	const chessqdl::PawnEntry doubledEntry = chessqdl::evaluatePawns(doubled.getBitBoards());
+	const chessqdl::PawnEntry singleEntry = chessqdl::evaluatePawns(single.getBitBoards());
+
+	EXPECT_LT(doubledEntry.egScore, singleEntry.egScore);
+	// Only the front pawn (c3 = 18) counts as passed
+	EXPECT_EQ(doubledEntry.passed[chessqdl::nWhite], squareMask(18));
+}
+
+TEST(Pawns, Backward_Test) {
+	// The pawn on d3 cannot be supported by the pawns on c4 and e4, and d4 is attacked by the pawn on e5
+	chessqdl::Bitboard backward("4k3/8/8/4p3/2P1P3/3P4/8/4K3 w - - 0 1");
+	// Same structure, with the black pawn on e6 so that d4 is safe
+	chessqdl::Bitboard safe("4k3/8/4p3/8/2P1P3/3P4/8/4K3 w - - 0 1");
+
+	const chessqdl::PawnEntry backwardEntry = chessqdl::evaluatePawns(backward.getBitBoards());
+	const chessqdl::PawnEntry safeEntry = chessqdl::evaluatePawns(safe.getBitBoards());
+
+	EXPECT_EQ(backwardEntry.passed, safeEntry.passed);
+	EXPECT_LT(backwardEntry.mgScore, safeEntry.mgScore);
+}
+
+TEST(Pawns, Symmetry_Test) {
+	chessqdl::Bitboard white("4k3/8/8/3P4/8/2P5/P1P5/4K3 w - - 0 1");
+	chessqdl::Bitboard black("4k3/p1p5/2p5/8/3p4/8/8/4K3 w - - 0 1");
+
+	const chessqdl::PawnEntry whiteEntry = chessqdl::evaluatePawns(white.getBitBoards());
+	const chessqdl::PawnEntry blackEntry = chessqdl::evaluatePawns(black.getBitBoards());
+
+	EXPECT_EQ(whiteEntry.mgScore, -blackEntry.mgScore);
+	EXPECT_EQ(whiteEntry.egScore, -blackEntry.egScore);
+}
+
+TEST(Pawns, HashTable_Test) {
+	chessqdl::Bitboard board("4k3/8/8/3P4/1p6/8/P7/4K3 w - - 0 1");
+	const chessqdl::EvalState state = chessqdl::computeEvalState(board.getBitBoards());
+	const chessqdl::PawnEntry expected = chessqdl::evaluatePawns(board.getBitBoards());
+
+	chessqdl::PawnHashTable table(1);
+
+	const chessqdl::PawnEntry &first = table.probe(state.pawnKey, board.getBitBoards());
+	EXPECT_EQ(first.key, state.pawnKey);
+	EXPECT_EQ(first.mgScore, expected.mgScore);
+	EXPECT_EQ(first.egScore, expected.egScore);
+	EXPECT_DOUBLE_EQ(table.getHitRate(), 0.0);
+
+	const chessqdl::PawnEntry &second = table.probe(state.pawnKey, board.getBitBoards());
+	EXPECT_EQ(second.mgScore, expected.mgScore);
+	EXPECT_DOUBLE_EQ(table.getHitRate(), 0.5);
+
+	table.resetStats();
+	EXPECT_DOUBLE_EQ(table.getHitRate(), 0.0);
+}
+
+TEST(Pawns, CachedEvaluation_Test) {
+	chessqdl::Bitboard board("r1bqk1nr/pppp1ppp/2n5/2b1p3/1PB1P3/5N2/P1PP1PPP/RNBQK2R b KQkq b3 1 4");
+	const chessqdl::EvalState state = chessqdl::computeEvalState(board.getBitBoards());
+	chessqdl::PawnHashTable table(1);
+
+	for (int i = 0; i < 2; i++) {
+		EXPECT_EQ(chessqdl::evaluateBoard(board.getBitBoards(), state, chessqdl::nWhite, &table),
+				  chessqdl::evaluateBoard(board.getBitBoards(), chessqdl::nWhite));
+	}
+}
@@ -0,0 +1,53 @@
+#include "gtest/gtest.h"
+
+#include "Engine/bitboard.hpp"
+#include "Engine/perft.hpp"
+
+#include <algorithm>
+
+namespace {
+
+	chessqdl::enumColor sideToMove(const std::string &fen) {
+		return fen.substr(fen.find(' ') + 1, 1) == "w" ? chessqdl::nWhite : chessqdl::nBlack;
+	}
+
+}
+
+TEST(Perft, ReferencePositions_Test) {
+	for (const auto &reference: chessqdl::perftReferences) {
+		chessqdl::Bitboard board(reference.fen);
+
+		for (size_t depth = 1; depth <= reference.counts.size(); depth++) {
+			EXPECT_EQ(chessqdl::perft(board.getBitBoards(), sideToMove(reference.fen), static_cast<int>(depth)),
+					  reference.counts[depth - 1]) << reference.fen << " at depth " << depth;
+		}
+	}
+}
+
+TEST(Perft, DivideThreadsAndHash_Test) {
+	const auto &reference = chessqdl::perftReferences[0];
+	chessqdl::Bitboard board(reference.fen);
+
+	const auto single = chessqdl::perftDivide(board.getBitBoards(), chessqdl::nWhite, 4, 1, 0);
+	const auto parallel = chessqdl::perftDivide(board.getBitBoards(), chessqdl::nWhite, 4, 4, 16);
+
+	EXPECT_EQ(single.nodes, reference.counts[3]);
+	EXPECT_EQ(parallel.nodes, reference.counts[3]);
+	ASSERT_EQ(single.divide.size(), 20);
+	EXPECT_EQ(single.divide, parallel.divide);
+
+	const auto e4 = std::find_if(single.divide.begin(), single.divide.end(),
+								 [](const auto &entry) { return entry.first == "e2e4"; });
+	ASSERT_NE(e4, single.divide.end());
+	EXPECT_EQ(e4->second, 13160);
+}
+
+TEST(Perft, PawnsAndKings_Test) {
+	// A pawn cannot jump over a blocker on its double push
+	chessqdl::Bitboard blocked("4k3/8/8/8/8/4n3/4P3/4K3 w - - 0 1");
+	EXPECT_EQ(chessqdl::perft(blocked.getBitBoards(), chessqdl::nWhite, 1), 2);
+
+	// Kings can never stand next to each other
+	chessqdl::Bitboard kings("8/8/8/3k4/8/3K4/8/8 w - - 0 1");
+	EXPECT_EQ(chessqdl::perft(kings.getBitBoards(), chessqdl::nWhite, 1), 5);
+}
@@ -0,0 +1,127 @@
+#include "gtest/gtest.h"
+
+#include "Engine/pgn.hpp"
+#include "Engine/utils.hpp"
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+
+namespace {
+
+	const std::string games = R"([Event "Open game"]
+[Result "1-0"]
+
+1. e4 {best by test} e5 (1... c5 2. Nf3 {Sicilian} (2. c3)) 2. Nf3 $1 Nc6 3.Bc4 Nf6??
+4. Ng5 d5 1-0
+
+[Event "Back rank"]
+[FEN "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1"]
+[SetUp "1"]
+[Result "*"]
+
+1. Rd8# 1-0
+
+[Event "Castling"]
+[Result "1/2-1/2"]
+
+; Castling is not generated
+1. e4 e5 2. Nf3 Nc6 3. Bb5 a6 4. O-O Nf6 1/2-1/2
+
+[Event "Unfinished"]
+[Result "*"]
+
+1. d4 d5 *
+
+[Event "Broken setup"]
+[FEN "8/8/8/8/8/8/8/8 w - - 0 1"]
+[Result "0-1"]
+
+1. Kd2 0-1
+)";
+
+}
+
+TEST(Pgn, ReadPgn_Test) {
+	std::vector<chessqdl::PgnPosition> positions;
+	const chessqdl::PgnStats stats = chessqdl::readPgn(games, [&positions](const chessqdl::PgnPosition &position,
+																		   const unsigned thread) {
+		EXPECT_EQ(thread, 0);
+		positions.push_back(position);
+	});
+
+	EXPECT_EQ(stats.games, 3);
+	EXPECT_EQ(stats.positions, 15);
+	EXPECT_EQ(stats.truncated, 1);
+	EXPECT_EQ(stats.skipped, 2);
+	ASSERT_EQ(positions.size(), 15);
+
+	// Variations and comments are skipped, and glued move numbers are read
+	EXPECT_EQ(chessqdl::unpackMove(positions[0].move), "e2e4");
+	EXPECT_EQ(chessqdl::unpackMove(positions[2].move), "g1f3");
+	EXPECT_EQ(chessqdl::unpackMove(positions[4].move), "f1c4");
+	EXPECT_EQ(chessqdl::unpackMove(positions[7].move), "d7d5");
+	EXPECT_EQ(positions[7].toMove, chessqdl::nBlack);
+	EXPECT_EQ(positions[7].ply, 7);
+	EXPECT_DOUBLE_EQ(positions[7].result, 1);
+
+	// The e4 pawn stands on e4 after the first move
+	EXPECT_TRUE(positions[1].board[chessqdl::nPawn].test(28));
+	EXPECT_FALSE(positions[1].board[chessqdl::nPawn].test(12));
+
+	// The result comes from the termination marker when the tag holds "*"
+	EXPECT_EQ(chessqdl::unpackMove(positions[8].move), "d1d8");
+	EXPECT_EQ(positions[8].ply, 0);
+	EXPECT_DOUBLE_EQ(positions[8].result, 1);
+
+	// Moves up to the castling are kept
+	EXPECT_EQ(chessqdl::unpackMove(positions[14].move), "a7a6");
+	EXPECT_DOUBLE_EQ(positions[14].result, 0.5);
+}
+
+TEST(Pgn, SplitPgn_Test) {
+	std::string text;
+	for (int i = 0; i < 20; i++)
+		text += games;
+
+	const auto parts = chessqdl::splitPgn(text, 7);
+	ASSERT_EQ(parts.size(), 7);
+
+	std::string joined;
+	for (const auto &part: parts) {
+		EXPECT_EQ(part.substr(0, 8), "[Event \"");
+		joined += part;
+	}
+	EXPECT_EQ(joined, text);
+
+	// More parts than games
+	EXPECT_EQ(chessqdl::splitPgn(games, 100).size(), 5);
+	EXPECT_EQ(chessqdl::splitPgn("", 4).size(), 1);
+}
+
+TEST(Pgn, ReadPgnFile_Test) {
+	const std::string path = testing::TempDir() + "chessqdl_games.pgn";
+	{
+		std::ofstream file(path);
+		for (int i = 0; i < 50; i++)
+			file << games << "\n";
+	}
+
+	std::atomic<long long> count = 0;
+	std::atomic<long long> wins = 0;
+	chessqdl::PgnStats stats;
+
+	ASSERT_TRUE(chessqdl::readPgnFile(path, [&](const chessqdl::PgnPosition &position, unsigned) {
+		count++;
+		wins += position.result == 1;
+	}, stats, 3));
+
+	EXPECT_EQ(stats.games, 150);
+	EXPECT_EQ(stats.positions, 750);
+	EXPECT_EQ(stats.truncated, 50);
+	EXPECT_EQ(stats.skipped, 100);
+	EXPECT_EQ(count, 750);
+	EXPECT_EQ(wins, 450);
+
+	EXPECT_FALSE(chessqdl::readPgnFile(testing::TempDir() + "chessqdl_missing.pgn", {}, stats));
+}
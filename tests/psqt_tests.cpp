@@ -0,0 +1,118 @@
+#include "gtest/gtest.h"
+
+#include "Engine/bitboard.hpp"
+#include "Engine/engine.hpp"
+#include "Engine/evaluation.hpp"
+#include "Engine/psqt.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+	/**
+	 * @brief Writes \p contents to a temporary file and returns its path
+	 */
+	std::string writeTemporaryFile(const std::string &name, const std::string &contents) {
+		const std::string path = testing::TempDir() + name;
+		std::ofstream file(path);
+		file << contents;
+		return path;
+	}
+
+}
+
+TEST(PieceSquareTables, Mirroring_Test) {
+	const chessqdl::PieceSquareTables &tables = chessqdl::getDefaultPieceSquareTables();
+
+	// A white knight on b1 and a black knight on b8 get the same bonus
+	EXPECT_EQ(tables.mg[chessqdl::nKnight][chessqdl::relativeSquare(chessqdl::nWhite, 1)],
+			  tables.mg[chessqdl::nKnight][chessqdl::relativeSquare(chessqdl::nBlack, 57)]);
+}
+
+TEST(PieceSquareTables, Centralization_Test) {
+	// Same material, but the white knight stands on e4 instead of a1. Pawns keep it from being a drawn endgame
+	chessqdl::Bitboard center("4k3/4p3/8/8/4N3/8/4P3/4K3 w - - 0 1");
+	chessqdl::Bitboard corner("4k3/4p3/8/8/8/8/4P3/N3K3 w - - 0 1");
+
+	EXPECT_GT(chessqdl::evaluateBoard(center.getBitBoards(), chessqdl::nWhite),
+			  chessqdl::evaluateBoard(corner.getBitBoards(), chessqdl::nWhite));
+}
+
+TEST(PieceSquareTables, RoundTrip_Test) {
+	std::ostringstream out;
+	chessqdl::writePieceSquareTables(out, chessqdl::getDefaultPieceSquareTables());
+
+	const std::string path = writeTemporaryFile("chessqdl_psqt_roundtrip.txt", out.str());
+
+	chessqdl::PieceSquareTables tables{};
+	ASSERT_TRUE(chessqdl::loadPieceSquareTables(path, tables));
+	EXPECT_EQ(tables.mg, chessqdl::getDefaultPieceSquareTables().mg);
+	EXPECT_EQ(tables.eg, chessqdl::getDefaultPieceSquareTables().eg);
+
+	std::remove(path.c_str());
+}
+
+TEST(PieceSquareTables, PartialFile_Test) {
+	std::ostringstream contents;
+	contents << "# Only the middlegame knight table\nmg knight\n";
+	for (int square = 0; square < 64; square++)
+		contents << square << (square % 8 == 7 ? "\n" : " ");
+
+	const std::string path = writeTemporaryFile("chessqdl_psqt_partial.txt", contents.str());
+
+	chessqdl::PieceSquareTables tables = chessqdl::getDefaultPieceSquareTables();
+	ASSERT_TRUE(chessqdl::loadPieceSquareTables(path, tables));
+
+	// The first value is a8, the last one is h1
+	EXPECT_EQ(tables.mg[chessqdl::nKnight][56], 0);
+	EXPECT_EQ(tables.mg[chessqdl::nKnight][7], 63);
+	EXPECT_EQ(tables.mg[chessqdl::nPawn], chessqdl::getDefaultPieceSquareTables().mg[chessqdl::nPawn]);
+
+	std::remove(path.c_str());
+}
+
+TEST(PieceSquareTables, InvalidFile_Test) {
+	chessqdl::PieceSquareTables tables = chessqdl::getDefaultPieceSquareTables();
+	EXPECT_FALSE(chessqdl::loadPieceSquareTables(testing::TempDir() + "chessqdl_psqt_missing.txt", tables));
+
+	const std::string unknownPiece = writeTemporaryFile("chessqdl_psqt_piece.txt", "mg archbishop 1 2 3");
+	EXPECT_FALSE(chessqdl::loadPieceSquareTables(unknownPiece, tables));
+
+	const std::string shortTable = writeTemporaryFile("chessqdl_psqt_short.txt", "eg king 1 2 3");
+	EXPECT_FALSE(chessqdl::loadPieceSquareTables(shortTable, tables));
+
+	EXPECT_EQ(tables.mg, chessqdl::getDefaultPieceSquareTables().mg);
+	EXPECT_EQ(tables.eg, chessqdl::getDefaultPieceSquareTables().eg);
+
+	std::remove(unknownPiece.c_str());
+	std::remove(shortTable.c_str());
+}
+
+TEST(PieceSquareTables, PerEngine_Test) {
+	std::ostringstream contents;
+	contents << "mg knight\n";
+	for (int square = 0; square < 64; square++)
+		contents << 0 << (square % 8 == 7 ? "\n" : " ");
+
+	const std::string path = writeTemporaryFile("chessqdl_psqt_engine.txt", contents.str());
+	const std::string fen = "4k3/4p3/8/8/4N3/8/4P3/4K3 w - - 0 1";
+
+	chessqdl::Engine loaded(fen, chessqdl::nWhite, 1, false, false, 0);
+	chessqdl::Engine other(fen, chessqdl::nWhite, 1, false, false, 0);
+	ASSERT_TRUE(loaded.loadWeights(path));
+
+	// Only the engine that loaded the file uses its tables
+	EXPECT_EQ(loaded.getEvalState().mgPsqt[chessqdl::nWhite] - other.getEvalState().mgPsqt[chessqdl::nWhite],
+	          -chessqdl::getDefaultPieceSquareTables().mg[chessqdl::nKnight][chessqdl::e4]);
+	EXPECT_EQ(other.getPieceSquareTables(), chessqdl::getSharedDefaultPieceSquareTables());
+
+	// Tables are shared between engines, and a null pointer restores the default ones
+	other.setPieceSquareTables(loaded.getPieceSquareTables());
+	EXPECT_EQ(other.getEvalState(), loaded.getEvalState());
+	other.setPieceSquareTables(nullptr);
+	EXPECT_EQ(other.getEvalState(), chessqdl::computeEvalState(other.getBitboard().getBitBoards()));
+
+	std::remove(path.c_str());
+}
@@ -0,0 +1,123 @@
+#include "gtest/gtest.h"
+
+#include "Engine/bitboard.hpp"
+#include "Engine/movegen.hpp"
+#include "Engine/san.hpp"
+#include "Engine/utils.hpp"
+
+#include <algorithm>
+
+TEST(San, PawnsAndPieces_Test) {
+	chessqdl::Bitboard board;
+	const auto &bitboards = board.getBitBoards();
+
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "e4"), "e2e4");
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "Nf3"), "g1f3");
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nBlack, "Nc6!?"), "b8c6");
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "g1f3"), "g1f3");
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "e2-e4"), "e2e4");
+
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "e5"), "");
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "Nd2"), "");
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "O-O"), "");
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "e2e5"), "");
+}
+
+TEST(San, CapturesAndDisambiguation_Test) {
+	chessqdl::Bitboard board("4k3/8/8/3p4/2P1P3/8/8/R3K2R w - - 0 1");
+	const auto &bitboards = board.getBitBoards();
+
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "cxd5"), "c4d5");
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "exd5"), "e4d5");
+	// Two pawns can take on d5
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "xd5"), "");
+
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "Rad1"), "a1d1");
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "Rhf1"), "h1f1");
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "Rb1"), "a1b1");
+	// The king stands between the a rook and f1
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "Rf1"), "h1f1");
+}
+
+TEST(San, Promotions_Test) {
+	chessqdl::Bitboard board("1r2k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+	const auto &bitboards = board.getBitBoards();
+
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "a8=Q+"), "a7a8q");
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "axb8N"), "a7b8n");
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "a7b8r"), "a7b8r");
+	// A promotion needs its piece
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "a8"), "");
+}
+
+TEST(San, MoveToSan_Test) {
+	chessqdl::Bitboard board("4k3/8/8/3p4/2P1P3/8/8/R3K2R w - - 0 1");
+	const auto &bitboards = board.getBitBoards();
+
+	EXPECT_EQ(chessqdl::moveToSan(bitboards, chessqdl::nWhite, "c4d5"), "cxd5");
+	EXPECT_EQ(chessqdl::moveToSan(bitboards, chessqdl::nWhite, "e4e5"), "e5");
+	EXPECT_EQ(chessqdl::moveToSan(bitboards, chessqdl::nWhite, "a1a8"), "Ra8+");
+	EXPECT_EQ(chessqdl::moveToSan(bitboards, chessqdl::nWhite, "e1d2"), "Kd2");
+
+	// Knights on the same rank, on the same file, and on both
+	chessqdl::Bitboard knights("4k3/8/8/1N3N2/8/1N6/8/4K3 w - - 0 1");
+	EXPECT_EQ(chessqdl::moveToSan(knights.getBitBoards(), chessqdl::nWhite, "b5d4"), "Nb5d4");
+	EXPECT_EQ(chessqdl::moveToSan(knights.getBitBoards(), chessqdl::nWhite, "f5d4"), "Nfd4");
+	EXPECT_EQ(chessqdl::moveToSan(knights.getBitBoards(), chessqdl::nWhite, "b3d4"), "N3d4");
+	EXPECT_EQ(chessqdl::moveToSan(knights.getBitBoards(), chessqdl::nWhite, "f5h6"), "Nh6");
+
+	chessqdl::Bitboard promotion("1r2k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+	EXPECT_EQ(chessqdl::moveToSan(promotion.getBitBoards(), chessqdl::nWhite, "a7b8q"), "axb8=Q+");
+	EXPECT_EQ(chessqdl::moveToSan(promotion.getBitBoards(), chessqdl::nWhite, "a7a8n"), "a8=N");
+
+	chessqdl::Bitboard mate("6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1");
+	EXPECT_EQ(chessqdl::moveToSan(mate.getBitBoards(), chessqdl::nWhite, "d1d8"), "Rd8#");
+}
+
+TEST(San, LongAlgebraic_Test) {
+	chessqdl::Bitboard board("1r2k3/P7/8/3p4/2P5/8/8/4K1N1 w - - 0 1");
+	const auto &bitboards = board.getBitBoards();
+
+	EXPECT_EQ(chessqdl::moveToLan(bitboards, chessqdl::nWhite, "g1f3"), "Ng1-f3");
+	EXPECT_EQ(chessqdl::moveToLan(bitboards, chessqdl::nWhite, "c4d5"), "c4xd5");
+	EXPECT_EQ(chessqdl::moveToLan(bitboards, chessqdl::nWhite, "a7a8q"), "a7-a8=Q");
+	EXPECT_EQ(chessqdl::moveToLan(bitboards, chessqdl::nWhite, "a7b8n"), "a7xb8=N");
+
+	// Every written move is read back
+	for (const std::string mv: {"g1f3", "c4d5", "a7a8q", "a7b8n", "e1d2"})
+		EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, chessqdl::moveToLan(bitboards, chessqdl::nWhite, mv)),
+				  mv);
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "Ng1-e2"), "g1e2");
+	EXPECT_EQ(chessqdl::sanToMove(bitboards, chessqdl::nWhite, "Ng1-g3"), "");
+}
+
+TEST(San, MatchesMoveGenerator_Test) {
+	const char *positions[] = {
+		"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - - 0 1",
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b - - 0 1",
+		"4k3/1P4P1/8/2N1N3/8/2N1N3/1p4p1/R3K2R w - - 0 1",
+		"4k3/1P4P1/8/2N1N3/8/2N1N3/1p4p1/R3K2R b - - 0 1",
+		"3qk3/8/8/1b6/8/8/4R3/4K3 w - - 0 1",
+		"8/8/8/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+	};
+
+	for (const char *fen: positions) {
+		chessqdl::Bitboard board(fen);
+		const auto &bitboards = board.getBitBoards();
+		const chessqdl::enumColor toMove = std::string(fen).find(" w ") != std::string::npos ? chessqdl::nWhite
+																							   : chessqdl::nBlack;
+		const auto legal = chessqdl::MoveGenerator::getLegalMoves(bitboards, toMove);
+
+		// Every legal move is read back from both notations, and the other pseudo-legal moves are rejected
+		for (const std::string &mv: chessqdl::MoveGenerator::getPseudoLegalMoves(bitboards, toMove)) {
+			const bool isLegal = std::find(legal.begin(), legal.end(), mv) != legal.end();
+
+			EXPECT_EQ(chessqdl::sanToPackedMove(bitboards, toMove, mv), isLegal ? chessqdl::packMove(mv)
+																				 : chessqdl::nullMove) << fen << " " << mv;
+			if (isLegal) {
+				EXPECT_EQ(chessqdl::sanToPackedMove(bitboards, toMove, chessqdl::moveToSan(bitboards, toMove, mv)),
+						  chessqdl::packMove(mv)) << fen << " " << mv;
+			}
+		}
+	}
+}
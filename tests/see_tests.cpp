@@ -0,0 +1,78 @@
+#include "gtest/gtest.h"
+
+#include "Engine/bitboard.hpp"
+#include "Engine/movegen.hpp"
+#include "Engine/see.hpp"
+
+TEST(StaticExchange, AttackersTo_Test) {
+	chessqdl::Bitboard board("3rk3/8/8/3p4/4P3/8/3R4/3RK3 w - - 0 1");
+	const auto bitboards = board.getBitBoards();
+
+	// The rook on d1 is hidden behind the rook on d2
+	EXPECT_EQ(chessqdl::MoveGenerator::getAttackersTo(bitboards, chessqdl::d5, bitboards[chessqdl::nColor]),
+			  (1ULL << chessqdl::e4) | (1ULL << chessqdl::d2) | (1ULL << chessqdl::d8));
+
+	// Removing the rook on d2 reveals the rook on d1
+	chessqdl::U64 occupied = bitboards[chessqdl::nColor];
+	occupied.reset(chessqdl::d2);
+	EXPECT_TRUE(chessqdl::MoveGenerator::getAttackersTo(bitboards, chessqdl::d5, occupied).test(chessqdl::d1));
+}
+
+TEST(StaticExchange, UndefendedCapture_Test) {
+	chessqdl::Bitboard board("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1");
+
+	EXPECT_EQ(chessqdl::see(board.getBitBoards(), "e1e5"), 100);
+	EXPECT_TRUE(chessqdl::seeGe(board.getBitBoards(), "e1e5", 100));
+	EXPECT_FALSE(chessqdl::seeGe(board.getBitBoards(), "e1e5", 101));
+}
+
+TEST(StaticExchange, DefendedCapture_Test) {
+	chessqdl::Bitboard board("4k3/8/2p5/3p4/4Q3/8/8/4K3 w - - 0 1");
+
+	EXPECT_EQ(chessqdl::see(board.getBitBoards(), "e4d5"), 100 - 900);
+	EXPECT_FALSE(chessqdl::seeGe(board.getBitBoards(), "e4d5", 0));
+	EXPECT_TRUE(chessqdl::seeGe(board.getBitBoards(), "e4d5", -800));
+}
+
+TEST(StaticExchange, XRay_Test) {
+	// Rxd5 Rxd5 Rxd5 only works because the second rook is lined up behind the first one
+	chessqdl::Bitboard board("3rk3/8/8/3p4/8/8/3R4/3RK3 w - - 0 1");
+
+	EXPECT_EQ(chessqdl::see(board.getBitBoards(), "d2d5"), 100);
+	EXPECT_TRUE(chessqdl::seeGe(board.getBitBoards(), "d2d5", 100));
+
+	chessqdl::Bitboard single("3rk3/8/8/3p4/8/8/3R4/4K3 w - - 0 1");
+
+	EXPECT_EQ(chessqdl::see(single.getBitBoards(), "d2d5"), 100 - 500);
+	EXPECT_FALSE(chessqdl::seeGe(single.getBitBoards(), "d2d5", 0));
+}
+
+TEST(StaticExchange, QuietMove_Test) {
+	chessqdl::Bitboard board("4k3/8/2p5/8/8/8/8/3QK3 w - - 0 1");
+
+	// Qd1d5 hangs the queen to the pawn on c6, Qd1d4 is safe
+	EXPECT_EQ(chessqdl::see(board.getBitBoards(), "d1d5"), -900);
+	EXPECT_EQ(chessqdl::see(board.getBitBoards(), "d1d4"), 0);
+	EXPECT_FALSE(chessqdl::seeGe(board.getBitBoards(), "d1d5", -100));
+	EXPECT_TRUE(chessqdl::seeGe(board.getBitBoards(), "d1d4", 0));
+}
+
+TEST(StaticExchange, Promotion_Test) {
+	chessqdl::Bitboard board("1r2k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+
+	// axb8=Q wins the rook and promotes. a8=Q is recaptured by the rook
+	EXPECT_EQ(chessqdl::see(board.getBitBoards(), "a7b8q"), 500 + 900 - 100);
+	EXPECT_EQ(chessqdl::see(board.getBitBoards(), "a7a8q"), 900 - 100 - 900);
+	EXPECT_TRUE(chessqdl::seeGe(board.getBitBoards(), "a7b8q", 1300));
+}
+
+TEST(StaticExchange, MatchesThreshold_Test) {
+	chessqdl::Bitboard board("1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1");
+	const auto bitboards = board.getBitBoards();
+
+	for (const std::string mv : {"d3e5", "e2e5", "g2b7", "d3b4"}) {
+		const int value = chessqdl::see(bitboards, mv);
+		EXPECT_TRUE(chessqdl::seeGe(bitboards, mv, value)) << mv;
+		EXPECT_FALSE(chessqdl::seeGe(bitboards, mv, value + 1)) << mv;
+	}
+}
@@ -0,0 +1,173 @@
+#include "gtest/gtest.h"
+
+#include "Engine/server.hpp"
+
+#include <algorithm>
+#include <set>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+	/**
+	 * @brief Stand-in client: sends the requests, closes its side of the connection and reads every line until the
+	 * server closes the other
+	 */
+	std::vector<std::string> exchange(const int fd, const std::string &requests) {
+		EXPECT_EQ(::send(fd, requests.data(), requests.size(), 0), static_cast<ssize_t>(requests.size()));
+		::shutdown(fd, SHUT_WR);
+
+		std::string received;
+		char chunk[4096];
+
+		for (ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0); n > 0; n = ::recv(fd, chunk, sizeof(chunk), 0))
+			received.append(chunk, static_cast<size_t>(n));
+
+		::close(fd);
+
+		std::vector<std::string> lines;
+		size_t start = 0;
+		for (size_t newline = received.find('\n'); newline != std::string::npos; newline = received.find('\n', start)) {
+			lines.push_back(received.substr(start, newline - start));
+			start = newline + 1;
+		}
+
+		return lines;
+	}
+
+	int connectTcp(const int port) {
+		const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+		sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port = htons(static_cast<uint16_t>(port));
+
+		EXPECT_EQ(::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)), 0);
+		return fd;
+	}
+
+	const std::string *findLine(const std::vector<std::string> &lines, const std::string &id) {
+		const auto it = std::find_if(lines.begin(), lines.end(), [&id](const std::string &line) {
+			return line.find("{\"id\":\"" + id + "\"") == 0;
+		});
+
+		return it == lines.end() ? nullptr : &*it;
+	}
+
+}
+
+TEST(Server, ParseServerRequest_Test) {
+	chessqdl::SearchLimits defaults;
+	defaults.moveTime = 100;
+	chessqdl::ServerRequest request;
+	std::string error;
+
+	ASSERT_TRUE(chessqdl::parseServerRequest(R"({"id": "a", "fen": "startpos", "depth": 4, "multipv": 2})", defaults,
+											 request, error));
+	EXPECT_EQ(request.id, "a");
+	EXPECT_EQ(request.fen, "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - - 0 1");
+	EXPECT_EQ(request.limits.depth, 4);
+	EXPECT_EQ(request.limits.moveTime, 0);
+	EXPECT_EQ(request.limits.multiPv, 2);
+
+	// Default limits, a numeric id and a FEN without move counters
+	ASSERT_TRUE(chessqdl::parseServerRequest(R"({"fen":"4k3/8/8/8/8/8/8/4K2R w - -","id":7,"extra":null})", defaults,
+											 request, error));
+	EXPECT_EQ(request.id, "7");
+	EXPECT_EQ(request.fen, "4k3/8/8/8/8/8/8/4K2R w - - 0 1");
+	EXPECT_EQ(request.limits.moveTime, 100);
+	EXPECT_EQ(request.limits.multiPv, 1);
+
+	EXPECT_FALSE(chessqdl::parseServerRequest(R"({"id": "b", "fen": "startpos")", defaults, request, error));
+	EXPECT_EQ(error, "invalid JSON");
+	EXPECT_FALSE(chessqdl::parseServerRequest(R"({"id": "b", "depth": 3})", defaults, request, error));
+	EXPECT_EQ(error, "missing fen");
+	EXPECT_EQ(request.id, "b");
+	EXPECT_FALSE(chessqdl::parseServerRequest(R"({"fen": "8/8/8/8/8/8/8/8 w - -"})", defaults, request, error));
+	EXPECT_EQ(error, "invalid position");
+	EXPECT_FALSE(chessqdl::parseServerRequest(R"({"fen": "startpos", "depth": -2})", defaults, request, error));
+	EXPECT_EQ(error, "invalid depth");
+	EXPECT_FALSE(chessqdl::parseServerRequest(R"({"fen": "startpos", "multipv": 0})", defaults, request, error));
+	EXPECT_EQ(error, "invalid multipv");
+	EXPECT_FALSE(chessqdl::parseServerRequest(R"({"fen": "startpos"})", chessqdl::SearchLimits(), request, error));
+	EXPECT_EQ(error, "no search limit");
+}
+
+TEST(Server, Tcp_Test) {
+	chessqdl::ServerOptions options;
+	options.engines = 2;
+	options.queueSize = 2;
+	options.limits.depth = 2;
+
+	chessqdl::AnalysisServer server(options);
+	ASSERT_TRUE(server.start());
+	ASSERT_GT(server.getPort(), 0);
+
+	// More requests than engines and queue slots, which holds the connection back until they are analyzed
+	std::string requests;
+	for (int i = 0; i < 6; i++)
+		requests += R"({"id": ")" + std::to_string(i) + R"(", "fen": "startpos"})" + "\n";
+	requests += R"({"id": "mate", "fen": "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1"})" "\n";
+	requests += R"({"id": "lines", "fen": "startpos", "depth": 2, "multipv": 3})" "\n";
+	requests += R"({"id": "bad", "fen": "startpos", "nodes": "many"})" "\n";
+
+	const auto lines = exchange(connectTcp(server.getPort()), requests);
+	ASSERT_EQ(lines.size(), 9);
+
+	for (int i = 0; i < 6; i++) {
+		const std::string *line = findLine(lines, std::to_string(i));
+		ASSERT_NE(line, nullptr);
+		EXPECT_NE(line->find(R"("depth":2)"), std::string::npos);
+		EXPECT_EQ(line->find("lines"), std::string::npos);
+	}
+
+	ASSERT_NE(findLine(lines, "mate"), nullptr);
+	EXPECT_NE(findLine(lines, "mate")->find(R"("bestmove":"d1d8")"), std::string::npos);
+
+	ASSERT_NE(findLine(lines, "lines"), nullptr);
+	const std::string &multiPv = *findLine(lines, "lines");
+	size_t count = 0;
+	for (size_t pos = multiPv.find("\"move\""); pos != std::string::npos; pos = multiPv.find("\"move\"", pos + 1))
+		count++;
+	EXPECT_EQ(count, 3);
+
+	ASSERT_NE(findLine(lines, "bad"), nullptr);
+	EXPECT_EQ(*findLine(lines, "bad"), R"({"id":"bad","error":"invalid nodes"})");
+
+	// Several clients at once
+	const int first = connectTcp(server.getPort());
+	const int second = connectTcp(server.getPort());
+	EXPECT_EQ(exchange(second, R"({"id": "x", "fen": "startpos", "depth": 1})" "\n").size(), 1);
+	EXPECT_EQ(exchange(first, R"({"id": "y", "fen": "startpos", "depth": 1})" "\n").size(), 1);
+
+	server.stop();
+}
+
+TEST(Server, UnixSocket_Test) {
+	chessqdl::ServerOptions options;
+	options.socketPath = testing::TempDir() + "chessqdl_server.sock";
+	options.engines = 1;
+	options.limits.nodes = 1000;
+
+	chessqdl::AnalysisServer server(options);
+	ASSERT_TRUE(server.start());
+	EXPECT_EQ(server.getPort(), 0);
+
+	const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	options.socketPath.copy(address.sun_path, options.socketPath.size());
+	ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)), 0);
+
+	const auto lines = exchange(fd, R"({"id": "u", "fen": "startpos"})" "\n");
+	ASSERT_EQ(lines.size(), 1);
+	EXPECT_NE(lines[0].find(R"("bestmove":")"), std::string::npos);
+
+	// The socket file is removed when the server stops
+	server.stop();
+	EXPECT_NE(::access(options.socketPath.c_str(), F_OK), 0);
+}
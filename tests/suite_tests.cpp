@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+
+#include "Engine/suite.hpp"
+
+#include <sstream>
+
+TEST(Suite, ParseSuitePosition_Test) {
+	chessqdl::SuitePosition position;
+
+	ASSERT_TRUE(chessqdl::parseSuitePosition(R"(6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - bm Rd8#; id "back rank";)",
+											 position));
+	EXPECT_EQ(position.fen, "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1");
+	EXPECT_EQ(position.id, "back rank");
+	EXPECT_EQ(position.bestMoves, std::vector<std::string>{"d1d8"});
+	EXPECT_TRUE(position.avoidMoves.empty());
+	EXPECT_TRUE(position.isSolution("d1d8"));
+	EXPECT_FALSE(position.isSolution("d1d7"));
+
+	ASSERT_TRUE(chessqdl::parseSuitePosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - - am f3 g4;", position));
+	EXPECT_EQ(position.avoidMoves, (std::vector<std::string>{"f2f3", "g2g4"}));
+	EXPECT_TRUE(position.isSolution("e2e4"));
+	EXPECT_FALSE(position.isSolution("g2g4"));
+
+	// No solution, or an illegal one
+	EXPECT_FALSE(chessqdl::parseSuitePosition("6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - id \"none\";", position));
+	EXPECT_FALSE(chessqdl::parseSuitePosition("6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - bm Rd9;", position));
+}
+
+TEST(Suite, RunSuite_Test) {
+	std::vector<chessqdl::SuitePosition> positions(3);
+
+	ASSERT_TRUE(chessqdl::parseSuitePosition("6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - bm Rd8; id \"mate\";", positions[0]));
+	ASSERT_TRUE(chessqdl::parseSuitePosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - - am f3; id \"start\";",
+											 positions[1]));
+	// Qd7 loses the queen
+	ASSERT_TRUE(chessqdl::parseSuitePosition("3rk3/8/8/8/8/8/8/3QK3 w - - bm Qd7; id \"wrong\";", positions[2]));
+
+	chessqdl::AnalysisOptions options;
+	options.limits.depth = 3;
+	options.threads = 2;
+	options.hashSize = 1;
+
+	size_t calls = 0;
+	const auto results = chessqdl::runSuite(positions, options,
+											[&calls](size_t, const chessqdl::SuiteResult &) { calls++; });
+
+	ASSERT_EQ(results.size(), 3);
+	EXPECT_EQ(calls, 3);
+
+	EXPECT_EQ(results[0].id, "mate");
+	EXPECT_TRUE(results[0].solved);
+	EXPECT_EQ(results[0].move, "d1d8");
+	// Mate is only seen once the replies are searched
+	EXPECT_EQ(results[0].depth, 2);
+
+	EXPECT_TRUE(results[1].solved);
+
+	EXPECT_FALSE(results[2].solved);
+	EXPECT_NE(results[2].move, "d1d7");
+
+	std::ostringstream summary;
+	chessqdl::printSuiteSummary(summary, results);
+
+	EXPECT_NE(summary.str().find("Solved 2 of 3 (66.7%)"), std::string::npos);
+	EXPECT_NE(summary.str().find("Depth to solution: p50 1, p75 2,"), std::string::npos);
+}
+
+TEST(Suite, Deterministic_Test) {
+	const std::string lines[] = {"6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - bm Rd8;",
+								 "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b - - bm Nf6;"};
+	std::vector<chessqdl::SuitePosition> positions(8);
+
+	for (size_t i = 0; i < positions.size(); i++)
+		ASSERT_TRUE(chessqdl::parseSuitePosition(lines[i % 2], positions[i]));
+
+	chessqdl::AnalysisOptions options;
+	options.limits.depth = 3;
+	options.hashSize = 1;
+
+	// Nodes and depth to solution do not depend on the positions searched before, nor on the thread
+	options.threads = 1;
+	const auto expected = chessqdl::runSuite(positions, options);
+	options.threads = 3;
+	const auto results = chessqdl::runSuite(positions, options);
+
+	for (size_t i = 0; i < positions.size(); i++) {
+		ASSERT_TRUE(expected[i].solved) << i;
+		EXPECT_EQ(expected[i].nodes, expected[i % 2].nodes) << i;
+		EXPECT_EQ(results[i].nodes, expected[i].nodes) << i;
+		EXPECT_EQ(results[i].depth, expected[i].depth) << i;
+		EXPECT_EQ(results[i].move, expected[i].move) << i;
+	}
+}
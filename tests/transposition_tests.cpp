@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+
+#include "Engine/engine.hpp"
+#include "Engine/transposition.hpp"
+#include "Engine/zobrist.hpp"
+#include "Engine/utils.hpp"
+
+TEST(TranspositionTable, StoreAndProbe_Test) {
+	chessqdl::TranspositionTable table(1);
+	chessqdl::TTEntry entry{};
+
+	EXPECT_FALSE(table.probe(0x1234, entry));
+
+	table.store(0x1234, 3, -42, chessqdl::nLowerBound, chessqdl::packMove("e2e4"));
+
+	ASSERT_TRUE(table.probe(0x1234, entry));
+	EXPECT_EQ(entry.score, -42);
+	EXPECT_EQ(entry.depth, 3);
+	EXPECT_EQ(entry.bound, chessqdl::nLowerBound);
+	EXPECT_EQ(chessqdl::unpackMove(entry.move), "e2e4");
+
+	table.clear();
+	EXPECT_FALSE(table.probe(0x1234, entry));
+}
+
+TEST(TranspositionTable, PackedMoves_Test) {
+	for (const std::string mv : {"a1h8", "e2e4", "h7h8q", "b2a1n", "c7c8r", "d2d1b"})
+		EXPECT_EQ(chessqdl::unpackMove(chessqdl::packMove(mv)), mv);
+
+	EXPECT_EQ(chessqdl::packMove("e9e4"), chessqdl::nullMove);
+}
+
+TEST(TranspositionTable, IncrementalHash_Test) {
+	chessqdl::Engine engine("r1bqk1nr/pppp1ppp/2n5/2b1p3/1PB1P3/5N2/P1PP1PPP/RNBQK2R w KQkq - 1 4", chessqdl::nWhite, 3,
+							false, false, 0);
+
+	const uint64_t initialHash = engine.getHash();
+
+	// Quiet move, capture and promotion-free sequence that goes back and forth
+	for (const std::string mv : {"b4c5", "c6d4", "f3d4", "e5d4"})
+		engine.makeMove(mv, false, false);
+
+	chessqdl::Engine reference("r1bqk1nr/pppp1ppp/8/2P5/2BpP3/8/P1PP1PPP/RNBQK2R w KQkq - 0 6", chessqdl::nWhite, 3,
+							   false, false, 0);
+	EXPECT_EQ(engine.getHash(), reference.getHash());
+
+	for (int i = 0; i < 4; i++)
+		engine.takeMove();
+
+	EXPECT_EQ(engine.getHash(), initialHash);
+}
+
+TEST(TranspositionTable, PrincipalVariation_Test) {
+	chessqdl::Engine engine("4k3/8/8/8/8/8/3q4/4K3 w - - 0 1", chessqdl::nWhite, 2, false, false, 0);
+
+	const std::string bestMove = engine.getBestMove(2, chessqdl::nWhite);
+	const auto pv = engine.getPrincipalVariation(2);
+
+	EXPECT_EQ(bestMove, "e1d2");
+	ASSERT_FALSE(pv.empty());
+	EXPECT_EQ(pv.front(), bestMove);
+}
@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+
+#include "Engine/psqt.hpp"
+#include "Engine/tuner.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+TEST(Tuner, ParseLabeledPosition_Test) {
+	std::string fen;
+	double result = -1;
+
+	ASSERT_TRUE(chessqdl::parseLabeledPosition("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1 [0.5]", fen, result));
+	EXPECT_EQ(fen, "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1");
+	EXPECT_DOUBLE_EQ(result, 0.5);
+
+	ASSERT_TRUE(chessqdl::parseLabeledPosition("4k3/8/8/8/8/8/4P3/4K3 w - - c9 \"1-0\";", fen, result));
+	EXPECT_EQ(fen, "4k3/8/8/8/8/8/4P3/4K3 w - -");
+	EXPECT_DOUBLE_EQ(result, 1.0);
+
+	ASSERT_TRUE(chessqdl::parseLabeledPosition("4k3/8/8/8/8/8/4p3/4K3 w - - 0-1", fen, result));
+	EXPECT_DOUBLE_EQ(result, 0.0);
+
+	ASSERT_TRUE(chessqdl::parseLabeledPosition("4k3/8/8/8/8/8/8/4K3 w - - 1/2-1/2", fen, result));
+	EXPECT_DOUBLE_EQ(result, 0.5);
+
+	// Missing result, out of range result and broken placements
+	EXPECT_FALSE(chessqdl::parseLabeledPosition("4k3/8/8/8/8/8/8/4K3", fen, result));
+	EXPECT_FALSE(chessqdl::parseLabeledPosition("4k3/8/8/8/8/8/8/4K3 w - - 2.0", fen, result));
+	EXPECT_FALSE(chessqdl::parseLabeledPosition("4k3/8/8/8/8/8/4K3 w - - 1-0", fen, result));
+	EXPECT_FALSE(chessqdl::parseLabeledPosition("4k3/8/8/8/8/8/8/4X3 w - - 1-0", fen, result));
+}
+
+TEST(Tuner, InitialTables_Test) {
+	const chessqdl::Tuner tuner(chessqdl::getDefaultPieceSquareTables());
+	const chessqdl::PieceSquareTables tables = tuner.getTables();
+
+	EXPECT_EQ(tables.mg, chessqdl::getDefaultPieceSquareTables().mg);
+	EXPECT_EQ(tables.eg, chessqdl::getDefaultPieceSquareTables().eg);
+}
+
+TEST(Tuner, Training_Test) {
+	// White wins every game in which its knight is centralized and loses the others, which the tables can learn
+	const std::string path = testing::TempDir() + "chessqdl_tuner_positions.txt";
+	{
+		std::ofstream file(path);
+		file << "4k3/4p3/8/8/4N3/8/4P3/4K3 w - - 1-0\n";
+		file << "4k3/4p3/8/3N4/8/8/4P3/4K3 w - - 1-0\n";
+		file << "4k3/4p3/8/8/8/8/4P3/N3K3 w - - 0-1\n";
+		file << "4k3/4p3/8/8/8/8/4P3/4K2N w - - 0-1\n";
+		file << "not a position\n";
+		// Drawn by insufficient material whatever the tables say
+		file << "4k3/8/8/8/3N4/8/8/4K3 w - - 1/2-1/2\n";
+	}
+
+	chessqdl::Tuner tuner(chessqdl::getDefaultPieceSquareTables());
+	ASSERT_EQ(tuner.load(path, 2), 4);
+	EXPECT_TRUE(tuner.addPosition("4k3/4p3/8/8/3N4/8/4P3/4K3 w - - 1-0"));
+	EXPECT_FALSE(tuner.addPosition("4k3/4p3/8/8/3N4/8/4P3/4K3 w - -"));
+	EXPECT_EQ(tuner.size(), 5);
+
+	const double k = tuner.findScalingConstant(2);
+	const double before = tuner.loss(k, 2);
+
+	for (int epoch = 0; epoch < 50; epoch++)
+		tuner.step(k, 2.0, 2);
+
+	EXPECT_LT(tuner.loss(k, 2), before);
+	// The loss does not depend on how the positions are split between threads
+	EXPECT_NEAR(tuner.loss(k, 1), tuner.loss(k, 3), 1e-12);
+
+	const chessqdl::PieceSquareTables tables = tuner.getTables();
+	EXPECT_GT(tables.mg[chessqdl::nKnight][chessqdl::e4], chessqdl::getDefaultPieceSquareTables().mg[chessqdl::nKnight][chessqdl::e4]);
+	EXPECT_LT(tables.mg[chessqdl::nKnight][chessqdl::a1], chessqdl::getDefaultPieceSquareTables().mg[chessqdl::nKnight][chessqdl::a1]);
+
+	std::remove(path.c_str());
+}
@@ -0,0 +1,133 @@
+#include "gtest/gtest.h"
+
+#include "Engine/engine.hpp"
+
+#include <chrono>
+#include <regex>
+#include <sstream>
+#include <string>
+
+namespace {
+
+	std::string runUci(chessqdl::Engine &engine, const std::string &commands) {
+		std::istringstream input(commands);
+		std::ostringstream output;
+		engine.uci(input, output);
+		return output.str();
+	}
+
+	/**
+	 * @brief Returns the move of the last bestmove line, or an empty string if there is none
+	 */
+	std::string lastBestMove(const std::string &output) {
+		const size_t position = output.rfind("bestmove ");
+
+		if (position == std::string::npos)
+			return "";
+
+		std::istringstream line(output.substr(position));
+		std::string keyword, mv;
+		line >> keyword >> mv;
+		return mv;
+	}
+
+}
+
+TEST(Uci, Handshake_Test) {
+	chessqdl::Engine engine(chessqdl::nBlack, 3, false, false, 42);
+	const std::string output = runUci(engine, "uci\nisready\n");
+
+	EXPECT_NE(output.find("id name ChessQDL\n"), std::string::npos);
+	EXPECT_NE(output.find("option name Hash type spin"), std::string::npos);
+	EXPECT_NE(output.find("uciok\n"), std::string::npos);
+	EXPECT_NE(output.find("readyok\n"), std::string::npos);
+	EXPECT_LT(output.find("uciok"), output.find("readyok"));
+}
+
+TEST(Uci, PositionAndDepth_Test) {
+	chessqdl::Engine engine(chessqdl::nBlack, 3, false, false, 42);
+	const std::string output = runUci(engine, "position startpos moves e2e4 e7e5\ngo depth 3\n");
+
+	EXPECT_EQ(engine.getToMove(), chessqdl::nWhite);
+
+	const std::regex info(R"(info depth 3 score cp -?\d+ nodes \d+ nps \d+ time \d+ hashfull \d+ pv( [a-h][1-8][a-h][1-8][nbrq]?)+)");
+	EXPECT_TRUE(std::regex_search(output, info)) << output;
+
+	// The best move is searched for white and the expected reply for black
+	const std::regex best(R"(bestmove [a-h][1-8][a-h][1-8]\w? ponder [a-h][1-8][a-h][1-8])");
+	EXPECT_TRUE(std::regex_search(output, best)) << output;
+}
+
+TEST(Uci, FenAndIllegalMove_Test) {
+	chessqdl::Engine engine(chessqdl::nBlack, 3, false, false, 42);
+	const std::string output = runUci(engine,
+	                                  "position fen 4k3/8/8/8/8/8/4P3/4K3 w - - 0 1 moves e2e4 e8d7 e4e6\n");
+
+	EXPECT_NE(output.find("info string Illegal move e4e6"), std::string::npos);
+	// Moves before the illegal one are played
+	EXPECT_EQ(engine.getToMove(), chessqdl::nWhite);
+	EXPECT_TRUE(engine.getBitboard().getPawns(chessqdl::nWhite).test(chessqdl::e4));
+}
+
+TEST(Uci, MatedPosition_Test) {
+	chessqdl::Engine engine(chessqdl::nBlack, 3, false, false, 42);
+	const std::string output = runUci(engine, "position startpos moves f2f3 e7e5 g2g4 d8h4\ngo depth 3\n");
+
+	EXPECT_EQ(lastBestMove(output), "0000") << output;
+	EXPECT_EQ(output.find(" ponder "), std::string::npos) << output;
+}
+
+TEST(Uci, NodeAndTimeLimits_Test) {
+	chessqdl::Engine engine(chessqdl::nBlack, 3, false, false, 42);
+
+	EXPECT_FALSE(lastBestMove(runUci(engine, "position startpos\ngo nodes 2000\n")).empty());
+
+	const auto begin = std::chrono::steady_clock::now();
+	const std::string output = runUci(engine, "position startpos\ngo movetime 200\n");
+	const auto elapsed = std::chrono::steady_clock::now() - begin;
+
+	EXPECT_FALSE(lastBestMove(output).empty());
+	EXPECT_LT(elapsed, std::chrono::seconds(2));
+
+	EXPECT_FALSE(lastBestMove(runUci(engine, "position startpos\ngo wtime 2000 btime 2000 winc 10 binc 10\n")).empty());
+}
+
+TEST(Uci, InfiniteAndStop_Test) {
+	chessqdl::Engine engine(chessqdl::nBlack, 3, false, false, 42);
+	const std::string output = runUci(engine, "position startpos moves e2e4\ngo infinite\nisready\nstop\nquit\n");
+
+	EXPECT_NE(output.find("readyok"), std::string::npos);
+	// Only one best move, sent once the search was stopped
+	EXPECT_EQ(output.find("bestmove"), output.rfind("bestmove"));
+	EXPECT_FALSE(lastBestMove(output).empty());
+}
+
+TEST(Uci, SetOption_Test) {
+	chessqdl::Engine engine(chessqdl::nBlack, 3, false, false, 42);
+	const std::string output = runUci(engine, "setoption name Hash value 4\nsetoption name Clear Hash\n"
+	                                          "setoption name Contempt value 10\n");
+
+	EXPECT_EQ(output, "info string Unknown option Contempt\n");
+}
+
+TEST(Uci, GoPerft_Test) {
+	chessqdl::Engine engine(chessqdl::nBlack, 3, false, false, 42);
+	const std::string output = runUci(engine, "position startpos\ngo perft 3\n");
+
+	EXPECT_NE(output.find("e2e4: 600\n"), std::string::npos);
+	EXPECT_NE(output.find("Nodes: 8902\n"), std::string::npos);
+}
+
+TEST(Uci, Bench_Test) {
+	chessqdl::Engine engine(chessqdl::nBlack, 3, false, false, 42);
+	const std::string output = runUci(engine, "bench 1\nbench 1 2 1\n");
+
+	// The same signature, whatever the number of threads
+	const size_t first = output.find("Nodes searched  : ");
+	ASSERT_NE(first, std::string::npos);
+	const size_t second = output.find("Nodes searched  : ", first + 1);
+	ASSERT_NE(second, std::string::npos);
+	EXPECT_EQ(output.substr(first, output.find('\n', first) - first),
+			  output.substr(second, output.find('\n', second) - second));
+	EXPECT_NE(output.find("Position 40/40: "), std::string::npos);
+}
@@ -0,0 +1,96 @@
+#include <cxxopts.hpp>
+#include <iostream>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * @brief Stand-in client of the analysis server (ChessQDL --serve). Sends the JSON requests read from stdin, one per
+ * line, and prints the results as they arrive until the server has answered all of them
+ */
+int main(const int argc, char **argv) {
+	cxxopts::Options options("client", "Sends analysis requests to ChessQDL --serve");
+
+	std::string socketPath;
+	int port = 0;
+
+	options.add_options()
+			("s,socket", "Unix domain socket the server listens on", cxxopts::value(socketPath))
+			("p,port", "Localhost TCP port the server listens on", cxxopts::value(port))
+			("h,help", "Display this help and exit");
+
+	try {
+		const auto args = options.parse(argc, argv);
+
+		if (args.count("help") || (socketPath.empty() && port == 0)) {
+			std::cout << options.help();
+			return args.count("help") ? 0 : 1;
+		}
+	} catch (cxxopts::OptionException &e) {
+		std::cout << "client: " << e.what() << std::endl;
+		return 1;
+	}
+
+	int fd;
+	int connected;
+
+	if (!socketPath.empty()) {
+		sockaddr_un address{};
+		address.sun_family = AF_UNIX;
+
+		if (socketPath.size() >= sizeof(address.sun_path)) {
+			std::cout << "client: Socket path too long" << std::endl;
+			return 1;
+		}
+
+		socketPath.copy(address.sun_path, socketPath.size());
+		fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		connected = ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+	} else {
+		sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port = htons(static_cast<uint16_t>(port));
+		fd = ::socket(AF_INET, SOCK_STREAM, 0);
+		connected = ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+	}
+
+	if (fd < 0 || connected != 0) {
+		std::cout << "client: Could not connect to the server" << std::endl;
+		return 1;
+	}
+
+	// Requests are sent while the results are read, since the server stops reading while its queue is full
+	std::thread sender([fd] {
+		std::string line;
+
+		while (std::getline(std::cin, line)) {
+			line += '\n';
+
+			for (size_t sent = 0; sent < line.size();) {
+				const ssize_t n = ::send(fd, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+
+				if (n <= 0)
+					return;
+
+				sent += static_cast<size_t>(n);
+			}
+		}
+
+		::shutdown(fd, SHUT_WR);
+	});
+
+	char chunk[4096];
+
+	for (ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0); n > 0; n = ::recv(fd, chunk, sizeof(chunk), 0))
+		std::cout.write(chunk, n).flush();
+
+	sender.join();
+	::close(fd);
+
+	return 0;
+}
@@ -0,0 +1,75 @@
+#include "Engine/bitboard.hpp"
+#include "Engine/perft.hpp"
+
+#include <cxxopts.hpp>
+#include <iostream>
+
+using namespace chessqdl;
+
+/**
+ * @brief Counts the leaves of the move tree of a position, move by move, to validate the move generator and measure
+ * its speed. With --check, runs the reference positions instead and compares the counts with the published ones
+ */
+int main(const int argc, char **argv) {
+	cxxopts::Options options("perft", "Counts the leaves of the move tree of a position");
+
+	std::string fen = startFen;
+	int depth = 5;
+	unsigned threads = 0;
+	size_t hash = 64;
+
+	options.add_options()
+			("f,fen", "Position to count from. Defaults to the initial position", cxxopts::value(fen))
+			("d,depth", "Depth of the tree", cxxopts::value(depth))
+			("t,threads", "Number of threads. Defaults to one per hardware thread", cxxopts::value(threads))
+			("H,hash", "Size of the table shared by the threads, in megabytes. 0 disables it", cxxopts::value(hash))
+			("c,check", "Run the reference positions and compare with the known counts")
+			("h,help", "Display this help and exit");
+
+	bool check = false;
+
+	try {
+		const auto args = options.parse(argc, argv);
+
+		if (args.count("help")) {
+			std::cout << options.help();
+			return 0;
+		}
+
+		check = args.count("check") > 0;
+	} catch (cxxopts::OptionException &e) {
+		std::cout << "perft: " << e.what() << std::endl;
+		return 1;
+	}
+
+	if (check) {
+		bool passed = true;
+
+		for (const auto &reference: perftReferences) {
+			const Bitboard board(reference.fen);
+			const enumColor toMove = reference.fen.substr(reference.fen.find(' ') + 1, 1) == "w" ? nWhite : nBlack;
+			const int referenceDepth = static_cast<int>(reference.counts.size());
+			const PerftResult result = perftDivide(board.getBitBoards(), toMove, referenceDepth, threads, hash);
+			const bool match = result.nodes == reference.counts.back();
+
+			std::cout << (match ? "ok      " : "FAILED  ") << reference.fen << "  depth " << referenceDepth << ": "
+					<< result.nodes << " (expected " << reference.counts.back() << ")" << std::endl;
+
+			passed &= match;
+		}
+
+		return passed ? 0 : 1;
+	}
+
+	if (depth < 1) {
+		std::cout << "perft: The depth must be at least 1" << std::endl;
+		return 1;
+	}
+
+	const Bitboard board(fen);
+	const enumColor toMove = fen.substr(fen.find(' ') + 1, 1) == "w" ? nWhite : nBlack;
+
+	printPerft(std::cout, perftDivide(board.getBitBoards(), toMove, depth, threads, hash));
+
+	return 0;
+}
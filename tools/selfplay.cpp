@@ -0,0 +1,201 @@
+#include "Engine/analysis.hpp"
+#include "Engine/bitbase.hpp"
+#include "Engine/match.hpp"
+#include "Engine/nnue.hpp"
+
+#include <cmath>
+#include <cxxopts.hpp>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace chessqdl;
+
+namespace {
+
+	/**
+	 * @brief Reads a time control written as "seconds" or "seconds+increment"
+	 */
+	bool parseTimeControl(const std::string &tc, PlayerConfig &player) {
+		try {
+			const size_t plus = tc.find('+');
+			player.time = std::llround(std::stod(tc.substr(0, plus)) * 1000);
+			player.increment = plus == std::string::npos ? 0 : std::llround(std::stod(tc.substr(plus + 1)) * 1000);
+		} catch (std::exception &) {
+			return false;
+		}
+
+		return player.time > 0 && player.increment >= 0;
+	}
+
+	bool loadNetwork(const std::string &path, PlayerConfig &player) {
+		if (path.empty())
+			return true;
+
+		auto network = std::make_shared<NnueNetwork>();
+
+		if (!network->load(path))
+			return false;
+
+		player.network = network;
+
+		return true;
+	}
+
+	bool loadWeights(const std::string &path, PlayerConfig &player) {
+		if (path.empty())
+			return true;
+
+		auto tables = std::make_shared<PieceSquareTables>(getDefaultPieceSquareTables());
+
+		if (!loadPieceSquareTables(path, *tables))
+			return false;
+
+		player.pieceSquareTables = tables;
+
+		return true;
+	}
+
+}
+
+/**
+ * @brief Plays a match between two configurations of ChessQDL, several games at a time, and reports the Elo
+ * difference of the first one. With --sprt, stops as soon as a sequential probability ratio test decides between elo0
+ * and elo1
+ */
+int main(const int argc, char **argv) {
+	cxxopts::Options options("selfplay", "Plays a match between two configurations of ChessQDL");
+
+	PlayerConfig first;
+	PlayerConfig second;
+	MatchOptions match;
+	std::string openingsFile, pgnFile, tc, firstNetwork, secondNetwork, firstWeights, secondWeights;
+	first.name = "ChessQDL 1";
+	second.name = "ChessQDL 2";
+
+	options.add_options()
+			("g,games", "Maximum number of games", cxxopts::value(match.games))
+			("t,threads", "Number of games played at the same time", cxxopts::value(match.threads))
+			("o,openings", "FEN or EPD file of starting positions, each played with both colors",
+			 cxxopts::value(openingsFile))
+			("p,pgn", "File the games are written to", cxxopts::value(pgnFile))
+			("tc", "Time control of both players, in seconds (e.g. 10+0.1)", cxxopts::value(tc))
+			("depth1", "Maximum depth of the first player", cxxopts::value(first.depth))
+			("depth2", "Maximum depth of the second player", cxxopts::value(second.depth))
+			("nodes1", "Maximum number of nodes of the first player", cxxopts::value(first.nodes))
+			("nodes2", "Maximum number of nodes of the second player", cxxopts::value(second.nodes))
+			("movetime1", "Time per move of the first player, in milliseconds", cxxopts::value(first.moveTime))
+			("movetime2", "Time per move of the second player, in milliseconds", cxxopts::value(second.moveTime))
+			("network1", "NNUE network of the first player", cxxopts::value(firstNetwork))
+			("network2", "NNUE network of the second player", cxxopts::value(secondNetwork))
+			("weights1", "Piece-square tables of the first player", cxxopts::value(firstWeights))
+			("weights2", "Piece-square tables of the second player", cxxopts::value(secondWeights))
+			("hash", "Size of the transposition table of each engine in megabytes", cxxopts::value(first.hashSize))
+			("sprt", "Stop as soon as the SPRT accepts one of the hypotheses")
+			("elo0", "Elo difference under the null hypothesis", cxxopts::value(match.elo0))
+			("elo1", "Elo difference under the alternative hypothesis", cxxopts::value(match.elo1))
+			("alpha", "Probability of accepting elo1 when elo0 holds", cxxopts::value(match.alpha))
+			("beta", "Probability of accepting elo0 when elo1 holds", cxxopts::value(match.beta))
+			("resign-score", "Score in centipawns from which games are adjudicated as won",
+			 cxxopts::value(match.adjudication.resignScore))
+			("draw-score", "Score in centipawns below which games are adjudicated as drawn",
+			 cxxopts::value(match.adjudication.drawScore))
+			("max-plies", "Number of plies after which games are drawn", cxxopts::value(match.adjudication.maxPlies))
+			("h,help", "Display this help and exit");
+
+	try {
+		const auto args = options.parse(argc, argv);
+
+		if (args.count("help")) {
+			std::cout << options.help();
+			return 0;
+		}
+
+		match.sprt = args.count("sprt") > 0;
+	} catch (cxxopts::OptionException &e) {
+		std::cout << "selfplay: " << e.what() << std::endl;
+		return 1;
+	}
+
+	second.hashSize = first.hashSize;
+
+	if (!tc.empty() && (!parseTimeControl(tc, first) || !parseTimeControl(tc, second))) {
+		std::cout << "selfplay: Invalid time control " << tc << std::endl;
+		return 1;
+	}
+
+	for (PlayerConfig *player: {&first, &second}) {
+		if (player->time == 0 && player->depth == 0 && player->nodes == 0 && player->moveTime == 0)
+			player->moveTime = 100;
+	}
+
+	if (!loadNetwork(firstNetwork, first) || !loadNetwork(secondNetwork, second)) {
+		std::cout << "selfplay: Could not load the network" << std::endl;
+		return 1;
+	}
+
+	if (!loadWeights(firstWeights, first) || !loadWeights(secondWeights, second)) {
+		std::cout << "selfplay: Could not read the weights file" << std::endl;
+		return 1;
+	}
+
+	if (!openingsFile.empty()) {
+		std::ifstream file(openingsFile);
+
+		if (!file) {
+			std::cout << "selfplay: Could not read " << openingsFile << std::endl;
+			return 1;
+		}
+
+		std::string line, fen, id;
+
+		while (std::getline(file, line)) {
+			if (parsePosition(line, fen, id))
+				match.openings.push_back(fen);
+		}
+
+		if (match.openings.empty()) {
+			std::cout << "selfplay: No valid position in " << openingsFile << std::endl;
+			return 1;
+		}
+	}
+
+	std::ofstream pgn;
+
+	if (!pgnFile.empty()) {
+		pgn.open(pgnFile);
+
+		if (!pgn) {
+			std::cout << "selfplay: Could not write " << pgnFile << std::endl;
+			return 1;
+		}
+	}
+
+	const double lower = std::log(match.beta / (1 - match.alpha));
+	const double upper = std::log((1 - match.beta) / match.alpha);
+
+	initBitbases();
+
+	const MatchStats stats = playMatch(first, second, match, pgnFile.empty() ? nullptr : &pgn,
+									   [&match, lower, upper](const MatchStats &current) {
+		std::cout << std::fixed << std::setprecision(1) << "Games " << current.games() << ": +" << current.wins
+				  << " -" << current.losses << " =" << current.draws << ", Elo " << current.elo() << " +/- "
+				  << current.eloMargin();
+
+		if (match.sprt)
+			std::cout << std::setprecision(2) << ", LLR " << current.llr(match.elo0, match.elo1) << " (" << lower
+					  << ", " << upper << ")";
+
+		std::cout << std::endl;
+	});
+
+	if (match.sprt) {
+		const enumSprtVerdict verdict = sprtVerdict(stats.llr(match.elo0, match.elo1), match.alpha, match.beta);
+
+		std::cout << "SPRT: " << (verdict == nAcceptH1 ? "H1 accepted" : verdict == nAcceptH0 ? "H0 accepted"
+																							 : "inconclusive")
+				  << std::endl;
+	}
+
+	return 0;
+}
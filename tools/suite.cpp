@@ -0,0 +1,123 @@
+#include "Engine/bitbase.hpp"
+#include "Engine/nnue.hpp"
+#include "Engine/psqt.hpp"
+#include "Engine/suite.hpp"
+
+#include <cxxopts.hpp>
+#include <fstream>
+#include <iostream>
+
+using namespace chessqdl;
+
+/**
+ * @brief Runs a test suite of EPD positions with "bm" or "am" operations and reports how many positions were solved,
+ * and how long it took to find the solutions
+ */
+int main(const int argc, char **argv) {
+	cxxopts::Options options("suite", "Runs a test suite of EPD positions against ChessQDL");
+
+	std::string input, weights, evalFile;
+	AnalysisOptions analysis;
+	analysis.threads = 1;
+
+	options.add_options()
+			("i,input", "EPD file with one position per line, each with a bm or am operation", cxxopts::value(input))
+			("m,movetime", "Time spent on each position, in milliseconds", cxxopts::value(analysis.limits.moveTime))
+			("n,nodes", "Maximum number of nodes searched for each position", cxxopts::value(analysis.limits.nodes))
+			("d,depth", "Maximum depth searched for each position", cxxopts::value(analysis.limits.depth))
+			("t,threads", "Number of positions searched at the same time", cxxopts::value(analysis.threads))
+			("hash", "Size of the transposition table of each engine in megabytes", cxxopts::value(analysis.hashSize))
+			("weights", "Piece-square tables file. Defaults to the built-in tables", cxxopts::value(weights))
+			("eval-file", "NNUE network file. Defaults to the handcrafted evaluation", cxxopts::value(evalFile))
+			("q,quiet", "Only print the summary")
+			("h,help", "Display this help and exit");
+
+	bool quiet = false;
+
+	try {
+		const auto args = options.parse(argc, argv);
+
+		if (args.count("help") || !args.count("input")) {
+			std::cout << options.help();
+			return args.count("help") ? 0 : 1;
+		}
+
+		quiet = args.count("quiet") > 0;
+	} catch (cxxopts::OptionException &e) {
+		std::cout << "suite: " << e.what() << std::endl;
+		return 1;
+	}
+
+	if (analysis.limits.moveTime == 0 && analysis.limits.nodes == 0 && analysis.limits.depth == 0)
+		analysis.limits.moveTime = 1000;
+
+	if (!weights.empty()) {
+		auto tables = std::make_shared<PieceSquareTables>(getDefaultPieceSquareTables());
+
+		if (!loadPieceSquareTables(weights, *tables)) {
+			std::cout << "suite: Could not read weights file " << weights << std::endl;
+			return 1;
+		}
+
+		analysis.pieceSquareTables = tables;
+	}
+
+	if (!evalFile.empty()) {
+		auto network = std::make_shared<NnueNetwork>();
+
+		if (!network->load(evalFile)) {
+			std::cout << "suite: Could not read network file " << evalFile << std::endl;
+			return 1;
+		}
+
+		analysis.network = network;
+	}
+
+	std::ifstream file(input);
+
+	if (!file) {
+		std::cout << "suite: Could not read " << input << std::endl;
+		return 1;
+	}
+
+	std::vector<SuitePosition> positions;
+	std::string line;
+	int number = 0;
+
+	while (std::getline(file, line)) {
+		number++;
+
+		if (line.find_first_not_of(" \t\r") == std::string::npos || line[0] == '#')
+			continue;
+
+		SuitePosition position;
+
+		if (!parseSuitePosition(line, position)) {
+			std::cout << "suite: Skipping line " << number << ", which is not a valid test position" << std::endl;
+			continue;
+		}
+
+		if (position.id.empty())
+			position.id = "line " + std::to_string(number);
+
+		positions.push_back(position);
+	}
+
+	initBitbases();
+
+	const auto results = runSuite(positions, analysis, [quiet](size_t, const SuiteResult &result) {
+		if (quiet)
+			return;
+
+		std::cout << result.id << ": " << (result.solved ? "solved" : "failed") << " with " << result.move;
+
+		if (result.solved)
+			std::cout << " at depth " << result.depth << ", " << result.nodes << " nodes, " << result.time << " ms";
+
+		std::cout << std::endl;
+	});
+
+	printSuiteSummary(std::cout, results);
+
+	return 0;
+}
@@ -0,0 +1,98 @@
+#include "Engine/psqt.hpp"
+#include "Engine/tuner.hpp"
+
+#include <chrono>
+#include <cxxopts.hpp>
+#include <fstream>
+#include <iostream>
+
+using namespace chessqdl;
+
+/**
+ * @brief Texel tuner for the piece-square tables. Reads a file of labeled positions (one FEN and game result per line),
+ * fits the tables and writes them in the weights file format accepted by `ChessQDL --weights`
+ */
+int main(const int argc, char **argv) {
+	cxxopts::Options options("tune", "Fits the evaluation weights of ChessQDL to a set of labeled positions");
+
+	std::string input;
+	std::string output = "weights.txt";
+	std::string weights;
+	int epochs = 200;
+	double learningRate = 1.0;
+	double k = 0;
+	unsigned threads = 0;
+
+	options.add_options()
+			("i,input", "File with one position per line: a FEN followed by the game result (1-0, 0-1, 1/2-1/2 or a number between 0 and 1)", cxxopts::value(input))
+			("o,output", "Weights file to write", cxxopts::value(output))
+			("w,weights", "Weights file to start from. Defaults to the built-in tables", cxxopts::value(weights))
+			("e,epochs", "Number of epochs", cxxopts::value(epochs))
+			("r,rate", "Learning rate, in centipawns", cxxopts::value(learningRate))
+			("k", "Scaling constant of the sigmoid. Fitted to the data when not given", cxxopts::value(k))
+			("t,threads", "Number of threads. Defaults to one per hardware thread", cxxopts::value(threads))
+			("h,help", "Display this help and exit");
+
+	try {
+		const auto args = options.parse(argc, argv);
+
+		if (args.count("help") || !args.count("input")) {
+			std::cout << options.help();
+			return args.count("help") ? 0 : 1;
+		}
+	} catch (cxxopts::OptionException &e) {
+		std::cout << "tune: " << e.what() << std::endl;
+		return 1;
+	}
+
+	PieceSquareTables tables = getDefaultPieceSquareTables();
+
+	if (!weights.empty() && !loadPieceSquareTables(weights, tables)) {
+		std::cout << "tune: Could not read weights file " << weights << std::endl;
+		return 1;
+	}
+
+	Tuner tuner(tables);
+
+	auto begin = std::chrono::steady_clock::now();
+	const long long loaded = tuner.load(input, threads);
+
+	if (loaded < 0) {
+		std::cout << "tune: Could not read " << input << std::endl;
+		return 1;
+	}
+
+	std::cout << "Loaded " << loaded << " positions in " << std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - begin).count() << " ms" << std::endl;
+
+	if (k <= 0) {
+		k = tuner.findScalingConstant(threads);
+		std::cout << "Scaling constant: " << k << std::endl;
+	}
+
+	std::cout << "Initial loss: " << tuner.loss(k, threads) << std::endl;
+
+	begin = std::chrono::steady_clock::now();
+
+	for (int epoch = 1; epoch <= epochs; epoch++) {
+		tuner.step(k, learningRate, threads);
+
+		if (epoch % 10 == 0 || epoch == epochs)
+			std::cout << "Epoch " << epoch << ": loss " << tuner.loss(k, threads) << std::endl;
+	}
+
+	std::cout << "Trained in " << std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - begin).count() << " ms" << std::endl;
+
+	std::ofstream file(output);
+	writePieceSquareTables(file, tuner.getTables());
+
+	if (!file) {
+		std::cout << "tune: Could not write " << output << std::endl;
+		return 1;
+	}
+
+	std::cout << "Weights written to " << output << std::endl;
+
+	return 0;
+}